@@ -123,19 +123,9 @@ void CnmrServer::OnInterest (Ptr<const Interest> interest)
     {
         // NS_LOG_DEBUG("Served interest but it's not monitored. Forwarding...");
 
-        Ptr<Name> nameWithSequence = Create<Name> (interest->GetName ());
-
-        Ptr<Interest> newInterest = Create<Interest> ();
-        newInterest->SetNonce (interest->GetNonce ());
-        newInterest->SetName (interest->GetName ());
-        newInterest->SetInterestLifetime (interest->GetInterestLifetime ());
-
-        if(didServe)
-        {
-            newInterest->SetServed(1);
-        }
-
-        newInterest->GetPayload()->AddPacketTag(hopCountTag);
+        // The forwarded interest shares name and payload (with the hop count tag) with this interest
+        Ptr<Interest> newInterest = interest->Derive();
+        newInterest->SetServed(didServe ? 1 : 0);
 
         m_face->ReceiveInterest (newInterest);
     }
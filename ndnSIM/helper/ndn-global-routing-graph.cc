@@ -0,0 +1,612 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+
+#include "ndn-global-routing-graph.h"
+
+#include "../model/ndn-global-router.h"
+#include "ns3/ndn-face.h"
+#include "ns3/ndn-limits.h"
+
+#include "ns3/node-list.h"
+#include "ns3/channel-list.h"
+#include "ns3/assert.h"
+
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <functional>
+
+namespace ns3 {
+namespace ndn {
+
+const uint32_t GlobalRoutingGraph::INVALID;
+
+GlobalRoutingGraph::GlobalRoutingGraph ()
+  : m_nodes (0)
+{
+  Update ();
+}
+
+void
+GlobalRoutingGraph::Update ()
+{
+  m_routers.clear ();
+  m_idToVertex.clear ();
+  m_offsets.clear ();
+  m_targets.clear ();
+  m_metrics.clear ();
+  m_delays.clear ();
+  m_faces.clear ();
+  m_sources.clear ();
+  m_inOffsets.clear ();
+  m_inEdges.clear ();
+
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      Ptr<GlobalRouter> gr = (*node)->GetObject<GlobalRouter> ();
+      if (gr != 0)
+        m_routers.push_back (gr);
+    }
+  m_nodes = m_routers.size ();
+
+  for (ChannelList::Iterator channel = ChannelList::Begin (); channel != ChannelList::End (); channel++)
+    {
+      Ptr<GlobalRouter> gr = (*channel)->GetObject<GlobalRouter> ();
+      if (gr != 0)
+        m_routers.push_back (gr);
+    }
+
+  for (uint32_t vertex = 0; vertex < m_routers.size (); vertex++)
+    {
+      uint32_t id = m_routers[vertex]->GetId ();
+      if (id >= m_idToVertex.size ())
+        m_idToVertex.resize (id + 1, INVALID);
+      m_idToVertex[id] = vertex;
+    }
+
+  m_offsets.reserve (m_routers.size () + 1);
+  for (uint32_t vertex = 0; vertex < m_routers.size (); vertex++)
+    {
+      m_offsets.push_back (m_targets.size ());
+
+      BOOST_FOREACH (const GlobalRouter::Incidency &edge, m_routers[vertex]->GetIncidencies ())
+        {
+          uint32_t target = GetVertex (edge.get<2> ());
+          if (target == INVALID)
+            continue;
+
+          Ptr<Face> face = edge.get<1> ();
+          double delay = 0.0;
+          if (face != 0)
+            {
+              Ptr<Limits> limits = face->GetObject<Limits> ();
+              if (limits != 0) // valid limits object
+                {
+                  delay = limits->GetLinkDelay ();
+                }
+            }
+
+          m_sources.push_back (vertex);
+          m_targets.push_back (target);
+          m_metrics.push_back (GetFaceMetric (face));
+          m_delays.push_back (delay);
+          m_faces.push_back (face);
+        }
+    }
+  m_offsets.push_back (m_targets.size ());
+
+  // in-edges, grouped by target vertex (counting sort)
+  m_inOffsets.assign (m_routers.size () + 1, 0);
+  for (uint32_t edge = 0; edge < m_targets.size (); edge++)
+    {
+      m_inOffsets[m_targets[edge] + 1] ++;
+    }
+  for (uint32_t vertex = 0; vertex < m_routers.size (); vertex++)
+    {
+      m_inOffsets[vertex + 1] += m_inOffsets[vertex];
+    }
+
+  m_inEdges.resize (m_targets.size ());
+  std::vector<uint32_t> position (m_inOffsets.begin (), m_inOffsets.end () - 1);
+  for (uint32_t edge = 0; edge < m_targets.size (); edge++)
+    {
+      m_inEdges[position[m_targets[edge]]++] = edge;
+    }
+}
+
+void
+GlobalRoutingGraph::UpdateMetrics (std::vector<uint32_t> &changedEdges, std::vector<uint32_t> &oldMetrics)
+{
+  for (uint32_t edge = 0; edge < m_faces.size (); edge++)
+    {
+      uint32_t metric = GetFaceMetric (m_faces[edge]);
+      if (metric != m_metrics[edge])
+        {
+          changedEdges.push_back (edge);
+          oldMetrics.push_back (m_metrics[edge]);
+          m_metrics[edge] = metric;
+        }
+    }
+}
+
+uint32_t
+GlobalRoutingGraph::GetFaceMetric (Ptr<Face> face)
+{
+  if (face == 0)
+    return 0; // edges from channels
+  if (!face->IsUp ())
+    return INVALID;
+  return face->GetMetric ();
+}
+
+uint32_t
+GlobalRoutingGraph::GetVertex (Ptr<const GlobalRouter> router) const
+{
+  uint32_t id = router->GetId ();
+  if (id >= m_idToVertex.size ())
+    return INVALID;
+  return m_idToVertex[id];
+}
+
+void
+GlobalRoutingShortestPaths::Calculate (const GlobalRoutingGraph &graph, uint32_t source, uint32_t onlyEdge/* = INVALID*/)
+{
+  NS_ASSERT (source < graph.GetNVertices ());
+
+  uint32_t n = graph.GetNVertices ();
+  m_cost.assign (n, GlobalRoutingGraph::INVALID);
+  m_delay.assign (n, 0.0);
+  m_firstEdge.assign (n, GlobalRoutingGraph::INVALID);
+  m_heap.clear ();
+
+  typedef std::pair<uint32_t, uint32_t> HeapItem;
+  std::greater<HeapItem> heapCompare; // min-heap
+
+  m_cost[source] = 0;
+  m_heap.push_back (HeapItem (0, source));
+
+  while (!m_heap.empty ())
+    {
+      std::pop_heap (m_heap.begin (), m_heap.end (), heapCompare);
+      HeapItem item = m_heap.back ();
+      m_heap.pop_back ();
+
+      uint32_t vertex = item.second;
+      if (item.first != m_cost[vertex])
+        continue; // stale heap item, vertex has already been settled with a smaller cost
+
+      for (uint32_t edge = graph.EdgesBegin (vertex); edge != graph.EdgesEnd (vertex); edge++)
+        {
+          if (!graph.IsEdgeUp (edge))
+            continue;
+
+          uint32_t target = graph.GetEdgeTarget (edge);
+          uint32_t metric = graph.GetEdgeMetric (edge);
+          if (vertex == source && onlyEdge != GlobalRoutingGraph::INVALID && edge != onlyEdge)
+            metric = std::numeric_limits<uint16_t>::max () - 1;
+
+          uint32_t cost = m_cost[vertex] + metric;
+          if (cost >= m_cost[target])
+            continue;
+
+          m_cost[target] = cost;
+          m_delay[target] = m_delay[vertex] + graph.GetEdgeDelay (edge);
+          m_firstEdge[target] = (vertex == source) ? edge : m_firstEdge[vertex];
+
+          m_heap.push_back (HeapItem (cost, target));
+          std::push_heap (m_heap.begin (), m_heap.end (), heapCompare);
+        }
+    }
+
+  m_firstEdge[source] = GlobalRoutingGraph::INVALID;
+}
+
+void
+GlobalRoutingAlternativePaths::Calculate (const GlobalRoutingGraph &graph, uint32_t destination)
+{
+  NS_ASSERT (destination < graph.GetNVertices ());
+
+  m_alternatives.clear ();
+  BuildTree (graph, destination);
+
+  for (uint32_t source = 0; source < graph.GetNNodes (); source++)
+    {
+      if (source == destination || m_cost[source] == GlobalRoutingGraph::INVALID)
+        continue;
+
+      CalculateAvoiding (graph, source);
+    }
+}
+
+void
+GlobalRoutingAlternativePaths::BuildTree (const GlobalRoutingGraph &graph, uint32_t destination)
+{
+  typedef std::pair<uint32_t, uint32_t> HeapItem;
+  std::greater<HeapItem> heapCompare; // min-heap
+
+  uint32_t n = graph.GetNVertices ();
+  m_cost.assign (n, GlobalRoutingGraph::INVALID);
+  m_delay.assign (n, 0.0);
+  m_parent.assign (n, GlobalRoutingGraph::INVALID);
+  m_heap.clear ();
+
+  // Dijkstra on reversed edges: m_cost[v] is the cost of the shortest path from v to the destination
+  m_cost[destination] = 0;
+  m_heap.push_back (HeapItem (0, destination));
+  while (!m_heap.empty ())
+    {
+      std::pop_heap (m_heap.begin (), m_heap.end (), heapCompare);
+      HeapItem item = m_heap.back ();
+      m_heap.pop_back ();
+
+      uint32_t vertex = item.second;
+      if (item.first != m_cost[vertex])
+        continue;
+
+      for (uint32_t i = graph.InEdgesBegin (vertex); i != graph.InEdgesEnd (vertex); i++)
+        {
+          uint32_t edge = graph.GetInEdge (i);
+          if (!graph.IsEdgeUp (edge))
+            continue;
+
+          uint32_t from = graph.GetEdgeSource (edge);
+          uint32_t cost = m_cost[vertex] + graph.GetEdgeMetric (edge);
+          if (cost >= m_cost[from])
+            continue;
+
+          m_cost[from] = cost;
+          m_delay[from] = m_delay[vertex] + graph.GetEdgeDelay (edge);
+          m_parent[from] = vertex;
+
+          m_heap.push_back (HeapItem (cost, from));
+          std::push_heap (m_heap.begin (), m_heap.end (), heapCompare);
+        }
+    }
+
+  // children lists of the tree
+  m_childOffsets.assign (n + 1, 0);
+  for (uint32_t vertex = 0; vertex < n; vertex++)
+    {
+      if (m_parent[vertex] != GlobalRoutingGraph::INVALID)
+        m_childOffsets[m_parent[vertex] + 1] ++;
+    }
+  for (uint32_t vertex = 0; vertex < n; vertex++)
+    {
+      m_childOffsets[vertex + 1] += m_childOffsets[vertex];
+    }
+  m_children.resize (m_childOffsets[n]);
+  m_leave.assign (m_childOffsets.begin (), m_childOffsets.end () - 1); // used as insert positions
+  for (uint32_t vertex = 0; vertex < n; vertex++)
+    {
+      if (m_parent[vertex] != GlobalRoutingGraph::INVALID)
+        m_children[m_leave[m_parent[vertex]]++] = vertex;
+    }
+
+  // preorder numbering, the subtree of v occupies positions [m_enter[v], m_leave[v])
+  m_enter.assign (n, GlobalRoutingGraph::INVALID);
+  m_leave.assign (n, GlobalRoutingGraph::INVALID);
+  m_preorder.clear ();
+
+  m_stack.clear ();
+  m_stack.push_back (destination);
+  while (!m_stack.empty ())
+    {
+      uint32_t vertex = m_stack.back ();
+      if (m_enter[vertex] == GlobalRoutingGraph::INVALID)
+        {
+          m_enter[vertex] = m_preorder.size ();
+          m_preorder.push_back (vertex);
+          for (uint32_t i = m_childOffsets[vertex]; i != m_childOffsets[vertex + 1]; i++)
+            {
+              m_stack.push_back (m_children[i]);
+            }
+        }
+      else
+        {
+          m_leave[vertex] = m_preorder.size ();
+          m_stack.pop_back ();
+        }
+    }
+
+  m_avoidingCost.assign (n, GlobalRoutingGraph::INVALID);
+  m_avoidingDelay.assign (n, 0.0);
+}
+
+uint64_t
+GlobalRoutingAlternativePaths::GetRemainingCost (uint32_t vertex, uint32_t source) const
+{
+  uint32_t cost = m_cost[vertex];
+  if (vertex == source)
+    cost = GlobalRoutingGraph::INVALID;
+  else if (IsInSubtree (vertex, source))
+    cost = m_avoidingCost[vertex];
+
+  if (cost == GlobalRoutingGraph::INVALID)
+    return std::numeric_limits<uint64_t>::max ();
+  return cost;
+}
+
+void
+GlobalRoutingAlternativePaths::CalculateAvoiding (const GlobalRoutingGraph &graph, uint32_t source)
+{
+  typedef std::pair<uint32_t, uint32_t> HeapItem;
+  std::greater<HeapItem> heapCompare; // min-heap
+
+  // Vertices outside the subtree of the source reach the destination without the source.
+  // For vertices inside, shortest paths avoiding the source either leave the subtree directly
+  // or through other vertices of the subtree
+  m_heap.clear ();
+  for (uint32_t position = m_enter[source] + 1; position < m_leave[source]; position++)
+    {
+      uint32_t vertex = m_preorder[position];
+      m_avoidingCost[vertex] = GlobalRoutingGraph::INVALID;
+
+      for (uint32_t edge = graph.EdgesBegin (vertex); edge != graph.EdgesEnd (vertex); edge++)
+        {
+          uint32_t to = graph.GetEdgeTarget (edge);
+          if (!graph.IsEdgeUp (edge) ||
+              to == source || IsInSubtree (to, source) || m_cost[to] == GlobalRoutingGraph::INVALID)
+            continue;
+
+          uint32_t cost = m_cost[to] + graph.GetEdgeMetric (edge);
+          if (cost < m_avoidingCost[vertex])
+            {
+              m_avoidingCost[vertex] = cost;
+              m_avoidingDelay[vertex] = m_delay[to] + graph.GetEdgeDelay (edge);
+            }
+        }
+
+      if (m_avoidingCost[vertex] != GlobalRoutingGraph::INVALID)
+        m_heap.push_back (HeapItem (m_avoidingCost[vertex], vertex));
+    }
+  std::make_heap (m_heap.begin (), m_heap.end (), heapCompare);
+
+  while (!m_heap.empty ())
+    {
+      std::pop_heap (m_heap.begin (), m_heap.end (), heapCompare);
+      HeapItem item = m_heap.back ();
+      m_heap.pop_back ();
+
+      uint32_t vertex = item.second;
+      if (item.first != m_avoidingCost[vertex])
+        continue;
+
+      for (uint32_t i = graph.InEdgesBegin (vertex); i != graph.InEdgesEnd (vertex); i++)
+        {
+          uint32_t edge = graph.GetInEdge (i);
+          uint32_t from = graph.GetEdgeSource (edge);
+          if (!graph.IsEdgeUp (edge) || !IsInSubtree (from, source))
+            continue;
+
+          uint32_t cost = m_avoidingCost[vertex] + graph.GetEdgeMetric (edge);
+          if (cost >= m_avoidingCost[from])
+            continue;
+
+          m_avoidingCost[from] = cost;
+          m_avoidingDelay[from] = m_avoidingDelay[vertex] + graph.GetEdgeDelay (edge);
+
+          m_heap.push_back (HeapItem (cost, from));
+          std::push_heap (m_heap.begin (), m_heap.end (), heapCompare);
+        }
+    }
+
+  // Cost through every out-edge of the source
+  const uint64_t disabledMetric = std::numeric_limits<uint16_t>::max () - 1;
+  const uint64_t unreachable = std::numeric_limits<uint64_t>::max ();
+
+  uint64_t best = unreachable;
+  uint64_t secondBest = unreachable;
+  uint32_t bestEdge = GlobalRoutingGraph::INVALID;
+  for (uint32_t edge = graph.EdgesBegin (source); edge != graph.EdgesEnd (source); edge++)
+    {
+      if (!graph.IsEdgeUp (edge))
+        continue;
+
+      uint64_t remaining = GetRemainingCost (graph.GetEdgeTarget (edge), source);
+      if (remaining < best)
+        {
+          secondBest = best;
+          best = remaining;
+          bestEdge = edge;
+        }
+      else if (remaining < secondBest)
+        {
+          secondBest = remaining;
+        }
+    }
+
+  for (uint32_t edge = graph.EdgesBegin (source); edge != graph.EdgesEnd (source); edge++)
+    {
+      if (!graph.IsEdgeUp (edge))
+        continue;
+
+      uint32_t to = graph.GetEdgeTarget (edge);
+      uint64_t remaining = GetRemainingCost (to, source);
+      if (remaining == unreachable)
+        continue;
+
+      // path through the edge wins only if it is not more expensive than the best path through a disabled face
+      uint64_t cost = remaining + graph.GetEdgeMetric (edge);
+      uint64_t otherRemaining = (edge == bestEdge) ? secondBest : best;
+      if (otherRemaining != unreachable && otherRemaining + disabledMetric < cost)
+        continue;
+
+      bool avoiding = IsInSubtree (to, source);
+      Alternative alternative = { source, edge, static_cast<uint32_t> (cost),
+                                  (avoiding ? m_avoidingDelay[to] : m_delay[to]) + graph.GetEdgeDelay (edge) };
+      m_alternatives.push_back (alternative);
+    }
+}
+
+void
+GlobalRoutingReverseTree::Calculate (const GlobalRoutingGraph &graph, uint32_t destination)
+{
+  NS_ASSERT (destination < graph.GetNVertices ());
+
+  uint32_t n = graph.GetNVertices ();
+  m_destination = destination;
+  m_cost.assign (n, GlobalRoutingGraph::INVALID);
+  m_delay.assign (n, 0.0);
+  m_nextEdge.assign (n, GlobalRoutingGraph::INVALID);
+
+  std::vector<HeapItem> heap;
+  m_cost[destination] = 0;
+  heap.push_back (HeapItem (0, destination));
+
+  Propagate (graph, heap, 0, 0);
+}
+
+void
+GlobalRoutingReverseTree::Update (const GlobalRoutingGraph &graph,
+                                  const std::vector<uint32_t> &changedEdges, const std::vector<uint32_t> &oldMetrics,
+                                  std::vector<Change> &changes)
+{
+  NS_ASSERT (changedEdges.size () == oldMetrics.size ());
+  NS_ASSERT (m_cost.size () == graph.GetNVertices ());
+
+  uint32_t n = graph.GetNVertices ();
+  std::vector<bool> touched (n, false);
+  std::vector<HeapItem> heap;
+
+  // 1. Edges of the tree that became more expensive (or down) invalidate paths of their whole subtrees
+  std::vector<uint32_t> stack;
+  for (uint32_t i = 0; i < changedEdges.size (); i++)
+    {
+      uint32_t edge = changedEdges[i];
+      if (graph.GetEdgeMetric (edge) > oldMetrics[i] && m_nextEdge[graph.GetEdgeSource (edge)] == edge)
+        stack.push_back (graph.GetEdgeSource (edge));
+    }
+
+  std::vector<uint32_t> invalidated;
+  if (!stack.empty ())
+    {
+      // children lists of the tree
+      std::vector<uint32_t> childOffsets (n + 1, 0);
+      for (uint32_t vertex = 0; vertex < n; vertex++)
+        {
+          if (m_nextEdge[vertex] != GlobalRoutingGraph::INVALID)
+            childOffsets[graph.GetEdgeTarget (m_nextEdge[vertex]) + 1] ++;
+        }
+      for (uint32_t vertex = 0; vertex < n; vertex++)
+        {
+          childOffsets[vertex + 1] += childOffsets[vertex];
+        }
+      std::vector<uint32_t> children (childOffsets[n]);
+      std::vector<uint32_t> position (childOffsets.begin (), childOffsets.end () - 1);
+      for (uint32_t vertex = 0; vertex < n; vertex++)
+        {
+          if (m_nextEdge[vertex] != GlobalRoutingGraph::INVALID)
+            children[position[graph.GetEdgeTarget (m_nextEdge[vertex])]++] = vertex;
+        }
+
+      while (!stack.empty ())
+        {
+          uint32_t vertex = stack.back ();
+          stack.pop_back ();
+          if (touched[vertex])
+            continue;
+
+          Touch (vertex, &touched, &changes);
+          invalidated.push_back (vertex);
+          for (uint32_t i = childOffsets[vertex]; i != childOffsets[vertex + 1]; i++)
+            {
+              stack.push_back (children[i]);
+            }
+        }
+
+      BOOST_FOREACH (uint32_t vertex, invalidated)
+        {
+          m_cost[vertex] = GlobalRoutingGraph::INVALID;
+          m_delay[vertex] = 0.0;
+          m_nextEdge[vertex] = GlobalRoutingGraph::INVALID;
+        }
+
+      // reattach invalidated vertices to the valid part of the tree
+      BOOST_FOREACH (uint32_t vertex, invalidated)
+        {
+          for (uint32_t edge = graph.EdgesBegin (vertex); edge != graph.EdgesEnd (vertex); edge++)
+            {
+              uint32_t to = graph.GetEdgeTarget (edge);
+              if (!graph.IsEdgeUp (edge) || m_cost[to] == GlobalRoutingGraph::INVALID)
+                continue;
+
+              uint32_t cost = m_cost[to] + graph.GetEdgeMetric (edge);
+              if (cost < m_cost[vertex])
+                {
+                  m_cost[vertex] = cost;
+                  m_delay[vertex] = m_delay[to] + graph.GetEdgeDelay (edge);
+                  m_nextEdge[vertex] = edge;
+                }
+            }
+
+          if (m_cost[vertex] != GlobalRoutingGraph::INVALID)
+            heap.push_back (HeapItem (m_cost[vertex], vertex));
+        }
+    }
+
+  // 2. Edges that became cheaper (or up) can shorten paths of their source vertices
+  for (uint32_t i = 0; i < changedEdges.size (); i++)
+    {
+      uint32_t edge = changedEdges[i];
+      if (!graph.IsEdgeUp (edge) || graph.GetEdgeMetric (edge) >= oldMetrics[i])
+        continue;
+
+      uint32_t from = graph.GetEdgeSource (edge);
+      uint32_t to = graph.GetEdgeTarget (edge);
+      if (m_cost[to] == GlobalRoutingGraph::INVALID)
+        continue;
+
+      uint32_t cost = m_cost[to] + graph.GetEdgeMetric (edge);
+      if (cost < m_cost[from])
+        {
+          Touch (from, &touched, &changes);
+          m_cost[from] = cost;
+          m_delay[from] = m_delay[to] + graph.GetEdgeDelay (edge);
+          m_nextEdge[from] = edge;
+          heap.push_back (HeapItem (cost, from));
+        }
+    }
+
+  // 3. Propagate new costs to the rest of the tree
+  std::make_heap (heap.begin (), heap.end (), std::greater<HeapItem> ());
+  Propagate (graph, heap, &touched, &changes);
+}
+
+void
+GlobalRoutingReverseTree::Propagate (const GlobalRoutingGraph &graph, std::vector<HeapItem> &heap,
+                                     std::vector<bool> *touched, std::vector<Change> *changes)
+{
+  std::greater<HeapItem> heapCompare; // min-heap
+
+  while (!heap.empty ())
+    {
+      std::pop_heap (heap.begin (), heap.end (), heapCompare);
+      HeapItem item = heap.back ();
+      heap.pop_back ();
+
+      uint32_t vertex = item.second;
+      if (item.first != m_cost[vertex])
+        continue;
+
+      for (uint32_t i = graph.InEdgesBegin (vertex); i != graph.InEdgesEnd (vertex); i++)
+        {
+          uint32_t edge = graph.GetInEdge (i);
+          if (!graph.IsEdgeUp (edge))
+            continue;
+
+          uint32_t from = graph.GetEdgeSource (edge);
+          uint32_t cost = m_cost[vertex] + graph.GetEdgeMetric (edge);
+          if (cost >= m_cost[from])
+            continue;
+
+          Touch (from, touched, changes);
+          m_cost[from] = cost;
+          m_delay[from] = m_delay[vertex] + graph.GetEdgeDelay (edge);
+          m_nextEdge[from] = edge;
+
+          heap.push_back (HeapItem (cost, from));
+          std::push_heap (heap.begin (), heap.end (), heapCompare);
+        }
+    }
+}
+
+} // namespace ndn
+} // namespace ns3
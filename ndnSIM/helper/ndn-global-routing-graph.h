@@ -0,0 +1,570 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+
+#ifndef NDN_GLOBAL_ROUTING_GRAPH_H
+#define NDN_GLOBAL_ROUTING_GRAPH_H
+
+#include "ns3/ptr.h"
+
+#include <vector>
+#include <limits>
+
+namespace ns3 {
+namespace ndn {
+
+class GlobalRouter;
+class Face;
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Compact snapshot of the GlobalRouter graph used for route calculation
+ *
+ * Vertices are GlobalRouters of nodes, followed by GlobalRouters of channels, and are numbered
+ * from 0 to GetNVertices () - 1.  Out-edges are stored in compressed sparse row form: edges of vertex v
+ * are [EdgesBegin (v), EdgesEnd (v)).  Face metrics, face up/down status, and link delays are copied at the time
+ * of the snapshot.  Edges of faces that are down are kept in the graph (numbering of edges does not depend on face
+ * status), but have to be skipped by the algorithms (see IsEdgeUp).
+ */
+class GlobalRoutingGraph
+{
+public:
+  /**
+   * @brief Value used for invalid vertex or edge
+   */
+  static const uint32_t INVALID = std::numeric_limits<uint32_t>::max ();
+
+  /**
+   * @brief Create snapshot of all GlobalRouters in the simulation
+   */
+  GlobalRoutingGraph ();
+
+  /**
+   * @brief Recreate snapshot of all GlobalRouters in the simulation
+   */
+  void
+  Update ();
+
+  /**
+   * @brief Re-read metrics and up/down status of faces, assuming that topology itself did not change
+   *
+   * @param changedEdges  edges whose metric (or status) has changed are appended to this list
+   * @param oldMetrics    previous metrics of the changed edges are appended to this list
+   */
+  void
+  UpdateMetrics (std::vector<uint32_t> &changedEdges, std::vector<uint32_t> &oldMetrics);
+
+  /**
+   * @brief Total number of vertices (nodes and channels)
+   */
+  inline uint32_t
+  GetNVertices () const;
+
+  /**
+   * @brief Number of node vertices (vertices [0, GetNNodes ()) are nodes)
+   */
+  inline uint32_t
+  GetNNodes () const;
+
+  /**
+   * @brief Get GlobalRouter of the vertex
+   */
+  inline Ptr<GlobalRouter>
+  GetRouter (uint32_t vertex) const;
+
+  /**
+   * @brief Get vertex of the GlobalRouter (INVALID if router is not part of the snapshot)
+   */
+  uint32_t
+  GetVertex (Ptr<const GlobalRouter> router) const;
+
+  /**
+   * @brief Index of the first out-edge of the vertex
+   */
+  inline uint32_t
+  EdgesBegin (uint32_t vertex) const;
+
+  /**
+   * @brief Index past the last out-edge of the vertex
+   */
+  inline uint32_t
+  EdgesEnd (uint32_t vertex) const;
+
+  /**
+   * @brief Total number of edges
+   */
+  inline uint32_t
+  GetNEdges () const;
+
+  /**
+   * @brief Index of the first in-edge of the vertex (for GetInEdge)
+   */
+  inline uint32_t
+  InEdgesBegin (uint32_t vertex) const;
+
+  /**
+   * @brief Index past the last in-edge of the vertex (for GetInEdge)
+   */
+  inline uint32_t
+  InEdgesEnd (uint32_t vertex) const;
+
+  /**
+   * @brief Get edge from the list of in-edges
+   */
+  inline uint32_t
+  GetInEdge (uint32_t index) const;
+
+  /**
+   * @brief Vertex the edge starts from
+   */
+  inline uint32_t
+  GetEdgeSource (uint32_t edge) const;
+
+  /**
+   * @brief Vertex the edge leads to
+   */
+  inline uint32_t
+  GetEdgeTarget (uint32_t edge) const;
+
+  /**
+   * @brief Check if the face of the edge is up (edges from channels are always up)
+   */
+  inline bool
+  IsEdgeUp (uint32_t edge) const;
+
+  /**
+   * @brief Routing metric of the edge (metric of the face, 0 for edges from channels, INVALID if face is down)
+   */
+  inline uint32_t
+  GetEdgeMetric (uint32_t edge) const;
+
+  /**
+   * @brief Link delay of the edge (in seconds)
+   */
+  inline double
+  GetEdgeDelay (uint32_t edge) const;
+
+  /**
+   * @brief Face of the edge (0 for edges from channels)
+   */
+  inline Ptr<Face>
+  GetEdgeFace (uint32_t edge) const;
+
+private:
+  static uint32_t
+  GetFaceMetric (Ptr<Face> face);
+
+private:
+  std::vector< Ptr<GlobalRouter> > m_routers;
+  uint32_t m_nodes;
+  std::vector<uint32_t> m_idToVertex; // GlobalRouter::GetId () -> vertex
+
+  std::vector<uint32_t> m_offsets;
+  std::vector<uint32_t> m_sources;
+  std::vector<uint32_t> m_targets;
+  std::vector<uint32_t> m_metrics;
+  std::vector<double> m_delays;
+  std::vector< Ptr<Face> > m_faces;
+
+  std::vector<uint32_t> m_inOffsets;
+  std::vector<uint32_t> m_inEdges;
+};
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Single-source shortest paths on GlobalRoutingGraph
+ *
+ * Dijkstra's algorithm with a binary heap and flat per-vertex arrays.  Buffers are kept between
+ * Calculate calls, so one object should be reused for all sources.  For every reachable vertex the
+ * object provides path cost, path delay, and the first edge on the path (which defines the outgoing face).
+ *
+ * Calculation only reads the graph, so several objects can work on the same graph in parallel.
+ */
+class GlobalRoutingShortestPaths
+{
+public:
+  /**
+   * @brief Calculate shortest paths from the source vertex
+   *
+   * @param graph      graph snapshot
+   * @param source     source vertex
+   * @param onlyEdge   if specified, all other out-edges of the source are considered disabled
+   *                   (get metric std::numeric_limits<uint16_t>::max () - 1, as faces in
+   *                   GlobalRoutingHelper::CalculateAllPossibleRoutes)
+   */
+  void
+  Calculate (const GlobalRoutingGraph &graph, uint32_t source, uint32_t onlyEdge = GlobalRoutingGraph::INVALID);
+
+  /**
+   * @brief Check if the vertex can be reached from the source (source itself is not considered reachable)
+   */
+  inline bool
+  IsReachable (uint32_t vertex) const;
+
+  /**
+   * @brief Cost of the shortest path to the vertex
+   */
+  inline uint32_t
+  GetCost (uint32_t vertex) const;
+
+  /**
+   * @brief Delay of the shortest path to the vertex (in seconds)
+   */
+  inline double
+  GetDelay (uint32_t vertex) const;
+
+  /**
+   * @brief First edge (out-edge of the source) on the shortest path to the vertex
+   */
+  inline uint32_t
+  GetFirstEdge (uint32_t vertex) const;
+
+private:
+  std::vector<uint32_t> m_cost;
+  std::vector<double> m_delay;
+  std::vector<uint32_t> m_firstEdge;
+  std::vector< std::pair<uint32_t, uint32_t> > m_heap; // (cost, vertex)
+};
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Per-face routes towards one destination vertex, derived from a single reverse shortest path tree
+ *
+ * For every node vertex s and every out-edge e of s, the object calculates the cost of the shortest path
+ * that starts with e and does not return to s.  These are the routes GlobalRoutingHelper::CalculateAllPossibleRoutes
+ * installs for the face of e: a path through e is installed unless it costs more than a path through any other
+ * (disabled, metric std::numeric_limits<uint16_t>::max () - 1) face of s.
+ *
+ * Shortest paths that avoid s differ from the ones in the reverse tree only for vertices in the subtree
+ * of s, so only these are recalculated for every source.
+ *
+ * Calculation only reads the graph, so several objects can work on the same graph in parallel.
+ */
+class GlobalRoutingAlternativePaths
+{
+public:
+  /**
+   * @brief Route from a source vertex towards the destination through one of the source's out-edges
+   */
+  struct Alternative
+  {
+    uint32_t source; ///< @brief source (node) vertex
+    uint32_t edge;   ///< @brief out-edge of the source (defines face)
+    uint32_t cost;   ///< @brief cost of the path
+    double delay;    ///< @brief delay of the path (in seconds)
+  };
+
+  /**
+   * @brief Calculate alternatives of all node vertices towards the destination vertex
+   */
+  void
+  Calculate (const GlobalRoutingGraph &graph, uint32_t destination);
+
+  /**
+   * @brief Get alternatives calculated by the last Calculate call
+   */
+  inline const std::vector<Alternative> &
+  GetAlternatives () const;
+
+private:
+  void
+  BuildTree (const GlobalRoutingGraph &graph, uint32_t destination);
+
+  void
+  CalculateAvoiding (const GlobalRoutingGraph &graph, uint32_t source);
+
+  /**
+   * @brief Check if the vertex is in the subtree of root (root itself is excluded)
+   */
+  inline bool
+  IsInSubtree (uint32_t vertex, uint32_t root) const;
+
+  /**
+   * @brief Cost from the vertex to the destination on a path avoiding the source
+   */
+  uint64_t
+  GetRemainingCost (uint32_t vertex, uint32_t source) const;
+
+private:
+  // reverse shortest path tree towards the destination
+  std::vector<uint32_t> m_cost;
+  std::vector<double> m_delay;
+  std::vector<uint32_t> m_parent;
+  std::vector<uint32_t> m_childOffsets;
+  std::vector<uint32_t> m_children;
+  std::vector<uint32_t> m_enter; // position of the vertex in the preorder
+  std::vector<uint32_t> m_leave; // position past the subtree of the vertex in the preorder
+  std::vector<uint32_t> m_preorder;
+  std::vector<uint32_t> m_stack;
+
+  // shortest paths that avoid the current source (valid only for the subtree of the source)
+  std::vector<uint32_t> m_avoidingCost;
+  std::vector<double> m_avoidingDelay;
+
+  std::vector< std::pair<uint32_t, uint32_t> > m_heap; // (cost, vertex)
+  std::vector<Alternative> m_alternatives;
+};
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Shortest path tree towards one destination vertex that can be updated incrementally
+ *
+ * For every vertex, the tree keeps cost and delay of the shortest path to the destination and
+ * the first edge of this path (which defines the face for the FIB entry).
+ *
+ * After metrics or face statuses change (see GlobalRoutingGraph::UpdateMetrics), Update recalculates only
+ * the affected part of the tree: subtrees hanging off edges that became more expensive (or down) are
+ * reattached to the rest of the tree, and vertices that can use edges that became cheaper (or up) are relaxed.
+ */
+class GlobalRoutingReverseTree
+{
+public:
+  /**
+   * @brief Previous state of a vertex modified by Update
+   */
+  struct Change
+  {
+    uint32_t vertex; ///< @brief modified vertex
+    uint32_t edge;   ///< @brief previous first edge on the path (INVALID if was unreachable)
+    uint32_t cost;   ///< @brief previous cost of the path
+  };
+
+  /**
+   * @brief Calculate the tree from scratch
+   */
+  void
+  Calculate (const GlobalRoutingGraph &graph, uint32_t destination);
+
+  /**
+   * @brief Update the tree after metrics of some edges changed
+   *
+   * @param graph         graph with updated metrics
+   * @param changedEdges  edges with changed metrics
+   * @param oldMetrics    previous metrics of the changed edges
+   * @param changes       previous state of every vertex modified by the update is appended to this list
+   *                      (the final state of some of them can be the same as before)
+   */
+  void
+  Update (const GlobalRoutingGraph &graph,
+          const std::vector<uint32_t> &changedEdges, const std::vector<uint32_t> &oldMetrics,
+          std::vector<Change> &changes);
+
+  /**
+   * @brief Get destination vertex of the tree
+   */
+  inline uint32_t
+  GetDestination () const;
+
+  /**
+   * @brief Check if the destination can be reached from the vertex (destination itself is not considered reachable)
+   */
+  inline bool
+  IsReachable (uint32_t vertex) const;
+
+  /**
+   * @brief Cost of the shortest path from the vertex
+   */
+  inline uint32_t
+  GetCost (uint32_t vertex) const;
+
+  /**
+   * @brief Delay of the shortest path from the vertex (in seconds)
+   */
+  inline double
+  GetDelay (uint32_t vertex) const;
+
+  /**
+   * @brief First edge (out-edge of the vertex) on the shortest path from the vertex
+   */
+  inline uint32_t
+  GetNextEdge (uint32_t vertex) const;
+
+private:
+  typedef std::pair<uint32_t, uint32_t> HeapItem; // (cost, vertex)
+
+  void
+  Propagate (const GlobalRoutingGraph &graph, std::vector<HeapItem> &heap,
+             std::vector<bool> *touched, std::vector<Change> *changes);
+
+  inline void
+  Touch (uint32_t vertex, std::vector<bool> *touched, std::vector<Change> *changes);
+
+private:
+  uint32_t m_destination;
+  std::vector<uint32_t> m_cost;
+  std::vector<double> m_delay;
+  std::vector<uint32_t> m_nextEdge;
+};
+
+/////////////////////////////////////////////////////////////////////
+
+inline uint32_t
+GlobalRoutingGraph::GetNVertices () const
+{
+  return m_routers.size ();
+}
+
+inline uint32_t
+GlobalRoutingGraph::GetNNodes () const
+{
+  return m_nodes;
+}
+
+inline Ptr<GlobalRouter>
+GlobalRoutingGraph::GetRouter (uint32_t vertex) const
+{
+  return m_routers[vertex];
+}
+
+inline uint32_t
+GlobalRoutingGraph::EdgesBegin (uint32_t vertex) const
+{
+  return m_offsets[vertex];
+}
+
+inline uint32_t
+GlobalRoutingGraph::EdgesEnd (uint32_t vertex) const
+{
+  return m_offsets[vertex + 1];
+}
+
+inline uint32_t
+GlobalRoutingGraph::GetNEdges () const
+{
+  return m_targets.size ();
+}
+
+inline uint32_t
+GlobalRoutingGraph::InEdgesBegin (uint32_t vertex) const
+{
+  return m_inOffsets[vertex];
+}
+
+inline uint32_t
+GlobalRoutingGraph::InEdgesEnd (uint32_t vertex) const
+{
+  return m_inOffsets[vertex + 1];
+}
+
+inline uint32_t
+GlobalRoutingGraph::GetInEdge (uint32_t index) const
+{
+  return m_inEdges[index];
+}
+
+inline uint32_t
+GlobalRoutingGraph::GetEdgeSource (uint32_t edge) const
+{
+  return m_sources[edge];
+}
+
+inline uint32_t
+GlobalRoutingGraph::GetEdgeTarget (uint32_t edge) const
+{
+  return m_targets[edge];
+}
+
+inline bool
+GlobalRoutingGraph::IsEdgeUp (uint32_t edge) const
+{
+  return m_metrics[edge] != INVALID;
+}
+
+inline uint32_t
+GlobalRoutingGraph::GetEdgeMetric (uint32_t edge) const
+{
+  return m_metrics[edge];
+}
+
+inline double
+GlobalRoutingGraph::GetEdgeDelay (uint32_t edge) const
+{
+  return m_delays[edge];
+}
+
+inline Ptr<Face>
+GlobalRoutingGraph::GetEdgeFace (uint32_t edge) const
+{
+  return m_faces[edge];
+}
+
+inline bool
+GlobalRoutingShortestPaths::IsReachable (uint32_t vertex) const
+{
+  return m_firstEdge[vertex] != GlobalRoutingGraph::INVALID;
+}
+
+inline uint32_t
+GlobalRoutingShortestPaths::GetCost (uint32_t vertex) const
+{
+  return m_cost[vertex];
+}
+
+inline double
+GlobalRoutingShortestPaths::GetDelay (uint32_t vertex) const
+{
+  return m_delay[vertex];
+}
+
+inline uint32_t
+GlobalRoutingShortestPaths::GetFirstEdge (uint32_t vertex) const
+{
+  return m_firstEdge[vertex];
+}
+
+inline const std::vector<GlobalRoutingAlternativePaths::Alternative> &
+GlobalRoutingAlternativePaths::GetAlternatives () const
+{
+  return m_alternatives;
+}
+
+inline bool
+GlobalRoutingAlternativePaths::IsInSubtree (uint32_t vertex, uint32_t root) const
+{
+  return m_enter[vertex] != GlobalRoutingGraph::INVALID &&
+    m_enter[root] < m_enter[vertex] && m_enter[vertex] < m_leave[root];
+}
+
+inline uint32_t
+GlobalRoutingReverseTree::GetDestination () const
+{
+  return m_destination;
+}
+
+inline bool
+GlobalRoutingReverseTree::IsReachable (uint32_t vertex) const
+{
+  return m_nextEdge[vertex] != GlobalRoutingGraph::INVALID;
+}
+
+inline uint32_t
+GlobalRoutingReverseTree::GetCost (uint32_t vertex) const
+{
+  return m_cost[vertex];
+}
+
+inline double
+GlobalRoutingReverseTree::GetDelay (uint32_t vertex) const
+{
+  return m_delay[vertex];
+}
+
+inline uint32_t
+GlobalRoutingReverseTree::GetNextEdge (uint32_t vertex) const
+{
+  return m_nextEdge[vertex];
+}
+
+inline void
+GlobalRoutingReverseTree::Touch (uint32_t vertex, std::vector<bool> *touched, std::vector<Change> *changes)
+{
+  if (touched == 0 || (*touched)[vertex])
+    return;
+
+  (*touched)[vertex] = true;
+  Change change = { vertex, m_nextEdge[vertex], m_cost[vertex] };
+  changes->push_back (change);
+}
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_GLOBAL_ROUTING_GRAPH_H
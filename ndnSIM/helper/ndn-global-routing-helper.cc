@@ -29,8 +29,10 @@
 #include "ns3/ndn-l3-protocol.h"
 #include "../model/ndn-net-device-face.h"
 #include "../model/ndn-global-router.h"
+#include "../model/fw/global-routing-info.h"
 #include "ns3/ndn-name.h"
 #include "ns3/ndn-fib.h"
+#include "ns3/ndn-interest.h"
 
 #include "ns3/node.h"
 #include "ns3/node-container.h"
@@ -42,17 +44,28 @@
 #include "ns3/node-list.h"
 #include "ns3/channel-list.h"
 #include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/foreach.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/concept/assert.hpp>
 // #include <boost/graph/graph_concepts.hpp>
 // #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 
 #include "boost-graph-ndn-global-routing-helper.h"
+#include "ndn-global-routing-graph.h"
 
 #include <math.h>
+#include <unistd.h>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("ndn.GlobalRoutingHelper");
 
@@ -233,226 +246,1003 @@ GlobalRoutingHelper::AddOriginsForAll ()
     }
 }
 
+uint32_t GlobalRoutingHelper::m_threads = 1;
+
 void
-GlobalRoutingHelper::CalculateRoutes (bool invalidatedRoutes/* = true*/)
+GlobalRoutingHelper::SetThreads (uint32_t threads)
+{
+  m_threads = threads;
+}
+
+uint32_t
+GlobalRoutingHelper::GetThreads ()
 {
+  if (m_threads == 0)
+    {
+      long cores = sysconf (_SC_NPROCESSORS_ONLN);
+      return cores > 0 ? static_cast<uint32_t> (cores) : 1;
+    }
+  return m_threads;
+}
+
+namespace {
+
+/**
+ * @brief Route from a source to an origin vertex
+ */
+struct Route
+{
+  uint32_t source; ///< @brief node vertex, for which the route is calculated
+  uint32_t origin; ///< @brief vertex exporting prefixes
+  uint32_t edge;   ///< @brief out-edge of the source (defines face)
+  uint32_t cost;
+  double delay;
+};
+
+/**
+ * @brief Helper to calculate routes towards a batch of origins in parallel
+ *
+ * For shortest path routes, a shortest path tree towards every origin is calculated (and later kept
+ * for incremental updates).  For all possible routes, alternatives of every face are derived from the tree
+ * and stored as per-origin route lists.
+ *
+ * Worker threads only read the graph snapshot and write into per-origin trees or route lists
+ * (no ns-3 objects are touched), FIBs are updated by the caller in the main thread.
+ */
+class RouteCalculator
+{
+public:
   /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
+   * @param graph    graph snapshot
+   * @param origins  vertices exporting prefixes
+   * @param trees    if not null, shortest path trees are calculated into (*trees)[i] for origins[i],
+   *                 otherwise all possible routes are calculated
    */
+  RouteCalculator (const GlobalRoutingGraph &graph, const std::vector<uint32_t> &origins,
+                   std::vector<GlobalRoutingReverseTree> *trees)
+    : m_graph (graph)
+    , m_origins (origins)
+    , m_trees (trees)
+    , m_first (0)
+    , m_next (0)
+    , m_last (0)
+  {
+  }
 
-  BOOST_CONCEPT_ASSERT(( VertexListGraphConcept< NdnGlobalRouterGraph > ));
-  BOOST_CONCEPT_ASSERT(( IncidenceGraphConcept< NdnGlobalRouterGraph > ));
+  /**
+   * @brief Calculate routes towards origins [first, last) using the specified number of threads
+   */
+  void
+  Calculate (uint32_t first, uint32_t last, uint32_t threads)
+  {
+    m_first = first;
+    m_next = first;
+    m_last = last;
+    if (m_trees == 0)
+      {
+        m_routes.resize (last - first);
+      }
+
+    if (threads <= 1 || last - first <= 1)
+      {
+        Run ();
+        return;
+      }
+
+    std::vector< Ptr<SystemThread> > workers;
+    for (uint32_t i = 0; i < std::min (threads, last - first); i++)
+      {
+        workers.push_back (Create<SystemThread> (MakeCallback (&RouteCalculator::Run, this)));
+        workers.back ()->Start ();
+      }
+
+    BOOST_FOREACH (Ptr<SystemThread> &worker, workers)
+      {
+        worker->Join ();
+      }
+  }
 
-  NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  /**
+   * @brief Get all possible routes towards the origin (only if trees are not calculated)
+   */
+  const std::vector<Route> &
+  GetRoutes (uint32_t originIndex) const
+  {
+    return m_routes[originIndex - m_first];
+  }
+
+private:
+  void
+  Run ()
+  {
+    GlobalRoutingAlternativePaths alternatives;
+    while (true)
+      {
+        uint32_t originIndex;
+        {
+          CriticalSection lock (m_mutex);
+          if (m_next >= m_last)
+            break;
+          originIndex = m_next++;
+        }
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+        uint32_t origin = m_origins[originIndex];
+        if (m_trees != 0)
+          {
+            (*m_trees)[originIndex].Calculate (m_graph, origin);
+            continue;
+          }
+
+        std::vector<Route> &routes = m_routes[originIndex - m_first];
+        routes.clear ();
+
+        alternatives.Calculate (m_graph, origin);
+        BOOST_FOREACH (const GlobalRoutingAlternativePaths::Alternative &alternative, alternatives.GetAlternatives ())
+          {
+            Route route = { alternative.source, origin, alternative.edge, alternative.cost, alternative.delay };
+            routes.push_back (route);
+          }
+      }
+  }
+
+private:
+  const GlobalRoutingGraph &m_graph;
+  const std::vector<uint32_t> &m_origins;
+  std::vector<GlobalRoutingReverseTree> *m_trees;
+
+  SystemMutex m_mutex;
+  uint32_t m_first;
+  uint32_t m_next;
+  uint32_t m_last;
+  std::vector< std::vector<Route> > m_routes;
+};
+
+/**
+ * @brief Routes calculated by the last CalculateRoutes call, used by UpdateRoutes
+ */
+struct RoutingState
+{
+  /**
+   * @brief Origins of one prefix (a prefix can be exported by several nodes, see AddOrigins)
+   */
+  struct PrefixOrigins
+  {
+    Ptr<const Name> prefix;
+    std::vector<uint32_t> origins; ///< @brief indexes into RoutingState::origins
+  };
+
+  GlobalRoutingGraph graph;
+  std::vector<uint32_t> origins;
+  std::vector<GlobalRoutingReverseTree> trees; ///< @brief shortest path tree towards every origin
+  std::map<Name, PrefixOrigins> prefixes;
+};
+
+boost::shared_ptr<RoutingState> g_routingState;
+
+void
+ClearRoutingState ()
+{
+  g_routingState.reset ();
+}
+
+/**
+ * @brief FIB entries created by CompressFibs (removed before routes are calculated again)
+ */
+std::vector< std::pair< Ptr<Fib>, Ptr<const Name> > > g_aggregatedEntries;
+
+void
+ClearAggregatedEntries ()
+{
+  g_aggregatedEntries.clear ();
+}
+
+/**
+ * @brief Next hop of a FIB entry, as installed by global routing
+ */
+struct NextHop
+{
+  Ptr<Face> face;
+  int32_t cost;
+  fib::FaceMetric::Status status;
+  Time delay;
+
+  bool
+  operator < (const NextHop &other) const
+  {
+    if (face != other.face) return face < other.face;
+    if (cost != other.cost) return cost < other.cost;
+    if (status != other.status) return status < other.status;
+    return delay < other.delay;
+  }
+
+  bool
+  operator == (const NextHop &other) const
+  {
+    return face == other.face && cost == other.cost && status == other.status && delay == other.delay;
+  }
+};
+
+typedef std::vector<NextHop> NextHops;
+
+/**
+ * @brief Next hops of the entry, sorted by face
+ */
+NextHops
+GetNextHops (Ptr<const fib::Entry> entry)
+{
+  NextHops hops;
+  BOOST_FOREACH (const fib::FaceMetric &metric, entry->m_faces)
     {
-      Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter> ();
-      if (source == 0)
-	{
-	  NS_LOG_DEBUG ("Node " << (*node)->GetId () << " does not export GlobalRouter interface");
-	  continue;
-	}
+      NextHop hop = { metric.GetFace (), metric.GetRoutingCost (), metric.GetStatus (), metric.GetRealDelay () };
+      hops.push_back (hop);
+    }
+  std::sort (hops.begin (), hops.end ());
+  return hops;
+}
 
-      DistancesMap    distances;
-
-      dijkstra_shortest_paths (graph, source,
-			       // predecessor_map (boost::ref(predecessors))
-			       // .
-			       distance_map (boost::ref(distances))
-			       .
-			       distance_inf (WeightInf)
-			       .
-			       distance_zero (WeightZero)
-			       .
-			       distance_compare (boost::WeightCompare ())
-			       .
-			       distance_combine (boost::WeightCombine ())
-			       );
-
-      // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
-
-      Ptr<Fib>  fib  = source->GetObject<Fib> ();
+/**
+ * @brief Namespaces looked up by exact name (Fib::Find), whose entries are never aggregated
+ *        (see GlobalRoutingHelper::AddExactNamespace)
+ */
+std::vector<Name> g_exactNamespaces;
+
+/**
+ * @brief ORTC-style aggregation of one FIB on the name tree of its prefixes
+ *
+ * Every distinct set of next hops gets an id.  Tree vertices are the FIB prefixes and all their
+ * ancestors, a vertex is always created after its parent.  Names under an original prefix must keep
+ * resolving to the same next hops.  Names outside all original prefixes had no route and must keep
+ * having none, unless aggregateUnrouted is set, which makes them "don't care".
+ *
+ * Bottom-up, each vertex gets candidate next hop sets: the set of the closest original prefix if the
+ * vertex is under one (its own names fix the choice), otherwise (only with aggregateUnrouted) the sets
+ * most common among the children.  Top-down, a vertex needs an entry only if the set inherited from
+ * its parent is not a candidate.  Original entries under g_exactNamespaces are always kept.
+ */
+class FibCompressor
+{
+public:
+  static const uint32_t NO_HOPS = 0xffffffff;
+
+  FibCompressor (Ptr<Fib> fib, bool aggregateUnrouted)
+    : m_fib (fib)
+    , m_aggregateUnrouted (aggregateUnrouted)
+  {
+    m_vertices.push_back (Vertex (Name (), NO_HOPS));
+
+    std::vector< Ptr<fib::Entry> > entries;
+    for (Ptr<fib::Entry> entry = m_fib->Begin (); entry != m_fib->End (); entry = m_fib->Next (entry))
+      {
+        entries.push_back (entry);
+      }
+
+    BOOST_FOREACH (Ptr<fib::Entry> entry, entries)
+      {
+        uint32_t vertex = 0;
+        BOOST_FOREACH (const name::Component &comp, entry->GetPrefix ())
+          {
+            std::map<name::Component, uint32_t>::iterator child = m_vertices[vertex].children.find (comp);
+            if (child == m_vertices[vertex].children.end ())
+              {
+                Name prefix (m_vertices[vertex].prefix);
+                prefix.append (comp);
+                m_vertices.push_back (Vertex (prefix, vertex));
+                m_vertices.back ().exact = m_vertices[vertex].exact || IsExactNamespace (prefix);
+                child = m_vertices[vertex].children.insert (std::make_pair (comp, m_vertices.size () - 1)).first;
+              }
+            vertex = child->second;
+          }
+
+        std::pair<std::map<NextHops, uint32_t>::iterator, bool> hops =
+          m_hopIds.insert (std::make_pair (GetNextHops (entry), m_representatives.size ()));
+        if (hops.second)
+          {
+            m_representatives.push_back (entry);
+            m_hopSets.push_back (hops.first->first);
+          }
+
+        m_vertices[vertex].entry = entry;
+        m_vertices[vertex].hops = hops.first->second;
+      }
+  }
+
+  /**
+   * @brief Replace FIB entries with the aggregated ones
+   * @returns number of FIB entries after compression
+   */
+  uint32_t
+  Compress ()
+  {
+    // required next hops of the names of each vertex (NO_HOPS: don't care)
+    for (uint32_t vertex = 0; vertex < m_vertices.size (); vertex++)
+      {
+        Vertex &v = m_vertices[vertex];
+        v.required = v.hops != NO_HOPS ? v.hops : (vertex == 0 ? NO_HOPS : m_vertices[v.parent].required);
+      }
+
+    // candidate sets, bottom-up (empty: any set)
+    std::map<uint32_t, uint32_t> counts;
+    for (uint32_t vertex = m_vertices.size (); vertex-- > 0; )
+      {
+        Vertex &v = m_vertices[vertex];
+        if (v.required != NO_HOPS)
+          {
+            v.candidates.assign (1, v.required);
+            continue;
+          }
+
+        // no candidates: the vertex never gets a new entry, and its names resolve to no entry
+        if (!m_aggregateUnrouted || v.exact)
+          continue;
+
+        counts.clear ();
+        uint32_t maxCount = 0;
+        for (std::map<name::Component, uint32_t>::iterator child = v.children.begin (); child != v.children.end (); child++)
+          {
+            BOOST_FOREACH (uint32_t hops, m_vertices[child->second].candidates)
+              {
+                maxCount = std::max (maxCount, ++counts[hops]);
+              }
+          }
+        for (std::map<uint32_t, uint32_t>::iterator count = counts.begin (); count != counts.end (); count++)
+          {
+            if (count->second == maxCount)
+              v.candidates.push_back (count->first);
+          }
+      }
+
+    // choose sets top-down, new entries are added before old ones (possibly used as templates) are removed
+    std::vector<uint32_t> inherited (m_vertices.size (), NO_HOPS);
+    std::vector<uint32_t> assigned (m_vertices.size (), NO_HOPS);
+    for (uint32_t vertex = 0; vertex < m_vertices.size (); vertex++)
+      {
+        Vertex &v = m_vertices[vertex];
+        uint32_t hops = vertex == 0 ? NO_HOPS : inherited[v.parent];
+
+        if (v.exact && v.hops != NO_HOPS)
+          {
+            hops = v.hops;
+            assigned[vertex] = hops;
+          }
+        else if (!v.candidates.empty () &&
+            (hops == NO_HOPS || !std::binary_search (v.candidates.begin (), v.candidates.end (), hops)))
+          {
+            // existing entry is always a candidate of its vertex
+            hops = v.hops != NO_HOPS ? v.hops : v.candidates.front ();
+            assigned[vertex] = hops;
+
+            if (v.hops == NO_HOPS)
+              {
+                AddEntry (v.prefix, m_representatives[hops]);
+              }
+          }
+        inherited[vertex] = hops;
+      }
+
+    uint32_t size = 0;
+    for (uint32_t vertex = 0; vertex < m_vertices.size (); vertex++)
+      {
+        Vertex &v = m_vertices[vertex];
+        if (assigned[vertex] != NO_HOPS)
+          {
+            NS_ASSERT (v.hops == NO_HOPS || v.hops == assigned[vertex]);
+            size++;
+          }
+        else if (v.hops != NO_HOPS)
+          {
+            m_fib->Remove (Create<Name> (v.prefix));
+          }
+      }
+    return size;
+  }
+
+  /**
+   * @brief Check that names under every original prefix resolve to the same next hops, names outside
+   *        all original prefixes to no entry (unless aggregateUnrouted), and that entries in
+   *        under g_exactNamespaces are kept
+   */
+  bool
+  Verify () const
+  {
+    const name::Component probe ("fib-compression-probe");
+    BOOST_FOREACH (const Vertex &v, m_vertices)
+      {
+        if (v.exact && v.hops != NO_HOPS && m_fib->Find (v.prefix) == 0)
+          {
+            NS_LOG_ERROR ("FIB compression removed entry " << v.prefix);
+            return false;
+          }
+
+        if (v.required == NO_HOPS)
+          {
+            if (m_aggregateUnrouted)
+              continue;
+
+            Name name (v.prefix);
+            if (!Resolves (v.prefix, NO_HOPS) || !Resolves (name.append (probe), NO_HOPS))
+              return false;
+            continue;
+          }
+
+        if (!Resolves (v.prefix, v.required))
+          return false;
+
+        if (v.children.find (probe) == v.children.end ())
+          {
+            Name name (v.prefix);
+            if (!Resolves (name.append (probe), v.required))
+              return false;
+          }
+      }
+    return true;
+  }
+
+private:
+  bool
+  Resolves (const Name &name, uint32_t hops) const
+  {
+    Ptr<Interest> interest = Create<Interest> ();
+    interest->SetName (Create<Name> (name));
+
+    Ptr<fib::Entry> entry = m_fib->LongestPrefixMatch (*interest);
+    if (hops == NO_HOPS ? entry != 0 : (entry == 0 || GetNextHops (entry) != m_hopSets[hops]))
+      {
+        NS_LOG_ERROR ("FIB compression changed next hops of " << name);
+        return false;
+      }
+    return true;
+  }
+
+  static bool
+  IsExactNamespace (const Name &prefix)
+  {
+    return std::find (g_exactNamespaces.begin (), g_exactNamespaces.end (), prefix) != g_exactNamespaces.end ();
+  }
+
+  void
+  AddEntry (const Name &prefix, Ptr<fib::Entry> representative)
+  {
+    Ptr<const Name> name = Create<Name> (prefix);
+    Ptr<Limits> limits = representative->GetObject<Limits> ();
+
+    Ptr<fib::Entry> entry;
+    BOOST_FOREACH (const fib::FaceMetric &metric, representative->m_faces)
+      {
+        entry = m_fib->Add (name, metric.GetFace (), metric.GetRoutingCost ());
+        entry->SetRealDelayToProducer (metric.GetFace (), metric.GetRealDelay ());
+        entry->UpdateStatus (metric.GetFace (), metric.GetStatus ());
+      }
+
+    if (entry != 0 && limits != 0 && entry->GetObject<Limits> () != 0)
+      {
+        entry->GetObject<Limits> ()->SetLimits (limits->GetMaxRate (), limits->GetMaxDelay ());
+      }
+
+    g_aggregatedEntries.push_back (std::make_pair (m_fib, name));
+  }
+
+  struct Vertex
+  {
+    Vertex (const Name &prefix_, uint32_t parent_)
+      : prefix (prefix_)
+      , parent (parent_)
+      , hops (NO_HOPS)
+      , required (NO_HOPS)
+      , exact (false)
+    {
+    }
+
+    Name prefix;
+    uint32_t parent;
+    std::map<name::Component, uint32_t> children;
+    Ptr<fib::Entry> entry; ///< @brief original FIB entry
+    uint32_t hops;         ///< @brief next hop set of the original entry
+    uint32_t required;     ///< @brief next hop set of the vertex names (of the closest original prefix)
+    std::vector<uint32_t> candidates; ///< @brief sorted candidate next hop sets
+    bool exact;            ///< @brief vertex is under g_exactNamespaces
+  };
+
+  Ptr<Fib> m_fib;
+  bool m_aggregateUnrouted;
+  std::vector<Vertex> m_vertices;
+  std::map<NextHops, uint32_t> m_hopIds;
+  std::vector< Ptr<fib::Entry> > m_representatives; ///< @brief entry with each next hop set
+  std::vector<NextHops> m_hopSets;
+};
+
+const uint32_t FibCompressor::NO_HOPS;
+
+} // anonymous namespace
+
+static void
+InstallRoute (Ptr<Fib> fib, Ptr<const Name> prefix, Ptr<Face> face, uint32_t cost, double delay)
+{
+  NS_LOG_DEBUG (" prefix " << *prefix << " reachable via face " << *face
+                << " with distance " << cost
+                << " with delay " << delay);
+
+  Ptr<fib::Entry> entry = fib->Add (prefix, face, cost);
+  entry->SetRealDelayToProducer (face, Seconds (delay));
+
+  Ptr<Limits> faceLimits = face->GetObject<Limits> ();
+
+  Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
+  if (fibLimits != 0)
+    {
+      // if it was created by the forwarding strategy via DidAddFibEntry event
+      fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * delay /*exact RTT*/);
+      NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
+                    2*delay << "s (" << faceLimits->GetMaxRate () * 2 * delay << ")");
+    }
+}
+
+/**
+ * @brief Get vertex for every monitor registered in fw::GlobalRoutingInfo (INVALID if monitor is not in the graph)
+ */
+static std::vector<uint32_t>
+GetMonitorVertices (const GlobalRoutingGraph &graph)
+{
+  std::vector<uint32_t> monitors (fw::GlobalRoutingInfo::getNMonitors (), GlobalRoutingGraph::INVALID);
+  for (uint32_t vertex = 0; vertex < graph.GetNNodes (); vertex++)
+    {
+      uint32_t monitor = fw::GlobalRoutingInfo::getMonitorIndex (graph.GetRouter (vertex)->GetObject<Node> ()->GetId ());
+      if (monitor != fw::GlobalRoutingInfo::NO_MONITOR)
+        monitors[monitor] = vertex;
+    }
+  return monitors;
+}
+
+/**
+ * @brief Report distances from monitors to prefixes of the origin to fw::GlobalRoutingInfo
+ *
+ * Distance is the cost of the shortest route from the monitor to any origin of the prefix, 0 if there is no route
+ * (or prefix is local).  Distances should be reset before the first origin is merged.
+ */
+static void
+MergeMonitorDistances (const GlobalRoutingGraph &graph, uint32_t origin, const std::vector<int32_t> &distances)
+{
+  if (distances.empty ())
+    return;
+
+  BOOST_FOREACH (const Ptr<const Name> &prefix, graph.GetRouter (origin)->GetLocalPrefixes ())
+    {
+      uint32_t prefixId = fw::GlobalRoutingInfo::addPrefix (*prefix);
+      for (uint32_t monitor = 0; monitor < distances.size (); monitor++)
+        {
+          if (distances[monitor] == 0)
+            continue;
+
+          int32_t current = fw::GlobalRoutingInfo::getDistance (monitor, prefixId);
+          if (current == 0 || distances[monitor] < current)
+            fw::GlobalRoutingInfo::putDistance (monitor, prefixId, distances[monitor]);
+        }
+    }
+}
+
+/**
+ * @brief Recalculate distances from all monitors to all prefixes using shortest path trees of the routing state
+ */
+static void
+UpdateMonitorDistances (const RoutingState &state)
+{
+  std::vector<uint32_t> monitors = GetMonitorVertices (state.graph);
+  if (monitors.empty ())
+    return;
+
+  fw::GlobalRoutingInfo::resetDistances ();
+
+  std::vector<int32_t> distances (monitors.size ());
+  for (uint32_t originIndex = 0; originIndex < state.origins.size (); originIndex++)
+    {
+      uint32_t origin = state.origins[originIndex];
+      const GlobalRoutingReverseTree &tree = state.trees[originIndex];
+
+      for (uint32_t monitor = 0; monitor < monitors.size (); monitor++)
+        {
+          uint32_t vertex = monitors[monitor];
+          distances[monitor] = 0;
+          if (vertex != GlobalRoutingGraph::INVALID && vertex != origin && tree.IsReachable (vertex))
+            distances[monitor] = tree.GetCost (vertex);
+        }
+      MergeMonitorDistances (state.graph, origin, distances);
+    }
+}
+
+static void
+CalculateAndInstallRoutes (bool invalidatedRoutes, bool allPossible)
+{
+  // entries created by CompressFibs are not routes, they are recreated by the next CompressFibs
+  for (uint32_t i = 0; i < g_aggregatedEntries.size (); i++)
+    {
+      g_aggregatedEntries[i].first->Remove (g_aggregatedEntries[i].second);
+    }
+  g_aggregatedEntries.clear ();
+
+  // Graph is flattened once and is not modified while routes are calculated
+  boost::shared_ptr<RoutingState> state = boost::make_shared<RoutingState> ();
+  const GlobalRoutingGraph &graph = state->graph;
+
+  // only vertices that export prefixes need to be checked after each run
+  std::vector<uint32_t> &origins = state->origins;
+  for (uint32_t vertex = 0; vertex < graph.GetNVertices (); vertex++)
+    {
+      if (!graph.GetRouter (vertex)->GetLocalPrefixes ().empty ())
+        origins.push_back (vertex);
+    }
+
+  std::vector< Ptr<Fib> > fibs (graph.GetNNodes ());
+  for (uint32_t source = 0; source < graph.GetNNodes (); source++)
+    {
+      fibs[source] = graph.GetRouter (source)->GetObject<Fib> ();
+      NS_ASSERT (fibs[source] != 0);
       if (invalidatedRoutes)
         {
-          fib->InvalidateAll ();
+          fibs[source]->InvalidateAll ();
         }
-      NS_ASSERT (fib != 0);
+    }
 
-      NS_LOG_DEBUG ("Reachability from Node: " << source->GetObject<Node> ()->GetId ());
-      for (DistancesMap::iterator i = distances.begin ();
-	   i != distances.end ();
-	   i++)
-	{
-	  if (i->first == source)
-	    continue;
-	  else
-	    {
-	      // cout << "  Node " << i->first->GetObject<Node> ()->GetId ();
-	      if (i->second.get<0> () == 0)
-		{
-		  // cout << " is unreachable" << endl;
-		}
-	      else
-		{
-                  BOOST_FOREACH (const Ptr<const Name> &prefix, i->first->GetLocalPrefixes ())
+  if (!allPossible)
+    {
+      state->trees.resize (origins.size ());
+
+      for (uint32_t originIndex = 0; originIndex < origins.size (); originIndex++)
+        {
+          BOOST_FOREACH (const Ptr<const Name> &prefix, graph.GetRouter (origins[originIndex])->GetLocalPrefixes ())
+            {
+              RoutingState::PrefixOrigins &prefixOrigins = state->prefixes[*prefix];
+              prefixOrigins.prefix = prefix;
+              prefixOrigins.origins.push_back (originIndex);
+            }
+        }
+    }
+
+  // distances from monitors are collected from the calculated routes, instead of monitors walking their FIBs
+  std::vector<uint32_t> monitorIndexes (graph.GetNNodes (), fw::GlobalRoutingInfo::NO_MONITOR);
+  std::vector<uint32_t> monitors = GetMonitorVertices (graph);
+  for (uint32_t monitor = 0; monitor < monitors.size (); monitor++)
+    {
+      if (monitors[monitor] != GlobalRoutingGraph::INVALID)
+        monitorIndexes[monitors[monitor]] = monitor;
+    }
+  if (allPossible)
+    {
+      fw::GlobalRoutingInfo::resetDistances ();
+    }
+
+  uint32_t threads = GlobalRoutingHelper::GetThreads ();
+  RouteCalculator calculator (graph, origins, allPossible ? 0 : &state->trees);
+
+  // origins are processed in batches to limit memory used by calculated routes
+  uint32_t batch = std::max<uint32_t> (64, 16 * threads);
+  for (uint32_t first = 0; first < origins.size (); first += batch)
+    {
+      uint32_t last = std::min<uint32_t> (first + batch, origins.size ());
+      calculator.Calculate (first, last, threads);
+
+      for (uint32_t originIndex = first; originIndex < last; originIndex++)
+        {
+          uint32_t origin = origins[originIndex];
+          const GlobalRouter::LocalPrefixList &prefixes = graph.GetRouter (origin)->GetLocalPrefixes ();
+
+          if (allPossible)
+            {
+              // monitor has several routes, the shortest one is its distance
+              std::vector<int32_t> distances (monitors.size (), 0);
+              BOOST_FOREACH (const Route &route, calculator.GetRoutes (originIndex))
+                {
+                  BOOST_FOREACH (const Ptr<const Name> &prefix, prefixes)
                     {
-                      NS_LOG_DEBUG (" prefix " << *prefix << " reachable via face " << *i->second.get<0> ()
-                                    << " with distance " << i->second.get<1> ()
-                                    << " with delay " << i->second.get<2> ());
-
-                      Ptr<fib::Entry> entry = fib->Add (prefix, i->second.get<0> (), i->second.get<1> ());
-                      entry->SetRealDelayToProducer (i->second.get<0> (), Seconds (i->second.get<2> ()));
-
-                      Ptr<Limits> faceLimits = i->second.get<0> ()->GetObject<Limits> ();
-
-                      Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
-                      if (fibLimits != 0)
-                        {
-                          // if it was created by the forwarding strategy via DidAddFibEntry event
-                          fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * i->second.get<2> () /*exact RTT*/);
-                          NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
-                                        2*i->second.get<2> () << "s (" << faceLimits->GetMaxRate () * 2 * i->second.get<2> () << ")");
-                        }
+                      InstallRoute (fibs[route.source], prefix, graph.GetEdgeFace (route.edge), route.cost, route.delay);
                     }
-		}
-	    }
-	}
+
+                  uint32_t monitor = monitorIndexes[route.source];
+                  if (monitor != fw::GlobalRoutingInfo::NO_MONITOR &&
+                      (distances[monitor] == 0 || static_cast<int32_t> (route.cost) < distances[monitor]))
+                    {
+                      distances[monitor] = route.cost;
+                    }
+                }
+              MergeMonitorDistances (graph, origin, distances);
+              continue;
+            }
+
+          const GlobalRoutingReverseTree &tree = state->trees[originIndex];
+          for (uint32_t source = 0; source < graph.GetNNodes (); source++)
+            {
+              if (source == origin || !tree.IsReachable (source))
+                continue;
+
+              BOOST_FOREACH (const Ptr<const Name> &prefix, prefixes)
+                {
+                  InstallRoute (fibs[source], prefix, graph.GetEdgeFace (tree.GetNextEdge (source)),
+                                tree.GetCost (source), tree.GetDelay (source));
+                }
+            }
+        }
+    }
+
+  // FIBs with all possible routes cannot be updated incrementally
+  if (allPossible)
+    {
+      ClearRoutingState ();
     }
+  else
+    {
+      UpdateMonitorDistances (*state);
+      g_routingState = state;
+      Simulator::ScheduleDestroy (&ClearRoutingState);
+    }
+
+  // tables precomputed from FIBs (e.g., MAR2 routing table) are no longer valid
+  fw::GlobalRoutingInfo::invalidate ();
+}
+
+void
+GlobalRoutingHelper::CalculateRoutes (bool invalidatedRoutes/* = true*/)
+{
+  CalculateAndInstallRoutes (invalidatedRoutes, false);
 }
 
 void
 GlobalRoutingHelper::CalculateAllPossibleRoutes (bool invalidatedRoutes/* = true*/)
 {
-  /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
-   */
+  // For every face of the node, the route is the shortest path that starts with the face
+  // and does not return to the node (see GlobalRoutingAlternativePaths)
+  CalculateAndInstallRoutes (invalidatedRoutes, true);
+}
 
-  BOOST_CONCEPT_ASSERT(( VertexListGraphConcept< NdnGlobalRouterGraph > ));
-  BOOST_CONCEPT_ASSERT(( IncidenceGraphConcept< NdnGlobalRouterGraph > ));
+void
+GlobalRoutingHelper::UpdateRoutes ()
+{
+  if (g_routingState == 0)
+    {
+      NS_LOG_DEBUG ("Routes have not been calculated by CalculateRoutes, nothing to update");
+      return;
+    }
 
-  NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  GlobalRoutingGraph &graph = g_routingState->graph;
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+  std::vector<uint32_t> changedEdges;
+  std::vector<uint32_t> oldMetrics;
+  graph.UpdateMetrics (changedEdges, oldMetrics);
+  if (changedEdges.empty ())
+    return;
+
+  NS_LOG_DEBUG ("Updating routes after " << changedEdges.size () << " edges changed");
+
+  // FIB entries (source, prefix) with changed routes and the faces of their old routes
+  typedef std::map< std::pair<uint32_t, Name>, std::set< Ptr<Face> > > ChangedEntries;
+  ChangedEntries changedEntries;
+
+  std::vector<GlobalRoutingReverseTree::Change> changes;
+  for (uint32_t originIndex = 0; originIndex < g_routingState->origins.size (); originIndex++)
     {
-      Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter> ();
-      if (source == 0)
-	{
-	  NS_LOG_DEBUG ("Node " << (*node)->GetId () << " does not export GlobalRouter interface");
-	  continue;
-	}
+      uint32_t origin = g_routingState->origins[originIndex];
+      GlobalRoutingReverseTree &tree = g_routingState->trees[originIndex];
 
-      Ptr<Fib>  fib  = source->GetObject<Fib> ();
-      if (invalidatedRoutes)
+      changes.clear ();
+      tree.Update (graph, changedEdges, oldMetrics, changes);
+
+      BOOST_FOREACH (const GlobalRoutingReverseTree::Change &change, changes)
         {
-          fib->InvalidateAll ();
+          uint32_t source = change.vertex;
+          if (source >= graph.GetNNodes () || source == origin)
+            continue;
+
+          uint32_t edge = tree.GetNextEdge (source);
+          if (edge == change.edge && tree.GetCost (source) == change.cost)
+            continue;
+
+          BOOST_FOREACH (const Ptr<const Name> &prefix, graph.GetRouter (origin)->GetLocalPrefixes ())
+            {
+              std::set< Ptr<Face> > &oldFaces = changedEntries[std::make_pair (source, *prefix)];
+              if (change.edge != GlobalRoutingGraph::INVALID)
+                oldFaces.insert (graph.GetEdgeFace (change.edge));
+            }
         }
-      NS_ASSERT (fib != 0);
+    }
+
+  // Other origins of the prefix may still route via the old faces, or via the same face at a lower
+  // cost, so next hops of a changed entry are rebuilt from the trees of all origins of its prefix
+  for (ChangedEntries::const_iterator changed = changedEntries.begin (); changed != changedEntries.end (); changed++)
+    {
+      uint32_t source = changed->first.first;
+      const RoutingState::PrefixOrigins &prefixOrigins = g_routingState->prefixes[changed->first.second];
 
-      NS_LOG_DEBUG ("===========");
-      NS_LOG_DEBUG ("Reachability from Node: " << source->GetObject<Node> ()->GetId () << " (" << Names::FindName (source->GetObject<Node> ()) << ")");
+      // cheapest route via every face (cost, delay)
+      std::map< Ptr<Face>, std::pair<uint32_t, double> > nextHops;
+      BOOST_FOREACH (uint32_t originIndex, prefixOrigins.origins)
+        {
+          const GlobalRoutingReverseTree &tree = g_routingState->trees[originIndex];
+          if (source == g_routingState->origins[originIndex] || !tree.IsReachable (source))
+            continue;
 
-      Ptr<L3Protocol> l3 = source->GetObject<L3Protocol> ();
-      NS_ASSERT (l3 != 0);
+          Ptr<Face> face = graph.GetEdgeFace (tree.GetNextEdge (source));
+          std::map< Ptr<Face>, std::pair<uint32_t, double> >::iterator hop = nextHops.find (face);
+          if (hop == nextHops.end () || tree.GetCost (source) < hop->second.first)
+            nextHops[face] = std::make_pair (tree.GetCost (source), tree.GetDelay (source));
+        }
 
-      // remember interface statuses
-      std::vector<uint16_t> originalMetric (l3->GetNFaces ());
-      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+      Ptr<Fib> fib = graph.GetRouter (source)->GetObject<Fib> ();
+      Ptr<fib::Entry> entry = fib->Find (*prefixOrigins.prefix);
+      if (entry != 0)
         {
-          originalMetric[faceId] = l3->GetFace (faceId)->GetMetric ();
-          l3->GetFace (faceId)->SetMetric (std::numeric_limits<uint16_t>::max ()-1); // value std::numeric_limits<uint16_t>::max () MUST NOT be used (reserved)
+          BOOST_FOREACH (const Ptr<Face> &face, changed->second)
+            {
+              if (nextHops.find (face) == nextHops.end ())
+                entry->RemoveFace (face);
+            }
+
+          // old face is removed, as FIB entry does not allow increasing the cost of a face
+          for (std::map< Ptr<Face>, std::pair<uint32_t, double> >::iterator hop = nextHops.begin ();
+               hop != nextHops.end (); hop++)
+            {
+              fib::FaceMetricContainer::type::index<fib::i_face>::type::iterator record =
+                entry->m_faces.get<fib::i_face> ().find (hop->first);
+              if (record != entry->m_faces.get<fib::i_face> ().end () &&
+                  static_cast<uint32_t> (record->GetRoutingCost ()) < hop->second.first)
+                entry->RemoveFace (hop->first);
+            }
+
+          if (nextHops.empty () && entry->m_faces.size () == 0)
+            fib->Remove (prefixOrigins.prefix);
         }
 
-      for (uint32_t enabledFaceId = 0; enabledFaceId < l3->GetNFaces (); enabledFaceId++)
+      for (std::map< Ptr<Face>, std::pair<uint32_t, double> >::iterator hop = nextHops.begin ();
+           hop != nextHops.end (); hop++)
         {
-          if (DynamicCast<ndn::NetDeviceFace> (l3->GetFace (enabledFaceId)) == 0)
-            continue;
+          InstallRoute (fib, prefixOrigins.prefix, hop->first, hop->second.first, hop->second.second);
+        }
+    }
 
-          // enabling only faceId
-          l3->GetFace (enabledFaceId)->SetMetric (originalMetric[enabledFaceId]);
+  UpdateMonitorDistances (*g_routingState);
+  fw::GlobalRoutingInfo::invalidate ();
+}
 
-          DistancesMap    distances;
+void
+GlobalRoutingHelper::CompressFibs (bool verify/* = false*/, bool aggregateUnrouted/* = false*/)
+{
+  uint32_t before = 0;
+  uint32_t after = 0;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      Ptr<Fib> fib = (*node)->GetObject<Fib> ();
+      if ((*node)->GetObject<GlobalRouter> () == 0 || fib == 0)
+        continue;
 
-          NS_LOG_DEBUG ("-----------");
+      before += fib->GetSize ();
 
-          dijkstra_shortest_paths (graph, source,
-                                   // predecessor_map (boost::ref(predecessors))
-                                   // .
-                                   distance_map (boost::ref(distances))
-                                   .
-                                   distance_inf (WeightInf)
-                                   .
-                                   distance_zero (WeightZero)
-                                   .
-                                   distance_compare (boost::WeightCompare ())
-                                   .
-                                   distance_combine (boost::WeightCombine ())
-                                   );
+      FibCompressor compressor (fib, aggregateUnrouted);
+      after += compressor.Compress ();
 
-          // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+      if (verify && !compressor.Verify ())
+        {
+          NS_FATAL_ERROR ("FIB compression changed next hops on node " << (*node)->GetId ());
+        }
+    }
 
-          for (DistancesMap::iterator i = distances.begin ();
-               i != distances.end ();
-               i++)
+  NS_LOG_INFO ("FIB compression: " << before << " entries before, " << after << " entries after");
+
+  // compressed FIBs cannot be updated incrementally
+  ClearRoutingState ();
+  Simulator::ScheduleDestroy (&ClearAggregatedEntries);
+
+  // tables precomputed from FIBs (e.g., MAR2 routing table) are no longer valid
+  fw::GlobalRoutingInfo::invalidate ();
+}
+
+void
+GlobalRoutingHelper::AddExactNamespace (const std::string &prefix)
+{
+  Name name (prefix);
+  if (std::find (g_exactNamespaces.begin (), g_exactNamespaces.end (), name) == g_exactNamespaces.end ())
+    g_exactNamespaces.push_back (name);
+}
+
+void
+GlobalRoutingHelper::ClearExactNamespaces ()
+{
+  g_exactNamespaces.clear ();
+}
+
+void
+GlobalRoutingHelper::CalculateBetweenness ()
+{
+  // Vertices are GlobalRouters of both nodes and (multi-access) channels, indexed by their internal IDs
+  std::vector< Ptr<GlobalRouter> > routers;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      Ptr<GlobalRouter> gr = (*node)->GetObject<GlobalRouter> ();
+      if (gr != 0)
+        routers.push_back (gr);
+    }
+  uint32_t nodeRouters = routers.size ();
+  for (ChannelList::Iterator channel = ChannelList::Begin (); channel != ChannelList::End (); channel++)
+    {
+      Ptr<GlobalRouter> gr = (*channel)->GetObject<GlobalRouter> ();
+      if (gr != 0)
+        routers.push_back (gr);
+    }
+
+  uint32_t maxId = 0;
+  BOOST_FOREACH (const Ptr<GlobalRouter> &gr, routers)
+    {
+      maxId = std::max (maxId, gr->GetId ());
+    }
+
+  uint32_t n = maxId + 1;
+  std::vector<double> centrality (n, 0.0);
+  std::vector<double> sigma (n);
+  std::vector<double> delta (n);
+  std::vector<int32_t> distance (n);
+  std::vector< std::vector<uint32_t> > predecessors (n);
+  std::vector< Ptr<GlobalRouter> > byId (n);
+  BOOST_FOREACH (const Ptr<GlobalRouter> &gr, routers)
+    {
+      byId[gr->GetId ()] = gr;
+    }
+
+  std::vector<uint32_t> order;   // vertices in non-decreasing distance from the source
+  order.reserve (n);
+
+  // Brandes' algorithm, sources are restricted to nodes (channels only relay)
+  for (uint32_t s = 0; s < nodeRouters; s++)
+    {
+      uint32_t source = routers[s]->GetId ();
+
+      std::fill (sigma.begin (), sigma.end (), 0.0);
+      std::fill (delta.begin (), delta.end (), 0.0);
+      std::fill (distance.begin (), distance.end (), -1);
+      BOOST_FOREACH (std::vector<uint32_t> &preds, predecessors)
+        {
+          preds.clear ();
+        }
+      order.clear ();
+
+      sigma[source] = 1.0;
+      distance[source] = 0;
+      order.push_back (source);
+
+      // order doubles as the BFS queue
+      for (uint32_t head = 0; head < order.size (); head++)
+        {
+          uint32_t v = order[head];
+          BOOST_FOREACH (const GlobalRouter::Incidency &edge, byId[v]->GetIncidencies ())
             {
-              if (i->first == source)
+              uint32_t w = edge.get<2> ()->GetId ();
+              if (w >= n || byId[w] == 0)
                 continue;
-              else
+
+              if (distance[w] < 0)
                 {
-                  // cout << "  Node " << i->first->GetObject<Node> ()->GetId ();
-                  if (i->second.get<0> () == 0)
-                    {
-                      // cout << " is unreachable" << endl;
-                    }
-                  else
-                    {
-                      BOOST_FOREACH (const Ptr<const Name> &prefix, i->first->GetLocalPrefixes ())
-                        {
-                          NS_LOG_DEBUG (" prefix " << *prefix << " reachable via face " << *i->second.get<0> ()
-                                        << " with distance " << i->second.get<1> ()
-                                        << " with delay " << i->second.get<2> ());
-
-                          if (i->second.get<0> ()->GetMetric () == std::numeric_limits<uint16_t>::max ()-1)
-                            continue;
-
-                          Ptr<fib::Entry> entry = fib->Add (prefix, i->second.get<0> (), i->second.get<1> ());
-                          entry->SetRealDelayToProducer (i->second.get<0> (), Seconds (i->second.get<2> ()));
-
-                          Ptr<Limits> faceLimits = i->second.get<0> ()->GetObject<Limits> ();
-
-                          Ptr<Limits> fibLimits = entry->GetObject<Limits> ();
-                          if (fibLimits != 0)
-                            {
-                              // if it was created by the forwarding strategy via DidAddFibEntry event
-                              fibLimits->SetLimits (faceLimits->GetMaxRate (), 2 * i->second.get<2> () /*exact RTT*/);
-                              NS_LOG_DEBUG ("Set limit for prefix " << *prefix << " " << faceLimits->GetMaxRate () << " / " <<
-                                            2*i->second.get<2> () << "s (" << faceLimits->GetMaxRate () * 2 * i->second.get<2> () << ")");
-                            }
-                        }
-                    }
+                  distance[w] = distance[v] + 1;
+                  order.push_back (w);
+                }
+              if (distance[w] == distance[v] + 1)
+                {
+                  sigma[w] += sigma[v];
+                  predecessors[w].push_back (v);
                 }
             }
-
-          // disabling the face again
-          l3->GetFace (enabledFaceId)->SetMetric (std::numeric_limits<uint16_t>::max ()-1);
         }
 
-      // recover original interface statuses
-      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+      for (std::vector<uint32_t>::reverse_iterator w = order.rbegin (); w != order.rend (); w++)
         {
-          l3->GetFace (faceId)->SetMetric (originalMetric[faceId]);
+          BOOST_FOREACH (uint32_t v, predecessors[*w])
+            {
+              delta[v] += sigma[v] / sigma[*w] * (1.0 + delta[*w]);
+            }
+          if (*w != source)
+            centrality[*w] += delta[*w];
         }
     }
+
+  for (uint32_t s = 0; s < nodeRouters; s++)
+    {
+      NS_LOG_DEBUG ("Node " << routers[s]->GetObject<Node> ()->GetId ()
+                    << " betweenness " << centrality[routers[s]->GetId ()]);
+      routers[s]->SetBetweenness (centrality[routers[s]->GetId ()]);
+    }
 }
 
 
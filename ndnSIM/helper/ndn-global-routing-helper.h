@@ -98,26 +98,115 @@ public:
   /**
    * @brief Calculate for every node shortest path trees and install routes to all prefix origins
    *
+   * Faces that are down are not used.  Calculated shortest path trees are kept for UpdateRoutes.
+   *
    * @param invalidatedRoutes flag indicating whether existing routes should be invalidated or keps as is
    */
   static void
   CalculateRoutes (bool invalidatedRoutes = true);
 
+  /**
+   * @brief Update routes calculated by CalculateRoutes after face metrics or statuses have changed
+   *
+   * Only shortest paths affected by the change are recalculated.  Next hops of every affected FIB entry are
+   * rebuilt from shortest paths to all origins of the prefix, so a face is kept (at its lowest cost) as long as
+   * any origin is still reached through it.  The topology itself (set of nodes, channels, and faces) must not change.
+   *
+   * The method is called by LinkControlHelper::FailLink and LinkControlHelper::UpLink.  It does nothing if routes
+   * have not been calculated by CalculateRoutes (e.g., when CalculateAllPossibleRoutes has been used) or FIBs
+   * have been compressed by CompressFibs since.
+   *
+   * Like route calculation, a change invalidates tables precomputed from FIBs via fw::GlobalRoutingInfo
+   * (e.g., MAR2 routing table of fw::MonitorAwareRouting).
+   */
+  static void
+  UpdateRoutes ();
+
   /**
    * @brief Calculate all possible next-hop independent alternative routes
    *
    * @param invalidatedRoutes flag indicating whether existing routes should be invalidated or keps as is
    *
-   * Refer to the implementation for more details.
-   *
-   * Note that this method is highly experimental and should be used with caution (very time consuming).
+   * For every face of every node, the installed route is the shortest path that starts with the face and
+   * does not return to the node.  Routes are derived from one reverse shortest path tree per prefix origin
+   * (see GlobalRoutingAlternativePaths).
    */
   static void
   CalculateAllPossibleRoutes (bool invalidatedRoutes = true);
 
+  /**
+   * @brief Aggregate FIB entries of all nodes with GlobalRouter (optional step after route calculation)
+   *
+   * ORTC-style aggregation on the name tree of every FIB: entries whose next hops (faces, costs, statuses,
+   * and delays) are the same as of the closest ancestor entry are removed.  Every name under an original
+   * prefix resolves to the same next hops as before, and names that did not match any FIB entry still
+   * match none.  Entries under namespaces added by AddExactNamespace are always kept.
+   *
+   * With aggregateUnrouted, siblings with the same next hops are also collapsed into a new entry for
+   * their common parent, even if no original entry covers the parent.  Names that did not match any FIB
+   * entry may then match an aggregated entry (e.g., Interests of attackers for unserved prefixes would be
+   * forwarded instead of being dropped).
+   *
+   * Aggregated entries are removed by the next CalculateRoutes or CalculateAllPossibleRoutes.
+   * Compressed FIBs are not updated by UpdateRoutes.  Other code that looks up FIB entries of particular
+   * prefixes with Fib::Find (instead of Fib::LongestPrefixMatch) may not find them after compression.
+   *
+   * @param verify check that every original prefix (and a name under it) resolves to the same next hops,
+   *               and (unless aggregateUnrouted) that names outside them resolve to no entry, fatal error otherwise
+   * @param aggregateUnrouted allow new entries that cover names without a route
+   */
+  static void
+  CompressFibs (bool verify = false, bool aggregateUnrouted = false);
+
+  /**
+   * @brief Exempt entries under `prefix' from FIB compression
+   *
+   * Entries of prefixes that are looked up by exact name (Fib::Find instead of Fib::LongestPrefixMatch),
+   * e.g., /monitor and /cc of monitor-aware routing, must not be aggregated by CompressFibs.
+   *
+   * @param prefix namespace whose entries are kept, e.g., "/monitor"
+   */
+  static void
+  AddExactNamespace (const std::string &prefix);
+
+  /**
+   * @brief Remove all namespaces added by AddExactNamespace
+   */
+  static void
+  ClearExactNamespaces ();
+
+  /**
+   * @brief Calculate betweenness centrality of every node and store it in the node's GlobalRouter
+   *
+   * Uses Brandes' algorithm over hop-count shortest paths between all pairs of nodes.
+   * The resulting value is used, for example, by the betweenness caching decision of forwarding strategies.
+   */
+  static void
+  CalculateBetweenness ();
+
+  /**
+   * @brief Set number of threads used to calculate routes
+   *
+   * Routes towards different prefix origins are calculated in parallel on a snapshot of the
+   * topology, while FIBs are updated from the calling thread.
+   *
+   * @param threads number of threads (0 to use all available cores, default 1)
+   */
+  static void
+  SetThreads (uint32_t threads);
+
+  /**
+   * @brief Get number of threads used to calculate routes
+   */
+  static uint32_t
+  GetThreads ();
+
 private:
   void
   Install (Ptr<Channel> channel);
+
+private:
+  static uint32_t m_threads;
 };
 
 } // namespace ndn
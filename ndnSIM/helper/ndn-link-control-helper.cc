@@ -20,6 +20,7 @@
  */
 
 #include "ndn-link-control-helper.h"
+#include "ndn-global-routing-helper.h"
 
 #include "ns3/assert.h"
 #include "ns3/names.h"
@@ -75,6 +76,9 @@ LinkControlHelper::FailLink (Ptr<Node> node1, Ptr<Node> node2)
 
           face1->SetUp (false);
           face2->SetUp (false);
+
+          // patch routes, if they were calculated by GlobalRoutingHelper
+          GlobalRoutingHelper::UpdateRoutes ();
           break;
         }
     }
@@ -124,6 +128,9 @@ LinkControlHelper::UpLink (Ptr<Node> node1, Ptr<Node> node2)
 
           face1->SetUp (true);
           face2->SetUp (true);
+
+          // patch routes, if they were calculated by GlobalRoutingHelper
+          GlobalRoutingHelper::UpdateRoutes ();
           break;
         }
     }
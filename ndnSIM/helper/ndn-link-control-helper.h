@@ -43,6 +43,9 @@ public:
    *
    * Note that only PointToPointChannels are supported by this helper method
    *
+   * If routes have been calculated by GlobalRoutingHelper::CalculateRoutes, affected FIB entries
+   * are updated (see GlobalRoutingHelper::UpdateRoutes)
+   *
    * @param node1 one node
    * @param node2 another node
    */
@@ -73,6 +76,9 @@ public:
    *
    * Note that only PointToPointChannels are supported by this helper method
    *
+   * If routes have been calculated by GlobalRoutingHelper::CalculateRoutes, affected FIB entries
+   * are updated (see GlobalRoutingHelper::UpdateRoutes)
+   *
    * @param node1 one node
    * @param node2 another node
    */
@@ -32,6 +32,7 @@
 #include "ns3/string.h"
 
 #include "../../utils/trie/trie-with-policy.h"
+#include "custom-policies/exact-match-index-policy.h"
 
 namespace ns3 {
 namespace ndn {
@@ -77,12 +78,12 @@ template<class Policy>
 class ContentStoreImpl : public ContentStore,
                          protected ndnSIM::trie_with_policy< Name,
                                                              ndnSIM::smart_pointer_payload_traits< EntryImpl< ContentStoreImpl< Policy > >, Entry >,
-                                                             Policy >
+                                                             ndnSIM::exact_match_index_policy_traits< Policy > >
 {
 public:
   typedef ndnSIM::trie_with_policy< Name,
                                     ndnSIM::smart_pointer_payload_traits< EntryImpl< ContentStoreImpl< Policy > >, Entry >,
-                                    Policy > super;
+                                    ndnSIM::exact_match_index_policy_traits< Policy > > super;
 
   typedef EntryImpl< ContentStoreImpl< Policy > > entry;
 
@@ -123,7 +124,17 @@ public:
 
   typename super::policy_container &
   GetPolicy () { return super::getPolicy (); }
-  
+
+protected:
+  /**
+   * @brief Find cache entry that can satisfy the Interest
+   *
+   * Does not fire cache hit/miss traces.  Can be overridden by specialized content
+   * stores to filter out unsuitable entries (e.g., stale ones)
+   */
+  virtual inline typename super::iterator
+  FindMatchingEntry (Ptr<const Interest> interest);
+
 private:
   void
   SetMaxSize (uint32_t maxSize);
@@ -188,21 +199,35 @@ private:
 };
 
 template<class Policy>
-Ptr<Data>
-ContentStoreImpl<Policy>::Lookup (Ptr<const Interest> interest)
+typename ContentStoreImpl<Policy>::super::iterator
+ContentStoreImpl<Policy>::FindMatchingEntry (Ptr<const Interest> interest)
 {
-  NS_LOG_FUNCTION (this << interest->GetName ());
-
-  typename super::const_iterator node;
   if (interest->GetExclude () == 0)
     {
-      node = this->deepest_prefix_match (interest->GetName ());
+      // fast path: most Interests request exact names
+      typename super::iterator node = this->getPolicy ().find_exact (interest->GetName ());
+      if (node != this->end ())
+        {
+          this->getPolicy ().lookup (node);
+          return node;
+        }
+
+      return this->deepest_prefix_match (interest->GetName ());
     }
   else
     {
-      node = this->deepest_prefix_match_if_next_level (interest->GetName (),
+      return this->deepest_prefix_match_if_next_level (interest->GetName (),
                                                        isNotExcluded (*interest->GetExclude ()));
     }
+}
+
+template<class Policy>
+Ptr<Data>
+ContentStoreImpl<Policy>::Lookup (Ptr<const Interest> interest)
+{
+  NS_LOG_FUNCTION (this << interest->GetName ());
+
+  typename super::const_iterator node = FindMatchingEntry (interest);
 
   if (node != this->end ())
     {
@@ -0,0 +1,79 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "content-store-sharded.h"
+
+#include "../../utils/trie/random-policy.h"
+#include "../../utils/trie/lru-policy.h"
+#include "../../utils/trie/fifo-policy.h"
+#include "../../utils/trie/lfu-policy.h"
+
+#define NS_OBJECT_ENSURE_REGISTERED_TEMPL(type, templ)  \
+  static struct X ## type ## templ ## RegistrationClass \
+  {                                                     \
+    X ## type ## templ ## RegistrationClass () {        \
+      ns3::TypeId tid = type<templ>::GetTypeId ();      \
+      tid.GetParent ();                                 \
+    }                                                   \
+  } x_ ## type ## templ ## RegistrationVariable
+
+namespace ns3 {
+namespace ndn {
+
+using namespace ndnSIM;
+
+namespace cs {
+
+// explicit instantiation and registering
+/**
+ * @brief Sharded ContentStore with LRU cache replacement policy in each shard
+ **/
+template class ContentStoreSharded<lru_policy_traits>;
+
+/**
+ * @brief Sharded ContentStore with random cache replacement policy in each shard
+ **/
+template class ContentStoreSharded<random_policy_traits>;
+
+/**
+ * @brief Sharded ContentStore with FIFO cache replacement policy in each shard
+ **/
+template class ContentStoreSharded<fifo_policy_traits>;
+
+/**
+ * @brief Sharded ContentStore with Least Frequently Used (LFU) cache replacement policy in each shard
+ **/
+template class ContentStoreSharded<lfu_policy_traits>;
+
+
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreSharded, lru_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreSharded, random_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreSharded, fifo_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreSharded, lfu_policy_traits);
+
+#ifdef DOXYGEN
+/**
+ * \brief Sharded Content Store implementing LRU cache replacement policy in each shard
+ */
+class Sharded::Lru : public ContentStoreSharded<lru_policy_traits> { };
+
+/**
+ * \brief Sharded Content Store implementing FIFO cache replacement policy in each shard
+ */
+class Sharded::Fifo : public ContentStoreSharded<fifo_policy_traits> { };
+
+/**
+ * \brief Sharded Content Store implementing Random cache replacement policy in each shard
+ */
+class Sharded::Random : public ContentStoreSharded<random_policy_traits> { };
+
+/**
+ * \brief Sharded Content Store implementing Least Frequently Used cache replacement policy in each shard
+ */
+class Sharded::Lfu : public ContentStoreSharded<lfu_policy_traits> { };
+
+#endif
+
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
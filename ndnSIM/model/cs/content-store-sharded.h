@@ -0,0 +1,464 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_CONTENT_STORE_SHARDED_H_
+#define NDN_CONTENT_STORE_SHARDED_H_
+
+#include "content-store-impl.h"
+
+#include "ns3/system-mutex.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+/**
+ * @ingroup ndn-cs
+ * @brief Content store partitioned into independently locked shards
+ *
+ * Name space is partitioned by hash of the first ShardingDepth name components.  Each shard
+ * is a separate ContentStoreImpl<Policy> with its own policy instance and an equal share of
+ * MaxSize, protected by its own mutex, so operations on different shards can proceed in
+ * parallel (e.g., when faces are driven from different threads in real-time emulation).
+ *
+ * Interests with names shorter than ShardingDepth may match Data in any shard, so all shards
+ * are checked for them (one at a time).
+ *
+ * Shards and ShardingDepth can be changed only while the content store is empty, as both
+ * decide which shard a name belongs to.  If MaxSize is smaller than Shards, only MaxSize shards
+ * (of one entry each) are used, so such a MaxSize can also be set only while the content store
+ * is empty.
+ *
+ * Note that shard locks protect only the shard data structures.  Data returned from Lookup
+ * shares the packet buffer with the cached copy, and NS-3 packets themselves are not
+ * thread-safe.
+ */
+template<class Policy>
+class ContentStoreSharded : public ContentStore
+{
+public:
+  typedef ContentStoreImpl<Policy> shard_type;
+
+  static TypeId
+  GetTypeId ();
+
+  ContentStoreSharded ();
+  virtual ~ContentStoreSharded () { };
+
+  // from ContentStore
+
+  virtual inline Ptr<Data>
+  Lookup (Ptr<const Interest> interest);
+
+  virtual inline bool
+  Add (Ptr<const Data> data);
+
+  virtual inline void
+  Print (std::ostream &os) const;
+
+  virtual uint32_t
+  GetSize () const;
+
+  virtual Ptr<Entry>
+  Begin ();
+
+  virtual Ptr<Entry>
+  End ();
+
+  virtual Ptr<Entry>
+  Next (Ptr<Entry>);
+
+  /**
+   * @brief Get index of the shard that is responsible for the name
+   */
+  uint32_t
+  GetShardIndex (const Name &name) const;
+
+  /**
+   * @brief Get number of shards
+   */
+  uint32_t
+  GetNShards () const;
+
+  /**
+   * @brief Get shard with the specified index
+   */
+  Ptr<shard_type>
+  GetShard (uint32_t index) const;
+
+protected:
+  virtual void
+  DoDispose ();
+
+private:
+  void
+  SetNShards (uint32_t shards);
+
+  void
+  SetMaxSize (uint32_t maxSize);
+
+  uint32_t
+  GetMaxSize () const;
+
+  void
+  SetShardingDepth (uint32_t depth);
+
+  uint32_t
+  GetShardingDepth () const;
+
+  uint32_t
+  GetConfiguredNShards () const;
+
+  void
+  CreateShards ();
+
+  void
+  UpdateShardSizes ();
+
+  Ptr<Entry>
+  BeginFrom (uint32_t index);
+
+  void
+  DidAddEntry (Ptr<const Entry> entry);
+
+private:
+  static LogComponent g_log; ///< @brief Logging variable
+
+  std::vector< Ptr<shard_type> > m_shards;
+  std::vector< boost::shared_ptr<SystemMutex> > m_locks;
+
+  uint32_t m_maxSize;
+  uint32_t m_nShards; ///< @brief Configured number of shards (at most m_maxSize are used)
+  uint32_t m_shardingDepth;
+
+  /// @brief trace of for entry additions (fired every time entry is successfully added to the cache): first parameter is pointer to the CS entry
+  TracedCallback< Ptr<const Entry> > m_didAddEntry;
+};
+
+//////////////////////////////////////////
+////////// Implementation ////////////////
+//////////////////////////////////////////
+
+
+template<class Policy>
+LogComponent
+ContentStoreSharded< Policy >::g_log = LogComponent (("ndn.cs.Sharded." + Policy::GetName ()).c_str ());
+
+
+template<class Policy>
+TypeId
+ContentStoreSharded< Policy >::GetTypeId ()
+{
+  static TypeId tid = TypeId (("ns3::ndn::cs::Sharded::"+Policy::GetName ()).c_str ())
+    .SetGroupName ("Ndn")
+    .SetParent<ContentStore> ()
+    .template AddConstructor< ContentStoreSharded< Policy > > ()
+
+    .AddAttribute ("MaxSize",
+                   "Set maximum number of entries in ContentStore (split equally between shards). If 0, limit is not enforced",
+                   StringValue ("100"),
+                   MakeUintegerAccessor (&ContentStoreSharded< Policy >::GetMaxSize,
+                                         &ContentStoreSharded< Policy >::SetMaxSize),
+                   MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("Shards",
+                   "Number of independently locked shards (at most MaxSize)",
+                   StringValue ("8"),
+                   MakeUintegerAccessor (&ContentStoreSharded< Policy >::GetConfiguredNShards,
+                                         &ContentStoreSharded< Policy >::SetNShards),
+                   MakeUintegerChecker<uint32_t> (1))
+
+    .AddAttribute ("ShardingDepth",
+                   "Number of first name components used to select a shard",
+                   StringValue ("1"),
+                   MakeUintegerAccessor (&ContentStoreSharded< Policy >::GetShardingDepth,
+                                         &ContentStoreSharded< Policy >::SetShardingDepth),
+                   MakeUintegerChecker<uint32_t> (1))
+
+    .AddTraceSource ("DidAddEntry", "Trace fired every time entry is successfully added to the cache",
+                     MakeTraceSourceAccessor (&ContentStoreSharded< Policy >::m_didAddEntry))
+    ;
+
+  return tid;
+}
+
+template<class Policy>
+ContentStoreSharded< Policy >::ContentStoreSharded ()
+  : m_maxSize (100)
+  , m_nShards (8)
+  , m_shardingDepth (1)
+{
+  CreateShards ();
+}
+
+template<class Policy>
+void
+ContentStoreSharded< Policy >::DoDispose ()
+{
+  m_shards.clear ();
+  m_locks.clear ();
+
+  ContentStore::DoDispose ();
+}
+
+template<class Policy>
+uint32_t
+ContentStoreSharded< Policy >::GetShardIndex (const Name &name) const
+{
+  std::size_t seed = 0;
+
+  uint32_t depth = 0;
+  for (Name::const_iterator comp = name.begin ();
+       comp != name.end () && depth < m_shardingDepth;
+       comp++, depth++)
+    {
+      boost::hash_range (seed, comp->begin (), comp->end ());
+    }
+
+  return seed % m_shards.size ();
+}
+
+template<class Policy>
+Ptr<Data>
+ContentStoreSharded< Policy >::Lookup (Ptr<const Interest> interest)
+{
+  NS_LOG_FUNCTION (this << interest->GetName ());
+
+  Ptr<Data> data;
+  if (interest->GetName ().size () >= m_shardingDepth)
+    {
+      uint32_t index = GetShardIndex (interest->GetName ());
+
+      CriticalSection lock (*m_locks[index]);
+      data = m_shards[index]->Lookup (interest);
+    }
+  else
+    {
+      // anything in any shard can match
+      for (uint32_t index = 0; index < m_shards.size () && data == 0; index++)
+        {
+          CriticalSection lock (*m_locks[index]);
+          data = m_shards[index]->Lookup (interest);
+        }
+    }
+
+  if (data != 0)
+    {
+      this->m_cacheHitsTrace (interest, data);
+    }
+  else
+    {
+      this->m_cacheMissesTrace (interest);
+    }
+  return data;
+}
+
+template<class Policy>
+bool
+ContentStoreSharded< Policy >::Add (Ptr<const Data> data)
+{
+  NS_LOG_FUNCTION (this << data->GetName ());
+
+  uint32_t index = GetShardIndex (data->GetName ());
+
+  CriticalSection lock (*m_locks[index]);
+  return m_shards[index]->Add (data);
+}
+
+template<class Policy>
+void
+ContentStoreSharded< Policy >::Print (std::ostream &os) const
+{
+  for (uint32_t index = 0; index < m_shards.size (); index++)
+    {
+      CriticalSection lock (*m_locks[index]);
+      m_shards[index]->Print (os);
+    }
+}
+
+template<class Policy>
+uint32_t
+ContentStoreSharded< Policy >::GetSize () const
+{
+  uint32_t size = 0;
+  for (uint32_t index = 0; index < m_shards.size (); index++)
+    {
+      CriticalSection lock (*m_locks[index]);
+      size += m_shards[index]->GetSize ();
+    }
+  return size;
+}
+
+template<class Policy>
+Ptr<Entry>
+ContentStoreSharded< Policy >::Begin ()
+{
+  return BeginFrom (0);
+}
+
+template<class Policy>
+Ptr<Entry>
+ContentStoreSharded< Policy >::End ()
+{
+  return 0;
+}
+
+template<class Policy>
+Ptr<Entry>
+ContentStoreSharded< Policy >::Next (Ptr<Entry> from)
+{
+  if (from == 0) return 0;
+
+  uint32_t index = GetShardIndex (from->GetName ());
+
+  Ptr<Entry> next;
+  {
+    CriticalSection lock (*m_locks[index]);
+    next = m_shards[index]->Next (from);
+  }
+
+  if (next != 0)
+    return next;
+  else
+    return BeginFrom (index + 1);
+}
+
+template<class Policy>
+Ptr<Entry>
+ContentStoreSharded< Policy >::BeginFrom (uint32_t index)
+{
+  for (; index < m_shards.size (); index++)
+    {
+      CriticalSection lock (*m_locks[index]);
+      Ptr<Entry> entry = m_shards[index]->Begin ();
+      if (entry != 0)
+        return entry;
+    }
+
+  return End ();
+}
+
+template<class Policy>
+uint32_t
+ContentStoreSharded< Policy >::GetNShards () const
+{
+  return m_shards.size ();
+}
+
+template<class Policy>
+Ptr<typename ContentStoreSharded< Policy >::shard_type>
+ContentStoreSharded< Policy >::GetShard (uint32_t index) const
+{
+  return m_shards.at (index);
+}
+
+template<class Policy>
+void
+ContentStoreSharded< Policy >::SetNShards (uint32_t shards)
+{
+  NS_ASSERT (shards > 0);
+  m_nShards = shards;
+  CreateShards ();
+}
+
+template<class Policy>
+uint32_t
+ContentStoreSharded< Policy >::GetConfiguredNShards () const
+{
+  return m_nShards;
+}
+
+template<class Policy>
+void
+ContentStoreSharded< Policy >::SetMaxSize (uint32_t maxSize)
+{
+  m_maxSize = maxSize;
+  CreateShards ();
+}
+
+template<class Policy>
+uint32_t
+ContentStoreSharded< Policy >::GetMaxSize () const
+{
+  return m_maxSize;
+}
+
+template<class Policy>
+void
+ContentStoreSharded< Policy >::SetShardingDepth (uint32_t depth)
+{
+  NS_ASSERT (depth > 0);
+  if (depth == m_shardingDepth)
+    return;
+
+  // cached Data would be looked up in a different shard than it has been added to
+  NS_ASSERT_MSG (GetSize () == 0, "Sharding depth can be changed only when content store is empty");
+
+  m_shardingDepth = depth;
+}
+
+template<class Policy>
+uint32_t
+ContentStoreSharded< Policy >::GetShardingDepth () const
+{
+  return m_shardingDepth;
+}
+
+template<class Policy>
+void
+ContentStoreSharded< Policy >::CreateShards ()
+{
+  // Every shard needs at least one entry (0 would mean no limit)
+  uint32_t shards = m_maxSize != 0 ? std::min (m_nShards, m_maxSize) : m_nShards;
+  if (shards != m_shards.size ())
+    {
+      NS_ASSERT_MSG (GetSize () == 0, "Number of shards can be changed only when content store is empty");
+
+      m_shards.clear ();
+      m_locks.clear ();
+      for (uint32_t index = 0; index < shards; index++)
+        {
+          Ptr<shard_type> shard = CreateObject<shard_type> ();
+          shard->TraceConnectWithoutContext ("DidAddEntry", MakeCallback (&ContentStoreSharded< Policy >::DidAddEntry, this));
+
+          m_shards.push_back (shard);
+          m_locks.push_back (boost::make_shared<SystemMutex> ());
+        }
+    }
+
+  UpdateShardSizes ();
+}
+
+template<class Policy>
+void
+ContentStoreSharded< Policy >::UpdateShardSizes ()
+{
+  uint32_t share = m_maxSize / m_shards.size ();
+  uint32_t remainder = m_maxSize % m_shards.size ();
+
+  for (uint32_t index = 0; index < m_shards.size (); index++)
+    {
+      uint32_t size = share + (index < remainder ? 1 : 0);
+
+      CriticalSection lock (*m_locks[index]);
+      m_shards[index]->SetAttribute ("MaxSize", UintegerValue (size));
+    }
+}
+
+template<class Policy>
+void
+ContentStoreSharded< Policy >::DidAddEntry (Ptr<const Entry> entry)
+{
+  m_didAddEntry (entry);
+}
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_CONTENT_STORE_SHARDED_H_
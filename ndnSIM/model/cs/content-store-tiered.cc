@@ -0,0 +1,79 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "content-store-tiered.h"
+
+#include "../../utils/trie/random-policy.h"
+#include "../../utils/trie/lru-policy.h"
+#include "../../utils/trie/fifo-policy.h"
+#include "../../utils/trie/lfu-policy.h"
+
+#define NS_OBJECT_ENSURE_REGISTERED_TEMPL(type, templ)  \
+  static struct X ## type ## templ ## RegistrationClass \
+  {                                                     \
+    X ## type ## templ ## RegistrationClass () {        \
+      ns3::TypeId tid = type<templ>::GetTypeId ();      \
+      tid.GetParent ();                                 \
+    }                                                   \
+  } x_ ## type ## templ ## RegistrationVariable
+
+namespace ns3 {
+namespace ndn {
+
+using namespace ndnSIM;
+
+namespace cs {
+
+// explicit instantiation and registering
+/**
+ * @brief Tiered ContentStore with LRU cache replacement policy in the hot tier
+ **/
+template class ContentStoreTiered<lru_policy_traits>;
+
+/**
+ * @brief Tiered ContentStore with random cache replacement policy in the hot tier
+ **/
+template class ContentStoreTiered<random_policy_traits>;
+
+/**
+ * @brief Tiered ContentStore with FIFO cache replacement policy in the hot tier
+ **/
+template class ContentStoreTiered<fifo_policy_traits>;
+
+/**
+ * @brief Tiered ContentStore with Least Frequently Used (LFU) cache replacement policy in the hot tier
+ **/
+template class ContentStoreTiered<lfu_policy_traits>;
+
+
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreTiered, lru_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreTiered, random_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreTiered, fifo_policy_traits);
+NS_OBJECT_ENSURE_REGISTERED_TEMPL(ContentStoreTiered, lfu_policy_traits);
+
+#ifdef DOXYGEN
+/**
+ * \brief Tiered Content Store implementing LRU cache replacement policy in the hot tier
+ */
+class Tiered::Lru : public ContentStoreTiered<lru_policy_traits> { };
+
+/**
+ * \brief Tiered Content Store implementing FIFO cache replacement policy in the hot tier
+ */
+class Tiered::Fifo : public ContentStoreTiered<fifo_policy_traits> { };
+
+/**
+ * \brief Tiered Content Store implementing Random cache replacement policy in the hot tier
+ */
+class Tiered::Random : public ContentStoreTiered<random_policy_traits> { };
+
+/**
+ * \brief Tiered Content Store implementing Least Frequently Used cache replacement policy in the hot tier
+ */
+class Tiered::Lfu : public ContentStoreTiered<lfu_policy_traits> { };
+
+#endif
+
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,248 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_CONTENT_STORE_TIERED_H_
+#define NDN_CONTENT_STORE_TIERED_H_
+
+#include "content-store-impl.h"
+#include "mapped-data-log.h"
+
+#include "../../utils/trie/multi-policy.h"
+#include "custom-policies/lifetime-stats-policy.h"
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+/**
+ * @ingroup ndn-cs
+ * @brief Two-tier content store: policy-driven in-memory (hot) tier backed by a memory-mapped (cold) tier
+ *
+ * Entries evicted from the hot tier are written in wire format to MappedDataLog, which
+ * keeps only a small index in memory.  On a cold tier hit, Data is moved back to the hot
+ * tier.  Like the hot tier, the cold tier is matched by the exact Interest name or else by
+ * any Data under the Interest name, but only for Interests without Exclude filter.
+ *
+ * MaxSize sets capacity of the hot tier, GetSize and Begin/Next cover only the hot tier.
+ */
+template<class Policy>
+class ContentStoreTiered :
+    public ContentStoreImpl< ndnSIM::multi_policy_traits< boost::mpl::vector2< Policy, ndnSIM::lifetime_stats_policy_traits > > >
+{
+public:
+  typedef ContentStoreImpl< ndnSIM::multi_policy_traits< boost::mpl::vector2< Policy, ndnSIM::lifetime_stats_policy_traits > > > super;
+
+  ContentStoreTiered ();
+
+  static TypeId
+  GetTypeId ();
+
+  virtual inline Ptr<Data>
+  Lookup (Ptr<const Interest> interest);
+
+  virtual inline bool
+  Add (Ptr<const Data> data);
+
+  virtual inline void
+  Print (std::ostream &os) const;
+
+  /**
+   * @brief Get number of entries in the cold tier
+   */
+  uint32_t
+  GetColdSize () const;
+
+protected:
+  virtual void
+  DoDispose ();
+
+private:
+  void
+  WillEvictEntry (Ptr<const Entry> entry, Time lifetime);
+
+  void
+  SetColdMaxSize (uint32_t maxSize);
+
+  uint32_t
+  GetColdMaxSize () const;
+
+private:
+  static LogComponent g_log; ///< @brief Logging variable
+
+  MappedDataLog m_cold;
+  std::string m_coldFileName;
+  uint64_t m_coldMaxBytes;
+
+  TracedCallback< Ptr<const Entry>, Time > m_willEvictEntry;
+
+  TracedCallback< Ptr<const Interest>, Ptr<const Data> > m_hotHitsTrace;  ///< @brief trace of hits in the hot tier
+  TracedCallback< Ptr<const Interest>, Ptr<const Data> > m_coldHitsTrace; ///< @brief trace of hits in the cold tier
+};
+
+//////////////////////////////////////////
+////////// Implementation ////////////////
+//////////////////////////////////////////
+
+
+template<class Policy>
+LogComponent
+ContentStoreTiered< Policy >::g_log = LogComponent (("ndn.cs.Tiered." + Policy::GetName ()).c_str ());
+
+
+template<class Policy>
+TypeId
+ContentStoreTiered< Policy >::GetTypeId ()
+{
+  static TypeId tid = TypeId (("ns3::ndn::cs::Tiered::"+Policy::GetName ()).c_str ())
+    .SetGroupName ("Ndn")
+    .SetParent<super> ()
+    .template AddConstructor< ContentStoreTiered< Policy > > ()
+
+    .AddAttribute ("ColdMaxSize",
+                   "Set maximum number of entries in the cold tier. If 0, limited only by ColdMaxBytes",
+                   StringValue ("0"),
+                   MakeUintegerAccessor (&ContentStoreTiered< Policy >::GetColdMaxSize,
+                                         &ContentStoreTiered< Policy >::SetColdMaxSize),
+                   MakeUintegerChecker<uint32_t> ())
+
+    .AddAttribute ("ColdMaxBytes",
+                   "Size of the memory-mapped log used by the cold tier (in bytes)",
+                   StringValue ("67108864"),
+                   MakeUintegerAccessor (&ContentStoreTiered< Policy >::m_coldMaxBytes),
+                   MakeUintegerChecker<uint64_t> (1))
+
+    .AddAttribute ("ColdFileName",
+                   "File for the cold tier log. If empty, anonymous temporary file is used "
+                   "(each content store needs a separate file)",
+                   StringValue (""),
+                   MakeStringAccessor (&ContentStoreTiered< Policy >::m_coldFileName),
+                   MakeStringChecker ())
+
+    .AddTraceSource ("HotHits", "Trace called every time there is a hit in the hot (in-memory) tier",
+                     MakeTraceSourceAccessor (&ContentStoreTiered< Policy >::m_hotHitsTrace))
+    .AddTraceSource ("ColdHits", "Trace called every time there is a hit in the cold (memory-mapped) tier",
+                     MakeTraceSourceAccessor (&ContentStoreTiered< Policy >::m_coldHitsTrace))
+    ;
+
+  return tid;
+}
+
+template<class Policy>
+ContentStoreTiered< Policy >::ContentStoreTiered ()
+  : m_coldMaxBytes (67108864)
+{
+  // get notified about everything that hot tier evicts
+  super::getPolicy ().template get<1> ().set_traced_callback (&m_willEvictEntry);
+  m_willEvictEntry.ConnectWithoutContext (MakeCallback (&ContentStoreTiered< Policy >::WillEvictEntry, this));
+}
+
+template<class Policy>
+void
+ContentStoreTiered< Policy >::DoDispose ()
+{
+  m_cold.Close ();
+
+  super::DoDispose ();
+}
+
+template<class Policy>
+Ptr<Data>
+ContentStoreTiered< Policy >::Lookup (Ptr<const Interest> interest)
+{
+  NS_LOG_FUNCTION (this << interest->GetName ());
+
+  typename super::super::const_iterator node = this->FindMatchingEntry (interest);
+  if (node != this->end ())
+    {
+      this->m_hotHitsTrace (interest, node->payload ()->GetData ());
+      this->m_cacheHitsTrace (interest, node->payload ()->GetData ());
+
+      Ptr<Data> copy = Create<Data> (*node->payload ()->GetData ());
+      ConstCast<Packet> (copy->GetPayload ())->RemoveAllPacketTags ();
+      return copy;
+    }
+
+  if (interest->GetExclude () == 0 && m_cold.GetSize () > 0)
+    {
+      Ptr<Data> data = m_cold.ExtractMatching (interest->GetName ());
+      if (data != 0)
+        {
+          NS_LOG_DEBUG ("Cold tier hit, promoting " << data->GetName () << " to the hot tier");
+          this->m_coldHitsTrace (interest, data);
+          this->m_cacheHitsTrace (interest, data);
+
+          // may demote another entry to the cold tier
+          if (!super::Add (data))
+            {
+              // keep Data in the cold tier
+              m_cold.Append (data);
+            }
+
+          return Create<Data> (*data);
+        }
+    }
+
+  this->m_cacheMissesTrace (interest);
+  return 0;
+}
+
+template<class Policy>
+bool
+ContentStoreTiered< Policy >::Add (Ptr<const Data> data)
+{
+  bool ok = super::Add (data);
+  if (ok && m_cold.GetSize () > 0)
+    {
+      // hot copy supersedes the cold one
+      m_cold.Erase (data->GetName ());
+    }
+  return ok;
+}
+
+template<class Policy>
+void
+ContentStoreTiered< Policy >::WillEvictEntry (Ptr<const Entry> entry, Time lifetime)
+{
+  if (!m_cold.IsOpen ())
+    {
+      m_cold.Open (m_coldFileName, m_coldMaxBytes);
+    }
+
+  NS_LOG_DEBUG ("Demoting " << entry->GetName () << " to the cold tier");
+  m_cold.Append (entry->GetData ());
+}
+
+template<class Policy>
+void
+ContentStoreTiered< Policy >::SetColdMaxSize (uint32_t maxSize)
+{
+  m_cold.SetMaxSize (maxSize);
+}
+
+template<class Policy>
+uint32_t
+ContentStoreTiered< Policy >::GetColdMaxSize () const
+{
+  return m_cold.GetMaxSize ();
+}
+
+template<class Policy>
+uint32_t
+ContentStoreTiered< Policy >::GetColdSize () const
+{
+  return m_cold.GetSize ();
+}
+
+template<class Policy>
+void
+ContentStoreTiered< Policy >::Print (std::ostream &os) const
+{
+  super::Print (os);
+  os << "(cold tier: " << m_cold.GetSize () << " entries, "
+     << m_cold.GetUsedBytes () << " of " << m_cold.GetCapacity () << " bytes)" << std::endl;
+}
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_CONTENT_STORE_TIERED_H_
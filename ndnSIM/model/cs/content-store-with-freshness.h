@@ -52,18 +52,27 @@ public:
   virtual inline bool
   Add (Ptr<const Data> data);
 
+protected:
+  virtual inline typename super::super::iterator
+  FindMatchingEntry (Ptr<const Interest> interest);
+
 private:
   inline void
   CleanExpired ();
 
   inline void
-  RescheduleCleaning ();
+  ScheduleCleaning ();
+
+  void
+  SetExpirationResolution (Time resolution);
+
+  Time
+  GetExpirationResolution () const;
 
 private:
   static LogComponent g_log; ///< @brief Logging variable
 
   EventId m_cleanEvent;
-  Time m_scheduledCleaningTime;
 };
 
 //////////////////////////////////////////
@@ -85,6 +94,14 @@ ContentStoreWithFreshness< Policy >::GetTypeId ()
     .SetParent<super> ()
     .template AddConstructor< ContentStoreWithFreshness< Policy > > ()
 
+    .AddAttribute ("ExpirationResolution",
+                   "Granularity of the timing wheel used to clean up expired entries. "
+                   "Stale entries are never returned, but may occupy cache space up to this long after they expire",
+                   StringValue ("1s"),
+                   MakeTimeAccessor (&ContentStoreWithFreshness< Policy >::GetExpirationResolution,
+                                     &ContentStoreWithFreshness< Policy >::SetExpirationResolution),
+                   MakeTimeChecker ())
+
     // trace stuff here
     ;
 
@@ -100,40 +117,46 @@ ContentStoreWithFreshness< Policy >::Add (Ptr<const Data> data)
   if (!ok) return false;
 
   NS_LOG_DEBUG (data->GetName () << " added to cache");
-  RescheduleCleaning ();
+  ScheduleCleaning ();
   return true;
 }
 
 template<class Policy>
-inline void
-ContentStoreWithFreshness< Policy >::RescheduleCleaning ()
+inline typename ContentStoreWithFreshness< Policy >::super::super::iterator
+ContentStoreWithFreshness< Policy >::FindMatchingEntry (Ptr<const Interest> interest)
 {
-  const freshness_policy_container &freshness = this->getPolicy ().template get<freshness_policy_container> ();
+  Time now = Simulator::Now ();
 
-  if (freshness.size () > 0)
+  typename super::super::iterator node = super::FindMatchingEntry (interest);
+  while (node != this->end () &&
+         freshness_policy_container::policy_base::is_stale (node, now))
     {
-      Time nextStateTime = freshness_policy_container::policy_base::get_freshness (&(*freshness.begin ()));
+      // expire lazily, the timing wheel may not have reached this entry yet
+      NS_LOG_DEBUG (node->payload ()->GetName () << " is stale, removing from cache");
+      super::erase (node);
 
-      if (m_scheduledCleaningTime.IsZero () || // if not yet scheduled
-          m_scheduledCleaningTime > nextStateTime) // if new item expire sooner than already scheduled
-        {
-          if (m_cleanEvent.IsRunning ())
-            {
-              Simulator::Remove (m_cleanEvent); // just canceling would not clean up list of events
-            }
-
-          // NS_LOG_DEBUG ("Next event in: " << (nextStateTime - Now ()).ToDouble (Time::S) << "s");
-          m_cleanEvent = Simulator::Schedule (nextStateTime - Now (), &ContentStoreWithFreshness< Policy >::CleanExpired, this);
-          m_scheduledCleaningTime = nextStateTime;
-        }
-    }
-  else
-    {
-      if (m_cleanEvent.IsRunning ())
-        {
-          Simulator::Remove (m_cleanEvent); // just canceling would not clean up list of events
-        }
+      node = super::FindMatchingEntry (interest);
     }
+
+  return node;
+}
+
+template<class Policy>
+inline void
+ContentStoreWithFreshness< Policy >::ScheduleCleaning ()
+{
+  if (m_cleanEvent.IsRunning ())
+    return; // wheel is already ticking
+
+  const freshness_policy_container &freshness = this->getPolicy ().template get<freshness_policy_container> ();
+  if (freshness.empty ())
+    return;
+
+  Time nextCleaningTime = freshness.next_advance_time ();
+  Time now = Simulator::Now ();
+
+  m_cleanEvent = Simulator::Schedule (nextCleaningTime > now ? nextCleaningTime - now : Time (),
+                                      &ContentStoreWithFreshness< Policy >::CleanExpired, this);
 }
 
 
@@ -143,38 +166,51 @@ ContentStoreWithFreshness< Policy >::CleanExpired ()
 {
   freshness_policy_container &freshness = this->getPolicy ().template get<freshness_policy_container> ();
 
-  // NS_LOG_LOGIC (">> Cleaning: Total number of items:" << this->getPolicy ().size () << ", items with freshness: " << freshness.size ());
-  Time now = Simulator::Now ();
+  size_t removed = freshness.advance (Simulator::Now ());
+  NS_LOG_LOGIC ("Cleaning: removed " << removed << " items, items with freshness left: " << freshness.size ());
 
-  while (!freshness.empty ())
-    {
-      typename freshness_policy_container::iterator entry = freshness.begin ();
+  // one event per resolution interval, and only while there is something to expire
+  ScheduleCleaning ();
+}
 
-      if (freshness_policy_container::policy_base::get_freshness (&(*entry)) <= now) // is the record stale?
-        {
-          super::erase (&(*entry));
-        }
-      else
-        break; // nothing else to do. All later records will not be stale
+template<class Policy>
+void
+ContentStoreWithFreshness< Policy >::SetExpirationResolution (Time resolution)
+{
+  this->getPolicy ().template get<freshness_policy_container> ().set_resolution (resolution);
+
+  if (m_cleanEvent.IsRunning ())
+    {
+      Simulator::Remove (m_cleanEvent); // just canceling would not clean up list of events
     }
-  // NS_LOG_LOGIC ("<< Cleaning: Total number of items:" << this->getPolicy ().size () << ", items with freshness: " << freshness.size ());
+  ScheduleCleaning ();
+}
 
-  m_scheduledCleaningTime = Time ();
-  RescheduleCleaning ();
+template<class Policy>
+Time
+ContentStoreWithFreshness< Policy >::GetExpirationResolution () const
+{
+  return this->getPolicy ().template get<freshness_policy_container> ().get_resolution ();
 }
 
 template<class Policy>
 void
 ContentStoreWithFreshness< Policy >::Print (std::ostream &os) const
 {
-  // const freshness_policy_container &freshness = this->getPolicy ().template get<freshness_policy_container> ();
-
   for (typename super::policy_container::const_iterator item = this->getPolicy ().begin ();
        item != this->getPolicy ().end ();
        item++)
     {
-      Time ttl = freshness_policy_container::policy_base::get_freshness (&(*item)) - Simulator::Now ();
-      os << item->payload ()->GetName () << "(left: " << ttl.ToDouble (Time::S) << "s)" << std::endl;
+      const Time &expire = freshness_policy_container::policy_base::get_freshness (&(*item));
+      if (expire.IsZero ())
+        {
+          os << item->payload ()->GetName () << "(left: inf)" << std::endl;
+        }
+      else
+        {
+          Time ttl = expire - Simulator::Now ();
+          os << item->payload ()->GetName () << "(left: " << ttl.ToDouble (Time::S) << "s)" << std::endl;
+        }
     }
 }
 
@@ -0,0 +1,124 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef EXACT_MATCH_INDEX_POLICY_H_
+#define EXACT_MATCH_INDEX_POLICY_H_
+
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace ns3 {
+namespace ndn {
+namespace ndnSIM {
+
+/**
+ * @brief Traits for exact-match index on top of another policy
+ *
+ * Behaves exactly as Policy (same hooks, same container, same accessors), but additionally
+ * maintains a hash index from the full name digest to the trie node, so cache lookups for
+ * the exact name do not need to walk the trie.
+ */
+template<class Policy>
+struct exact_match_index_policy_traits
+{
+  /// @brief Name that can be used to identify the policy (for NS-3 object model and logging)
+  static std::string GetName () { return Policy::GetName (); }
+
+  typedef typename Policy::policy_hook_type policy_hook_type;
+
+  template<class Container>
+  struct container_hook
+  {
+    typedef typename Policy::template container_hook<Container>::type type;
+  };
+
+  template<class Base,
+           class Container,
+           class Hook>
+  struct policy
+  {
+    typedef typename Policy::template policy<Base, Container, Hook>::type base_policy;
+
+    class type : public base_policy
+    {
+    public:
+      typedef Container parent_trie;
+
+      type (Base &base)
+        : base_policy (base)
+      {
+      }
+
+      inline bool
+      insert (typename parent_trie::iterator item)
+      {
+        bool ok = base_policy::insert (item);
+        if (ok)
+          {
+            index_.insert (std::make_pair (get_digest (item), item));
+          }
+        return ok;
+      }
+
+      inline void
+      erase (typename parent_trie::iterator item)
+      {
+        std::pair<typename index_container::iterator, typename index_container::iterator> range =
+          index_.equal_range (get_digest (item));
+
+        for (typename index_container::iterator i = range.first; i != range.second; i++)
+          {
+            if (i->second == item)
+              {
+                index_.erase (i);
+                break;
+              }
+          }
+
+        base_policy::erase (item);
+      }
+
+      inline void
+      clear ()
+      {
+        index_.clear ();
+        base_policy::clear ();
+      }
+
+      /**
+       * @brief Find trie node that has payload with exactly the same name (does not update the policy)
+       */
+      template<class Key>
+      inline typename parent_trie::iterator
+      find_exact (const Key &key)
+      {
+        std::pair<typename index_container::iterator, typename index_container::iterator> range =
+          index_.equal_range (boost::hash<Key> () (key));
+
+        for (typename index_container::iterator i = range.first; i != range.second; i++)
+          {
+            if (i->second->payload ()->GetName () == key)
+              return i->second;
+          }
+        return 0;
+      }
+
+    private:
+      static inline std::size_t
+      get_digest (typename parent_trie::iterator item)
+      {
+        return hash_value (item->payload ()->GetName ());
+      }
+
+    private:
+      // collisions are resolved by comparing the full names
+      typedef boost::unordered_multimap<std::size_t, typename parent_trie::iterator> index_container;
+      index_container index_;
+    };
+  };
+};
+
+} // ndnSIM
+} // ndn
+} // ns3
+
+#endif // EXACT_MATCH_INDEX_POLICY_H_
@@ -25,6 +25,7 @@
 #include <boost/intrusive/list.hpp>
 
 #include <ns3/nstime.h>
+#include <ns3/assert.h>
 #include <ns3/simulator.h>
 #include <ns3/traced-callback.h>
 
@@ -34,13 +35,22 @@ namespace ndnSIM {
 
 /**
  * @brief Traits for freshness policy
+ *
+ * Items with non-zero freshness are placed into a coarse timing wheel: a fixed ring of
+ * unsorted buckets, each covering one resolution interval.  Insertion and removal are O(1),
+ * and expired items are removed bucket-by-bucket by calling advance () (once per resolution
+ * interval is enough).  Items that expire beyond the wheel horizon simply stay in their bucket
+ * for another revolution.
+ *
+ * Because removal is coarse-grained, stale items may stay in the container for up to one
+ * resolution interval after they expire.  Users must check is_stale () before returning an item.
  */
 struct freshness_policy_traits
 {
   /// @brief Name that can be used to identify the policy (for NS-3 object model and logging)
   static std::string GetName () { return "Freshness"; }
 
-  struct policy_hook_type : public boost::intrusive::set_member_hook<> { Time timeWhenShouldExpire; };
+  struct policy_hook_type : public boost::intrusive::list_member_hook<> { Time timeWhenShouldExpire; };
 
   template<class Container>
   struct container_hook
@@ -55,44 +65,54 @@ struct freshness_policy_traits
            class Hook>
   struct policy
   {
+    typedef boost::intrusive::list< Container, Hook > bucket_container;
+
     static Time& get_freshness (typename Container::iterator item)
     {
-      return static_cast<typename policy_container::value_traits::hook_type*>
-        (policy_container::value_traits::to_node_ptr(*item))->timeWhenShouldExpire;
+      return static_cast<typename bucket_container::value_traits::hook_type*>
+        (bucket_container::value_traits::to_node_ptr(*item))->timeWhenShouldExpire;
     }
 
     static const Time& get_freshness (typename Container::const_iterator item)
     {
-      return static_cast<const typename policy_container::value_traits::hook_type*>
-        (policy_container::value_traits::to_node_ptr(*item))->timeWhenShouldExpire;
+      return static_cast<const typename bucket_container::value_traits::hook_type*>
+        (bucket_container::value_traits::to_node_ptr(*item))->timeWhenShouldExpire;
     }
 
-    template<class Key>
-    struct MemberHookLess
+    /**
+     * @brief Check if item has expired (items with zero freshness never expire)
+     */
+    static bool is_stale (typename Container::const_iterator item, const Time &now)
     {
-      bool operator () (const Key &a, const Key &b) const
-      {
-        return get_freshness (&a) < get_freshness (&b);
-      }
-    };
-
-    typedef boost::intrusive::multiset< Container,
-                                   boost::intrusive::compare< MemberHookLess< Container > >,
-                                   Hook > policy_container;
-
+      const Time &expire = get_freshness (item);
+      return !expire.IsZero () && expire <= now;
+    }
 
-    class type : public policy_container
+    class type
     {
     public:
       typedef policy policy_base; // to get access to get_freshness methods from outside
       typedef Container parent_trie;
 
+      /// @brief Number of buckets in the timing wheel
+      static const size_t wheel_size = 256;
+
       type (Base &base)
         : base_ (base)
         , max_size_ (100)
+        , resolution_ (Seconds (1.0))
+        , wheel_ (0)
+        , size_ (0)
+        , cursor_ (0)
       {
       }
 
+      ~type ()
+      {
+        clear ();
+        delete [] wheel_;
+      }
+
       inline void
       update (typename parent_trie::iterator item)
       {
@@ -102,40 +122,164 @@ struct freshness_policy_traits
       inline bool
       insert (typename parent_trie::iterator item)
       {
-        // get_time (item) = Simulator::Now ();
         Time freshness = item->payload ()->GetData ()->GetFreshness ();
-        if (!freshness.IsZero ())
+        if (freshness.IsZero ())
           {
-            get_freshness (item) = Simulator::Now () + freshness;
-
-            // push item only if freshness is non zero. otherwise, this payload is not controlled by the policy
+            // this payload is not controlled by the policy
             // note that .size() on this policy would return only number of items with non-infinite freshness policy
-            policy_container::insert (*item);
+            get_freshness (item) = Time ();
+            return true;
+          }
+
+        if (wheel_ == 0)
+          {
+            wheel_ = new bucket_container [wheel_size];
+          }
+
+        if (size_ == 0)
+          {
+            // nothing could be pending in the buckets, start sweeping from now
+            cursor_ = get_tick (Simulator::Now ());
           }
 
+        get_freshness (item) = Simulator::Now () + freshness;
+        get_bucket (get_expire_tick (get_freshness (item))).push_back (*item);
+        size_ ++;
+
         return true;
       }
 
       inline void
       lookup (typename parent_trie::iterator item)
       {
-        // do nothing. it's random policy
+        // do nothing
       }
 
       inline void
       erase (typename parent_trie::iterator item)
       {
-        if (!item->payload ()->GetData ()->GetFreshness ().IsZero ())
+        Time &expire = get_freshness (item);
+        if (!expire.IsZero ())
           {
-            // erase only if freshness is non zero (otherwise an item is not in the policy
-            policy_container::erase (policy_container::s_iterator_to (*item));
+            // erase only if freshness is non zero (otherwise an item is not in the policy)
+            bucket_container &bucket = get_bucket (get_expire_tick (expire));
+            bucket.erase (bucket_container::s_iterator_to (*item));
+            expire = Time ();
+            size_ --;
           }
       }
 
       inline void
       clear ()
       {
-        policy_container::clear ();
+        if (wheel_ == 0)
+          return;
+
+        for (size_t i = 0; i < wheel_size; i++)
+          {
+            for (typename bucket_container::iterator item = wheel_[i].begin ();
+                 item != wheel_[i].end ();
+                 item++)
+              {
+                get_freshness (&(*item)) = Time ();
+              }
+            wheel_[i].clear ();
+          }
+        size_ = 0;
+      }
+
+      /**
+       * @brief Remove all expired items from buckets that are due by the time now
+       * @returns number of removed items
+       */
+      inline size_t
+      advance (const Time &now)
+      {
+        if (size_ == 0)
+          return 0;
+
+        int64_t nowTick = get_tick (now);
+        int64_t steps = std::min<int64_t> (nowTick - cursor_ + 1, wheel_size);
+
+        size_t removed = 0;
+        for (int64_t tick = cursor_; tick < cursor_ + steps && size_ > 0; tick++)
+          {
+            bucket_container &bucket = get_bucket (tick);
+
+            typename bucket_container::iterator item = bucket.begin ();
+            while (item != bucket.end ())
+              {
+                typename parent_trie::iterator node = &(*item);
+                item ++; // node may be deleted, move forward before removal
+
+                if (is_stale (node, now))
+                  {
+                    base_.erase (node);
+                    removed ++;
+                  }
+              }
+          }
+
+        cursor_ = std::max (cursor_, nowTick + 1);
+        return removed;
+      }
+
+      /**
+       * @brief Get time when next bucket of the wheel is due (or zero time, if there is nothing to expire)
+       */
+      inline Time
+      next_advance_time () const
+      {
+        if (size_ == 0)
+          return Time ();
+
+        return TimeStep (cursor_ * resolution_.GetTimeStep ());
+      }
+
+      inline size_t
+      size () const
+      {
+        return size_;
+      }
+
+      inline bool
+      empty () const
+      {
+        return size_ == 0;
+      }
+
+      inline void
+      set_resolution (const Time &resolution)
+      {
+        NS_ASSERT (resolution.IsStrictlyPositive ());
+
+        if (size_ == 0)
+          {
+            resolution_ = resolution;
+            return;
+          }
+
+        // rebucket all items according to the new resolution
+        bucket_container tmp;
+        for (size_t i = 0; i < wheel_size; i++)
+          {
+            tmp.splice (tmp.end (), wheel_[i]);
+          }
+
+        resolution_ = resolution;
+        cursor_ = get_tick (Simulator::Now ());
+        while (!tmp.empty ())
+          {
+            Container &item = tmp.front ();
+            tmp.pop_front ();
+            get_bucket (get_expire_tick (get_freshness (&item))).push_back (item);
+          }
+      }
+
+      inline const Time &
+      get_resolution () const
+      {
+        return resolution_;
       }
 
       inline void
@@ -150,12 +294,37 @@ struct freshness_policy_traits
         return max_size_;
       }
 
+    private:
+      inline int64_t
+      get_tick (const Time &time) const
+      {
+        return time.GetTimeStep () / resolution_.GetTimeStep ();
+      }
+
+      inline int64_t
+      get_expire_tick (const Time &time) const
+      {
+        // round up, so bucket is never swept before the item expires
+        return (time.GetTimeStep () + resolution_.GetTimeStep () - 1) / resolution_.GetTimeStep ();
+      }
+
+      inline bucket_container &
+      get_bucket (int64_t tick)
+      {
+        return wheel_[tick % wheel_size];
+      }
+
     private:
       type () : base_(*((Base*)0)) { };
 
     private:
       Base &base_;
       size_t max_size_;
+
+      Time resolution_;
+      bucket_container *wheel_;
+      size_t size_;
+      int64_t cursor_; ///< @brief tick of the next bucket to be swept
     };
   };
 };
@@ -164,4 +333,4 @@ struct freshness_policy_traits
 } // ndn
 } // ns3
 
-#endif // LIFETIME_STATS_POLICY_H
+#endif // FRESHNESS_POLICY_H_
@@ -0,0 +1,336 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "mapped-data-log.h"
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/ndn-data.h"
+#include "ns3/ndn-wire.h"
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.cs.MappedDataLog");
+
+namespace ns3 {
+namespace ndn {
+namespace cs {
+
+MappedDataLog::MappedDataLog ()
+  : m_fd (-1)
+  , m_log (0)
+  , m_capacity (0)
+  , m_head (0)
+  , m_usedBytes (0)
+  , m_maxSize (0)
+  , m_digest (&MappedDataLog::GetDigest)
+{
+}
+
+MappedDataLog::~MappedDataLog ()
+{
+  Close ();
+}
+
+void
+MappedDataLog::Open (const std::string &fileName, uint64_t capacity)
+{
+  NS_LOG_FUNCTION (this << fileName << capacity);
+
+  Close ();
+
+  if (fileName.empty ())
+    {
+      char tmpName[] = "/tmp/ndnSIM-cs-XXXXXX";
+      m_fd = mkstemp (tmpName);
+      if (m_fd >= 0)
+        {
+          unlink (tmpName); // file will be removed as soon as it is closed
+        }
+    }
+  else
+    {
+      m_fd = open (fileName.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    }
+
+  if (m_fd < 0)
+    {
+      NS_FATAL_ERROR ("Cannot create content store log file [" << fileName << "]: " << strerror (errno));
+    }
+
+  if (ftruncate (m_fd, capacity) != 0)
+    {
+      NS_FATAL_ERROR ("Cannot resize content store log file [" << fileName << "]: " << strerror (errno));
+    }
+
+  void *log = mmap (0, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (log == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("Cannot map content store log file [" << fileName << "]: " << strerror (errno));
+    }
+
+  m_log = static_cast<uint8_t*> (log);
+  m_capacity = capacity;
+  m_head = 0;
+}
+
+void
+MappedDataLog::Close ()
+{
+  Clear ();
+
+  if (m_log != 0)
+    {
+      munmap (m_log, m_capacity);
+      m_log = 0;
+    }
+
+  if (m_fd >= 0)
+    {
+      close (m_fd);
+      m_fd = -1;
+    }
+  m_capacity = 0;
+}
+
+bool
+MappedDataLog::IsOpen () const
+{
+  return m_log != 0;
+}
+
+size_t
+MappedDataLog::GetDigest (const Name &name)
+{
+  return hash_value (name);
+}
+
+void
+MappedDataLog::SetDigestFunction (DigestFunction digest)
+{
+  NS_ASSERT_MSG (m_index.empty (), "Digest function can be changed only when the log is empty");
+  m_digest = digest;
+}
+
+bool
+MappedDataLog::IsLive (const Record &record) const
+{
+  Index::const_iterator item = m_index.find (record.m_digest);
+  return item != m_index.end () && item->second.m_record.m_offset == record.m_offset;
+}
+
+Ptr<Data>
+MappedDataLog::Read (const Record &record) const
+{
+  Ptr<Packet> wire = Create<Packet> (m_log + record.m_offset, record.m_length);
+  return Wire::ToData (wire);
+}
+
+void
+MappedDataLog::Remove (Index::iterator item)
+{
+  m_usedBytes -= item->second.m_record.m_length;
+
+  for (std::vector<size_t>::const_iterator prefix = item->second.m_prefixes.begin ();
+       prefix != item->second.m_prefixes.end ();
+       prefix++)
+    {
+      PrefixIndex::iterator names = m_prefixIndex.find (*prefix);
+      if (names == m_prefixIndex.end ())
+        continue; // the same digest for two prefixes of the name
+
+      names->second.erase (item->first);
+      if (names->second.empty ())
+        m_prefixIndex.erase (names);
+    }
+
+  m_index.erase (item);
+}
+
+void
+MappedDataLog::DropOldest ()
+{
+  const Record &record = m_order.front ();
+  if (IsLive (record))
+    {
+      Remove (m_index.find (record.m_digest));
+    }
+  m_order.pop_front ();
+}
+
+bool
+MappedDataLog::Append (Ptr<const Data> data)
+{
+  NS_LOG_FUNCTION (this << data->GetName ());
+  NS_ASSERT (IsOpen ());
+
+  Ptr<Packet> wire = Wire::FromData (data);
+  uint32_t length = wire->GetSize ();
+  if (length > m_capacity)
+    return false;
+
+  Erase (data->GetName ());
+
+  uint64_t start = m_head;
+  if (start + length > m_capacity)
+    {
+      // not enough space till the end of the log, wrap around.  Records in the skipped
+      // part are the oldest ones (or there are none)
+      while (!m_order.empty () && m_order.front ().m_offset >= m_head)
+        {
+          DropOldest ();
+        }
+      start = 0;
+    }
+
+  // drop everything that will be overwritten
+  while (!m_order.empty () &&
+         m_order.front ().m_offset >= start &&
+         m_order.front ().m_offset < start + length)
+    {
+      DropOldest ();
+    }
+
+  while (m_maxSize != 0 && m_index.size () >= m_maxSize && !m_order.empty ())
+    {
+      DropOldest ();
+    }
+
+  wire->CopyData (m_log + start, length);
+
+  const Name &name = data->GetName ();
+  Record record (m_digest (name), start, length);
+
+  LiveRecord &live = m_index.insert (std::make_pair (record.m_digest, LiveRecord (record))).first->second;
+  live.m_prefixes.reserve (name.size ());
+  for (size_t prefixLength = 1; prefixLength < name.size (); prefixLength++)
+    {
+      size_t prefix = m_digest (name.getPrefix (prefixLength));
+      live.m_prefixes.push_back (prefix);
+      m_prefixIndex[prefix].insert (record.m_digest);
+    }
+  m_order.push_back (record);
+
+  m_head = start + length;
+  m_usedBytes += length;
+  return true;
+}
+
+Ptr<Data>
+MappedDataLog::Extract (const Name &name)
+{
+  NS_LOG_FUNCTION (this << name);
+
+  Index::iterator item = m_index.find (m_digest (name));
+  if (item == m_index.end ())
+    return 0;
+
+  Ptr<Data> data = Read (item->second.m_record);
+  if (data->GetName () != name)
+    {
+      // digest collision
+      return 0;
+    }
+
+  Remove (item);
+  return data;
+}
+
+Ptr<Data>
+MappedDataLog::ExtractMatching (const Name &prefix)
+{
+  NS_LOG_FUNCTION (this << prefix);
+
+  Ptr<Data> data = Extract (prefix);
+  if (data != 0 || prefix.size () == 0)
+    return data;
+
+  PrefixIndex::const_iterator names = m_prefixIndex.find (m_digest (prefix));
+  if (names == m_prefixIndex.end ())
+    return 0;
+
+  for (boost::unordered_set<size_t>::const_iterator name = names->second.begin ();
+       name != names->second.end ();
+       name++)
+    {
+      Index::iterator item = m_index.find (*name);
+      NS_ASSERT (item != m_index.end ());
+
+      data = Read (item->second.m_record);
+      if (data->GetName ().size () > prefix.size () &&
+          data->GetName ().getPrefix (prefix.size ()) == prefix)
+        {
+          Remove (item); // invalidates names
+          return data;
+        }
+      // otherwise digest collision
+    }
+
+  return 0;
+}
+
+bool
+MappedDataLog::Erase (const Name &name)
+{
+  // records for different names with the same digest could be erased too, which is fine for a cache
+  Index::iterator item = m_index.find (m_digest (name));
+  if (item == m_index.end ())
+    return false;
+
+  Remove (item);
+  return true;
+}
+
+void
+MappedDataLog::Clear ()
+{
+  m_index.clear ();
+  m_prefixIndex.clear ();
+  m_order.clear ();
+  m_head = 0;
+  m_usedBytes = 0;
+}
+
+size_t
+MappedDataLog::GetSize () const
+{
+  return m_index.size ();
+}
+
+void
+MappedDataLog::SetMaxSize (size_t maxSize)
+{
+  m_maxSize = maxSize;
+
+  while (m_maxSize != 0 && m_index.size () > m_maxSize && !m_order.empty ())
+    {
+      DropOldest ();
+    }
+}
+
+size_t
+MappedDataLog::GetMaxSize () const
+{
+  return m_maxSize;
+}
+
+uint64_t
+MappedDataLog::GetCapacity () const
+{
+  return m_capacity;
+}
+
+uint64_t
+MappedDataLog::GetUsedBytes () const
+{
+  return m_usedBytes;
+}
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,189 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDN_MAPPED_DATA_LOG_H_
+#define NDN_MAPPED_DATA_LOG_H_
+
+#include "ns3/ptr.h"
+#include "ns3/ndn-name.h"
+
+#include <deque>
+#include <vector>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/utility.hpp>
+
+namespace ns3 {
+namespace ndn {
+
+class Data;
+
+namespace cs {
+
+/**
+ * @ingroup ndn-cs
+ * @brief Append-only log of Data packets (in wire format) in a memory-mapped file
+ *
+ * The log is written circularly: when there is no space left, the oldest records are
+ * dropped.  Records are located through an on-heap index that keeps only name digest,
+ * offset, and length of each record, plus digests of all (non-empty) proper prefixes of the
+ * name, so records can also be found by a prefix of their name.  Digests are only hints:
+ * names of the records are checked when Data is read back.  Removed records are not
+ * reclaimed until the log wraps around.
+ */
+class MappedDataLog : boost::noncopyable
+{
+public:
+  typedef size_t (*DigestFunction) (const Name &name);
+
+  MappedDataLog ();
+  ~MappedDataLog ();
+
+  /**
+   * @brief Create log file and map it into memory
+   * @param fileName name of the file, if empty, anonymous temporary file is created
+   * @param capacity size of the log in bytes
+   */
+  void
+  Open (const std::string &fileName, uint64_t capacity);
+
+  /**
+   * @brief Unmap and close the log file, all records are dropped
+   */
+  void
+  Close ();
+
+  bool
+  IsOpen () const;
+
+  /**
+   * @brief Append Data to the log (any previous record with the same name is dropped)
+   * @returns false if Data could not be stored (e.g., it is larger than the log)
+   */
+  bool
+  Append (Ptr<const Data> data);
+
+  /**
+   * @brief Find Data with the exact name and remove it from the log
+   * @returns 0 if there is no record
+   */
+  Ptr<Data>
+  Extract (const Name &name);
+
+  /**
+   * @brief Find Data with the exact name or, if there is none, any Data whose name starts
+   *        with the (non-empty) prefix, and remove it from the log
+   * @returns 0 if there is no record
+   */
+  Ptr<Data>
+  ExtractMatching (const Name &prefix);
+
+  /**
+   * @brief Remove Data with the exact name from the log (if any)
+   */
+  bool
+  Erase (const Name &name);
+
+  /**
+   * @brief Drop all records (log file stays mapped)
+   */
+  void
+  Clear ();
+
+  /**
+   * @brief Get number of records in the log
+   */
+  size_t
+  GetSize () const;
+
+  /**
+   * @brief Set maximum number of records in the log (0 means no limit)
+   */
+  void
+  SetMaxSize (size_t maxSize);
+
+  size_t
+  GetMaxSize () const;
+
+  /**
+   * @brief Get size of the log in bytes
+   */
+  uint64_t
+  GetCapacity () const;
+
+  /**
+   * @brief Get number of bytes occupied by the records in the log
+   */
+  uint64_t
+  GetUsedBytes () const;
+
+  static size_t
+  GetDigest (const Name &name);
+
+  /**
+   * @brief Set function used to compute name digests (e.g., to test digest collisions)
+   *
+   * Can be changed only while the log is empty
+   */
+  void
+  SetDigestFunction (DigestFunction digest);
+
+private:
+  struct Record
+  {
+    Record (size_t digest, uint64_t offset, uint32_t length)
+      : m_digest (digest)
+      , m_offset (offset)
+      , m_length (length)
+    {
+    }
+
+    size_t   m_digest;
+    uint64_t m_offset;
+    uint32_t m_length;
+  };
+
+  struct LiveRecord
+  {
+    LiveRecord (const Record &record)
+      : m_record (record)
+    {
+    }
+
+    Record m_record;
+    std::vector<size_t> m_prefixes; ///< @brief digests of proper prefixes of the name
+  };
+
+  typedef boost::unordered_map<size_t, LiveRecord> Index;
+  typedef boost::unordered_map<size_t, boost::unordered_set<size_t> > PrefixIndex;
+
+  void
+  DropOldest ();
+
+  bool
+  IsLive (const Record &record) const;
+
+  Ptr<Data>
+  Read (const Record &record) const;
+
+  void
+  Remove (Index::iterator item);
+
+private:
+  int m_fd;
+  uint8_t *m_log;
+  uint64_t m_capacity;
+  uint64_t m_head;      ///< @brief offset where the next record will be written
+  uint64_t m_usedBytes;
+  size_t m_maxSize;
+  DigestFunction m_digest;
+
+  Index m_index;                ///< @brief name digest -> live record
+  PrefixIndex m_prefixIndex;    ///< @brief prefix digest -> name digests of live records under the prefix
+  std::deque<Record> m_order;   ///< @brief all records in the order they were written (including removed ones)
+};
+
+} // namespace cs
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_MAPPED_DATA_LOG_H_
@@ -52,7 +52,7 @@ struct FaceMetricByFace
 
 
 void
-FaceMetric::UpdateRtt (const Time &rttSample)
+FaceMetric::UpdateRtt (const Time &rttSample) const
 {
   // const Time & this->m_rttSample
 
@@ -83,11 +83,8 @@ Entry::UpdateFaceRtt (Ptr<Face> face, const Time &sample)
       return;
     }
 
-  m_faces.modify (record,
-                  ll::bind (&FaceMetric::UpdateRtt, ll::_1, sample));
-
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  // no container modification, SRTT and RTTVAR are not part of any index key
+  record->UpdateRtt (sample);
 }
 
 void
@@ -96,7 +93,7 @@ Entry::UpdateStatus (Ptr<Face> face, FaceMetric::Status status)
   NS_LOG_FUNCTION (this << boost::cref(*face) << status);
 
   FaceMetricByFace::type::iterator record = m_faces.get<i_face> ().find (face);
-  if (record == m_faces.get<i_face> ().end ())
+  if (record == m_faces.get<i_face> ().end () || record->GetStatus () == status)
     {
       return;
     }
@@ -104,8 +101,8 @@ Entry::UpdateStatus (Ptr<Face> face, FaceMetric::Status status)
   m_faces.modify (record,
                   ll::bind (&FaceMetric::SetStatus, ll::_1, status));
 
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  // random access index is reordered on the next FindBestCandidate
+  m_nthIndexOutdated = true;
 }
 
 void
@@ -124,16 +121,15 @@ Entry::AddOrUpdateRoutingMetric (Ptr<Face> face, int32_t metric)
     // don't update metric to higher value
     if (record->GetRoutingCost () > metric || record->GetStatus () == FaceMetric::NDN_FIB_RED)
       {
+        // single modification, as record iterator may not survive reordering (FaceMetricArray)
         m_faces.modify (record,
-                        ll::bind (&FaceMetric::SetRoutingCost, ll::_1, metric));
-
-        m_faces.modify (record,
-                        ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_YELLOW));
+                        (ll::bind (&FaceMetric::SetRoutingCost, ll::_1, metric),
+                         ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_YELLOW)));
       }
   }
 
-  // reordering random access index same way as by metric index
-  m_faces.get<i_nth> ().rearrange (m_faces.get<i_metric> ().begin ());
+  // random access index is reordered on the next FindBestCandidate
+  m_nthIndexOutdated = true;
 }
 
 void
@@ -154,26 +150,46 @@ Entry::SetRealDelayToProducer (Ptr<Face> face, Time delay)
 void
 Entry::Invalidate ()
 {
+  // modification may reorder records (FaceMetricArray), so collect faces first
+  std::vector< Ptr<Face> > faces;
   for (FaceMetricByFace::type::iterator face = m_faces.begin ();
        face != m_faces.end ();
        face++)
     {
-      m_faces.modify (face,
-                      ll::bind (&FaceMetric::SetRoutingCost, ll::_1, std::numeric_limits<uint16_t>::max ()));
+      faces.push_back (face->GetFace ());
+    }
 
-      m_faces.modify (face,
-                      ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_RED));
+  for (std::vector< Ptr<Face> >::iterator face = faces.begin (); face != faces.end (); face++)
+    {
+      m_faces.modify (m_faces.get<i_face> ().find (*face),
+                      (ll::bind (&FaceMetric::SetRoutingCost, ll::_1, std::numeric_limits<uint16_t>::max ()),
+                       ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_RED)));
     }
+  m_nthIndexOutdated = true;
 }
 
 const FaceMetric &
 Entry::FindBestCandidate (uint32_t skip/* = 0*/) const
 {
   if (m_faces.size () == 0) throw Entry::NoFaces ();
+  UpdateNthIndex ();
+
   skip = skip % m_faces.size();
   return m_faces.get<i_nth> () [skip];
 }
 
+void
+Entry::UpdateNthIndex () const
+{
+  if (!m_nthIndexOutdated)
+    return;
+
+  // reordering random access index same way as by metric index
+  FaceMetricContainer::type &faces = const_cast<FaceMetricContainer::type &> (m_faces);
+  faces.get<i_nth> ().rearrange (faces.get<i_metric> ().begin ());
+  m_nthIndexOutdated = false;
+}
+
 Ptr<Fib>
 Entry::GetFib ()
 {
@@ -183,6 +199,7 @@ Entry::GetFib ()
 
 std::ostream& operator<< (std::ostream& os, const Entry &entry)
 {
+  entry.UpdateNthIndex ();
   for (FaceMetricContainer::type::index<i_nth>::type::iterator metric =
          entry.m_faces.get<i_nth> ().begin ();
        metric != entry.m_faces.get<i_nth> ().end ();
@@ -27,6 +27,7 @@
 #include "ns3/ndn-name.h"
 #include "ns3/ndn-limits.h"
 #include "ns3/traced-value.h"
+#include "ns3/ndn-fib-face-metric-array.h"
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/tag.hpp>
@@ -100,10 +101,14 @@ public:
 
   /**
    * \brief Recalculate smoothed RTT and RTT variation
+   *
+   * RTT estimates are not part of any ordering key, so they are updated in place
+   * (records of the face container are accessible only as const)
+   *
    * \param rttSample RTT sample
    */
   void
-  UpdateRtt (const Time &rttSample);
+  UpdateRtt (const Time &rttSample) const;
 
   /**
    * @brief Get current status of FIB entry
@@ -199,8 +204,8 @@ private:
 
   int32_t m_routingCost; ///< \brief routing protocol cost (interpretation of the value depends on the underlying routing protocol)
 
-  Time m_sRtt;         ///< \brief smoothed round-trip time
-  Time m_rttVar;       ///< \brief round-trip time variation
+  mutable Time m_sRtt;         ///< \brief smoothed round-trip time
+  mutable Time m_rttVar;       ///< \brief round-trip time variation
 
   Time m_realDelay;    ///< \brief real propagation delay to the producer, calculated based on NS-3 p2p link delays
 };
@@ -214,15 +219,15 @@ class i_nth {};
 
 /**
  * @ingroup ndn-fib
- * @brief Typedef for indexed face container of Entry
+ * @brief Typedef for multi-index face container
  *
  * Currently, there are 2 indexes:
  * - by face (used to find record and update metric)
  * - by metric (face ranking)
  * - random access index (for fast lookup on nth face). Order is
- *   maintained manually to be equal to the 'by metric' order
+ *   maintained manually to be equal to the 'by metric' order (lazily, see Entry::FindBestCandidate)
  */
-struct FaceMetricContainer
+struct FaceMetricMultiIndex
 {
   /// @cond include_hidden
   typedef boost::multi_index::multi_index_container<
@@ -253,6 +258,24 @@ struct FaceMetricContainer
   /// @endcond
 };
 
+/**
+ * @ingroup ndn-fib
+ * @brief Typedef for indexed face container of Entry
+ *
+ * By default, the multi-index container (FaceMetricMultiIndex) is used.  When
+ * NDN_FIB_FACE_METRIC_ARRAY is defined (./waf configure --enable-fib-face-metric-array),
+ * the compact sorted array (FaceMetricArray) is used instead.  Both provide the same
+ * i_face/i_metric/i_nth access patterns.
+ */
+struct FaceMetricContainer
+{
+#ifdef NDN_FIB_FACE_METRIC_ARRAY
+  typedef FaceMetricArray type;
+#else
+  typedef FaceMetricMultiIndex::type type;
+#endif
+};
+
 /**
  * @ingroup ndn-fib
  * \brief Structure for FIB table entry, holding indexed list of
@@ -274,6 +297,7 @@ public:
   : m_fib (fib)
   , m_prefix (prefix)
   , m_needsProbing (false)
+  , m_nthIndexOutdated (false)
   {
   }
 
@@ -306,6 +330,8 @@ public:
 
   /**
    * @brief Update RTT averages for the face
+   *
+   * Only the face record is looked up, RTT averages do not affect the order of next hops
    */
   void
   UpdateFaceRtt (Ptr<Face> face, const Time &sample);
@@ -319,6 +345,9 @@ public:
   /**
    * \brief Find "best route" candidate, skipping `skip' first candidates (modulo # of faces)
    *
+   * Changes of next hop order since the previous call are applied to the i_nth index first,
+   * so any number of status or metric updates in between cost a single rearrangement.
+   *
    * throws Entry::NoFaces if m_faces.size()==0
    */
   const FaceMetric &
@@ -342,6 +371,12 @@ public:
 private:
   friend std::ostream& operator<< (std::ostream& os, const Entry &entry);
 
+  /**
+   * @brief Rearrange i_nth index in i_metric order, if the order has changed since the last call
+   */
+  void
+  UpdateNthIndex () const;
+
 public:
   Ptr<Fib> m_fib; ///< \brief FIB to which entry is added
 
@@ -349,6 +384,9 @@ public:
   FaceMetricContainer::type m_faces; ///< \brief Indexed list of faces
 
   bool m_needsProbing;      ///< \brief flag indicating that probing should be performed
+
+private:
+  mutable bool m_nthIndexOutdated; ///< \brief i_metric order has changed since i_nth has been rearranged
 };
 
 std::ostream& operator<< (std::ostream& os, const Entry &entry);
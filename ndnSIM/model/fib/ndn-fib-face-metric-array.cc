@@ -0,0 +1,142 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+#include "ndn-fib-face-metric-array.h"
+#include "ndn-fib-entry.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+namespace fib {
+
+//////////////////////////////////////////////////////////////////////
+// Helpers
+//////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Same order as `i_metric` index of the multi-index container: (status, routing cost)
+ */
+struct FaceMetricLess
+{
+  bool
+  operator() (const FaceMetric *a, const FaceMetric *b) const
+  {
+    if (a->GetStatus () != b->GetStatus ())
+      return a->GetStatus () < b->GetStatus ();
+
+    return a->GetRoutingCost () < b->GetRoutingCost ();
+  }
+};
+
+/////////////////////////////////////////////////////////////////////
+
+FaceMetricArray::FaceMetricArray ()
+{
+}
+
+FaceMetricArray::FaceMetricArray (const FaceMetricArray &other)
+{
+  m_records.reserve (other.m_records.size ());
+  for (container::const_iterator record = other.m_records.begin (); record != other.m_records.end (); record++)
+    {
+      m_records.push_back (new FaceMetric (**record));
+    }
+}
+
+FaceMetricArray::~FaceMetricArray ()
+{
+  clear ();
+}
+
+FaceMetricArray &
+FaceMetricArray::operator= (const FaceMetricArray &other)
+{
+  if (this != &other)
+    {
+      FaceMetricArray copy (other);
+      m_records.swap (copy.m_records);
+    }
+  return *this;
+}
+
+FaceMetricArray::iterator
+FaceMetricArray::find (const Ptr<Face> &face) const
+{
+  for (container::const_iterator record = m_records.begin (); record != m_records.end (); record++)
+    {
+      if ((*record)->GetFace () == face)
+        return iterator (record);
+    }
+  return end ();
+}
+
+std::pair<FaceMetricArray::iterator, bool>
+FaceMetricArray::insert (const FaceMetric &metric)
+{
+  iterator existing = find (metric.GetFace ());
+  if (existing != end ())
+    return std::make_pair (existing, false);
+
+  FaceMetric *record = new FaceMetric (metric);
+  // equal records are placed after the existing ones, same as ordered_non_unique index does
+  container::iterator position = std::upper_bound (m_records.begin (), m_records.end (), record, FaceMetricLess ());
+  position = m_records.insert (position, record);
+
+  return std::make_pair (iterator (position), true);
+}
+
+FaceMetricArray::size_type
+FaceMetricArray::erase (const Ptr<Face> &face)
+{
+  iterator record = find (face);
+  if (record == end ())
+    return 0;
+
+  erase (record);
+  return 1;
+}
+
+FaceMetricArray::iterator
+FaceMetricArray::erase (iterator position)
+{
+  container::iterator record = m_records.begin () + (position.base () - m_records.begin ());
+  delete *record;
+  return iterator (m_records.erase (record));
+}
+
+void
+FaceMetricArray::clear ()
+{
+  for (container::iterator record = m_records.begin (); record != m_records.end (); record++)
+    {
+      delete *record;
+    }
+  m_records.clear ();
+}
+
+void
+FaceMetricArray::Reorder (size_type position)
+{
+  FaceMetricLess less;
+  FaceMetric *record = m_records[position];
+
+  // status or cost has improved: shift worse records one position back
+  while (position > 0 && less (record, m_records[position - 1]))
+    {
+      m_records[position] = m_records[position - 1];
+      position--;
+    }
+
+  // status or cost has worsened: shift better records one position forward
+  while (position + 1 < m_records.size () && less (m_records[position + 1], record))
+    {
+      m_records[position] = m_records[position + 1];
+      position++;
+    }
+
+  m_records[position] = record;
+}
+
+} // namespace fib
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,210 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+#ifndef _NDN_FIB_FACE_METRIC_ARRAY_H_
+#define	_NDN_FIB_FACE_METRIC_ARRAY_H_
+
+#include "ns3/ptr.h"
+
+#include <vector>
+#include <iterator>
+
+namespace ns3 {
+namespace ndn {
+
+class Face;
+
+namespace fib {
+
+class FaceMetric;
+
+/**
+ * @ingroup ndn-fib
+ * @brief Compact next hop table of the FIB entry, stored as a small array sorted by (status, routing cost)
+ *
+ * A FIB entry rarely has more than a handful of next hops, so the table keeps a single vector
+ * ordered by metric and uses it for all three access patterns of the multi-index container:
+ * lookup by face is a linear scan, metric order is the array order, and nth candidate is an array
+ * element.  After a record is modified, it is moved to its new position by shifting neighbours,
+ * without any tree rebalancing.
+ *
+ * Records are allocated once and only pointers are shifted, so references to records (e.g., status
+ * trace connections) stay valid as long as the record is in the table.
+ *
+ * The subset of multi-index interface used by fib::Entry and forwarding strategies is
+ * available: get<i_face> ().find (), get<i_metric> () and get<i_nth> () iteration, get<i_nth> () [n],
+ * insert, erase, modify and rearrange.  Any index tag returns the same table.
+ */
+class FaceMetricArray
+{
+public:
+  typedef std::vector<FaceMetric*> container;
+
+  /**
+   * @brief Constant iterator over records (dereferences stored pointers)
+   */
+  class iterator : public std::iterator<std::random_access_iterator_tag, const FaceMetric>
+  {
+  public:
+    iterator () { }
+    explicit iterator (container::const_iterator position) : m_position (position) { }
+
+    const FaceMetric & operator* () const { return **m_position; }
+    const FaceMetric * operator-> () const { return *m_position; }
+
+    iterator & operator++ () { ++m_position; return *this; }
+    iterator operator++ (int) { iterator tmp (*this); ++m_position; return tmp; }
+    iterator & operator-- () { --m_position; return *this; }
+    iterator operator-- (int) { iterator tmp (*this); --m_position; return tmp; }
+
+    iterator operator+ (difference_type n) const { return iterator (m_position + n); }
+    iterator operator- (difference_type n) const { return iterator (m_position - n); }
+    difference_type operator- (const iterator &other) const { return m_position - other.m_position; }
+
+    bool operator== (const iterator &other) const { return m_position == other.m_position; }
+    bool operator!= (const iterator &other) const { return m_position != other.m_position; }
+
+    /**
+     * @brief Get iterator of the underlying array of pointers
+     */
+    container::const_iterator base () const { return m_position; }
+
+  private:
+    container::const_iterator m_position;
+  };
+  typedef iterator const_iterator;
+  typedef const FaceMetric value_type;
+  typedef const FaceMetric &reference;
+  typedef const FaceMetric &const_reference;
+  typedef container::size_type size_type;
+
+  /**
+   * @brief Type of any index of the table (the table itself)
+   */
+  template<class Tag>
+  struct index
+  {
+    typedef FaceMetricArray type;
+  };
+
+  FaceMetricArray ();
+  FaceMetricArray (const FaceMetricArray &other);
+  ~FaceMetricArray ();
+
+  FaceMetricArray &
+  operator= (const FaceMetricArray &other);
+
+  /**
+   * @brief Get "index" of the table (all indexes are the table itself)
+   */
+  template<class Tag>
+  FaceMetricArray &
+  get () { return *this; }
+
+  /**
+   * @brief Get "index" of the table (all indexes are the table itself)
+   */
+  template<class Tag>
+  const FaceMetricArray &
+  get () const { return *this; }
+
+  /**
+   * @brief Iterator to the best record (in (status, routing cost) order)
+   */
+  iterator
+  begin () const { return iterator (m_records.begin ()); }
+
+  /**
+   * @brief Iterator past the last record
+   */
+  iterator
+  end () const { return iterator (m_records.end ()); }
+
+  /**
+   * @brief Number of records in the table
+   */
+  size_type
+  size () const { return m_records.size (); }
+
+  /**
+   * @brief Check if the table is empty
+   */
+  bool
+  empty () const { return m_records.empty (); }
+
+  /**
+   * @brief Get nth record in (status, routing cost) order
+   */
+  const FaceMetric &
+  operator[] (size_type n) const { return *m_records[n]; }
+
+  /**
+   * @brief Find record for the face (linear scan)
+   * @returns end () if there is no record for the face
+   */
+  iterator
+  find (const Ptr<Face> &face) const;
+
+  /**
+   * @brief Add a copy of the record to its position in (status, routing cost) order
+   * @returns iterator to the record and true if it was inserted, or iterator to the existing
+   *          record for the same face and false
+   */
+  std::pair<iterator, bool>
+  insert (const FaceMetric &metric);
+
+  /**
+   * @brief Remove record for the face
+   * @returns number of removed records (0 or 1)
+   */
+  size_type
+  erase (const Ptr<Face> &face);
+
+  /**
+   * @brief Remove the record
+   * @returns iterator to the following record
+   */
+  iterator
+  erase (iterator position);
+
+  /**
+   * @brief Remove all records
+   */
+  void
+  clear ();
+
+  /**
+   * @brief Apply modifier to the record and move it to its new position in the table
+   *
+   * Unlike multi-index container, iterators to the table (including `position`) are invalidated
+   * if the record changes its position
+   */
+  template<class Modifier>
+  bool
+  modify (iterator position, Modifier modifier)
+  {
+    size_type offset = position.base () - m_records.begin ();
+    modifier (*m_records[offset]);
+    Reorder (offset);
+    return true;
+  }
+
+  /**
+   * @brief Does nothing: nth order is always the same as (status, routing cost) order
+   */
+  template<class InputIterator>
+  void
+  rearrange (InputIterator) { }
+
+private:
+  void
+  Reorder (size_type position);
+
+private:
+  container m_records; ///< \brief records ordered by (status, routing cost)
+};
+
+} // namespace fib
+} // namespace ndn
+} // namespace ns3
+
+#endif // _NDN_FIB_FACE_METRIC_ARRAY_H_
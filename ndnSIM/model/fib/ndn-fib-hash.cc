@@ -0,0 +1,378 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+#include "ndn-fib-hash.h"
+
+#include "ns3/ndn-face.h"
+#include "ns3/ndn-interest.h"
+#include "ns3/ndn-forwarding-strategy.h"
+
+#include "ns3/node.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+#include <boost/ref.hpp>
+#include <boost/functional/hash.hpp>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.fib.FibHash");
+
+namespace ns3 {
+namespace ndn {
+namespace fib {
+
+NS_OBJECT_ENSURE_REGISTERED (FibHash);
+
+// number of bits set in a Bloom filter per prefix
+static const int BLOOM_HASHES = 3;
+
+TypeId
+FibHash::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ndn::fib::Hash") // cheating ns3 object system
+    .SetParent<Fib> ()
+    .SetGroupName ("Ndn")
+    .AddConstructor<FibHash> ()
+
+    .AddAttribute ("UseBloomFilter",
+                   "Check per-length Bloom filter before probing the hash table of that length",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&FibHash::m_useBloomFilter),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BloomFilterBitsPerEntry",
+                   "Minimum number of Bloom filter bits per FIB entry (filter size is rounded up to a power of two)",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&FibHash::m_bloomBitsPerEntry),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+FibHash::FibHash ()
+  : m_useBloomFilter (true)
+  , m_bloomBitsPerEntry (16)
+{
+}
+
+void
+FibHash::NotifyNewAggregate ()
+{
+  Object::NotifyNewAggregate ();
+}
+
+void
+FibHash::DoDispose (void)
+{
+  m_levels.clear ();
+  m_entries.clear ();
+  Object::DoDispose ();
+}
+
+void
+FibHash::CalculateDigests (const Name &name, uint32_t length, std::vector<std::size_t> &digests)
+{
+  // must be kept in sync with hash_value (const Name &)
+  digests.resize (length + 1);
+
+  std::size_t seed = 0;
+  digests [0] = seed;
+
+  Name::const_iterator comp = name.begin ();
+  for (uint32_t i = 1; i <= length; i++, comp++)
+    {
+      boost::hash_combine (seed, comp->size ());
+      boost::hash_range (seed, comp->begin (), comp->end ());
+      digests [i] = seed;
+    }
+}
+
+Ptr<HashEntryImpl>
+FibHash::FindEntry (const Level &level, const Name &name, uint32_t length, std::size_t digest) const
+{
+  std::pair<table::const_iterator, table::const_iterator> range = level.entries.equal_range (digest);
+  for (; range.first != range.second; range.first++)
+    {
+      // digests can collide, compare the components
+      Name::const_iterator prefixComp = range.first->second->GetPrefix ().begin ();
+      Name::const_iterator nameComp = name.begin ();
+
+      uint32_t i = 0;
+      for (; i < length; i++, prefixComp++, nameComp++)
+        {
+          if (!(*prefixComp == *nameComp))
+            break;
+        }
+
+      if (i == length)
+        return range.first->second;
+    }
+
+  return 0;
+}
+
+void
+FibHash::AddToFilter (Level &level, std::size_t digest)
+{
+  if (!m_useBloomFilter)
+    return;
+
+  if (level.filter.GetNBits () < level.entries.size () * m_bloomBitsPerEntry)
+    {
+      // filter is too small for the new number of entries, rebuild it (including the new entry)
+      RebuildFilter (level);
+      return;
+    }
+
+  level.filter.Insert (digest);
+}
+
+void
+FibHash::RebuildFilter (Level &level)
+{
+  level.removed = 0;
+  level.filter.Release ();
+
+  if (!m_useBloomFilter || level.entries.empty ())
+    return;
+
+  level.filter.Resize (level.entries.size () * m_bloomBitsPerEntry, BLOOM_HASHES);
+  for (table::const_iterator item = level.entries.begin (); item != level.entries.end (); item++)
+    {
+      level.filter.Insert (item->first);
+    }
+}
+
+Ptr<Entry>
+FibHash::LongestPrefixMatch (const Interest &interest)
+{
+  if (m_levels.empty ())
+    return 0;
+
+  const Name &name = interest.GetName ();
+  uint32_t length = std::min<uint32_t> (name.size (), m_levels.size () - 1);
+  CalculateDigests (name, length, m_digests);
+
+  // @todo use predicate to search with exclude filters
+  while (true)
+    {
+      const Level &level = m_levels [length];
+      if (!level.entries.empty () && level.filter.MayContain (m_digests [length]))
+        {
+          Ptr<HashEntryImpl> entry = FindEntry (level, name, length, m_digests [length]);
+          if (entry != 0)
+            return entry;
+        }
+
+      if (length == 0)
+        break;
+      length--;
+    }
+
+  return 0;
+}
+
+Ptr<fib::Entry>
+FibHash::Find (const Name &prefix)
+{
+  if (prefix.size () >= m_levels.size ())
+    return 0;
+
+  return FindEntry (m_levels [prefix.size ()], prefix, prefix.size (), hash_value (prefix));
+}
+
+Ptr<Entry>
+FibHash::Add (const Name &prefix, Ptr<Face> face, int32_t metric)
+{
+  return Add (Create<Name> (prefix), face, metric);
+}
+
+Ptr<Entry>
+FibHash::Add (const Ptr<const Name> &prefix, Ptr<Face> face, int32_t metric)
+{
+  NS_LOG_FUNCTION (this->GetObject<Node> ()->GetId () << boost::cref(*prefix) << boost::cref(*face) << metric);
+
+  uint32_t length = prefix->size ();
+  std::size_t digest = hash_value (*prefix);
+
+  if (m_levels.size () <= length)
+    m_levels.resize (length + 1);
+  Level &level = m_levels [length];
+
+  // will add entry if doesn't exists, or just return the existing entry
+  Ptr<HashEntryImpl> entry = FindEntry (level, *prefix, length, digest);
+  bool isNew = (entry == 0);
+  if (isNew)
+    {
+      entry = Create<HashEntryImpl> (this, prefix, digest);
+      level.entries.insert (std::make_pair (digest, entry));
+      AddToFilter (level, digest);
+      entry->SetPosition (m_entries.insert (m_entries.end (), entry));
+    }
+
+  entry->AddOrUpdateRoutingMetric (face, metric);
+
+  if (isNew)
+    {
+      // notify forwarding strategy about new FIB entry
+      NS_ASSERT (this->GetObject<ForwardingStrategy> () != 0);
+      this->GetObject<ForwardingStrategy> ()->DidAddFibEntry (entry);
+    }
+
+  return entry;
+}
+
+void
+FibHash::Erase (Ptr<HashEntryImpl> entry)
+{
+  Level &level = m_levels [entry->GetPrefix ().size ()];
+
+  std::pair<table::iterator, table::iterator> range = level.entries.equal_range (entry->GetDigest ());
+  for (; range.first != range.second; range.first++)
+    {
+      if (range.first->second == entry)
+        {
+          level.entries.erase (range.first);
+          break;
+        }
+    }
+  m_entries.erase (entry->GetPosition ());
+
+  // removed prefixes stay in the filter and raise its false positive rate, shrink it eventually
+  level.removed++;
+  if (level.removed > level.entries.size ())
+    RebuildFilter (level);
+
+  while (!m_levels.empty () && m_levels.back ().entries.empty ())
+    m_levels.pop_back ();
+}
+
+void
+FibHash::Remove (const Ptr<const Name> &prefix)
+{
+  NS_LOG_FUNCTION (this->GetObject<Node> ()->GetId () << boost::cref(*prefix));
+
+  Ptr<Entry> entry = Find (*prefix);
+  if (entry != 0)
+    {
+      // notify forwarding strategy about soon be removed FIB entry
+      NS_ASSERT (this->GetObject<ForwardingStrategy> () != 0);
+      this->GetObject<ForwardingStrategy> ()->WillRemoveFibEntry (entry);
+
+      Erase (StaticCast<HashEntryImpl> (entry));
+    }
+  // else do nothing
+}
+
+void
+FibHash::InvalidateAll ()
+{
+  NS_LOG_FUNCTION (this->GetObject<Node> ()->GetId ());
+
+  for (HashEntryImpl::list::iterator item = m_entries.begin (); item != m_entries.end (); item++)
+    {
+      (*item)->Invalidate ();
+    }
+}
+
+void
+FibHash::RemoveFromAll (Ptr<Face> face)
+{
+  NS_LOG_FUNCTION (this);
+
+  HashEntryImpl::list::iterator item = m_entries.begin ();
+  while (item != m_entries.end ())
+    {
+      Ptr<HashEntryImpl> entry = *item;
+      item++;
+
+      entry->RemoveFace (face);
+      if (entry->m_faces.size () == 0)
+        {
+          // notify forwarding strategy about soon be removed FIB entry
+          NS_ASSERT (this->GetObject<ForwardingStrategy> () != 0);
+          this->GetObject<ForwardingStrategy> ()->WillRemoveFibEntry (entry);
+
+          Erase (entry);
+        }
+    }
+}
+
+void
+FibHash::Print (std::ostream &os) const
+{
+  for (HashEntryImpl::list::const_iterator item = m_entries.begin (); item != m_entries.end (); item++)
+    {
+      os << (*item)->GetPrefix () << "\t" << **item << "\n";
+    }
+}
+
+uint32_t
+FibHash::GetSize () const
+{
+  return m_entries.size ();
+}
+
+Ptr<const Entry>
+FibHash::Begin () const
+{
+  if (m_entries.empty ())
+    return End ();
+  else
+    return m_entries.front ();
+}
+
+Ptr<const Entry>
+FibHash::End () const
+{
+  return 0;
+}
+
+Ptr<const Entry>
+FibHash::Next (Ptr<const Entry> from) const
+{
+  if (from == 0) return 0;
+
+  HashEntryImpl::list::iterator item = StaticCast<const HashEntryImpl> (from)->GetPosition ();
+  item++;
+
+  if (item == m_entries.end ())
+    return End ();
+  else
+    return *item;
+}
+
+Ptr<Entry>
+FibHash::Begin ()
+{
+  if (m_entries.empty ())
+    return End ();
+  else
+    return m_entries.front ();
+}
+
+Ptr<Entry>
+FibHash::End ()
+{
+  return 0;
+}
+
+Ptr<Entry>
+FibHash::Next (Ptr<Entry> from)
+{
+  if (from == 0) return 0;
+
+  HashEntryImpl::list::iterator item = StaticCast<HashEntryImpl> (from)->GetPosition ();
+  item++;
+
+  if (item == m_entries.end ())
+    return End ();
+  else
+    return *item;
+}
+
+
+} // namespace fib
+} // namespace ndn
+} // namespace ns3
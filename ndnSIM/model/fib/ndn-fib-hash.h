@@ -0,0 +1,180 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+#ifndef _NDN_FIB_HASH_H_
+#define	_NDN_FIB_HASH_H_
+
+#include "ns3/ndn-fib.h"
+#include "ns3/ndn-name.h"
+#include "../../utils/ndn-bloom-filter.h"
+
+#include <list>
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+namespace ns3 {
+namespace ndn {
+namespace fib {
+
+/**
+ * @ingroup ndn-fib
+ * @brief FIB entry implementation with additional references to the hash-based container
+ */
+class HashEntryImpl : public Entry
+{
+public:
+  typedef std::list< Ptr<HashEntryImpl> > list;
+
+  HashEntryImpl (Ptr<Fib> fib, const Ptr<const Name> &prefix, std::size_t digest)
+    : Entry (fib, prefix)
+    , digest_ (digest)
+  {
+  }
+
+  void
+  SetPosition (list::iterator position)
+  {
+    position_ = position;
+  }
+
+  list::iterator GetPosition () const { return position_; }
+
+  /**
+   * @brief Digest of the prefix (same as hash_value (GetPrefix ()))
+   */
+  std::size_t GetDigest () const { return digest_; }
+
+private:
+  list::iterator position_;
+  std::size_t digest_;
+};
+
+/**
+ * @ingroup ndn-fib
+ * \brief FIB implementation that keeps prefixes in per-length hash tables
+ *
+ * Every prefix length has its own hash table, keyed by the prefix digest.  Digests of
+ * all prefixes of the Interest name are calculated in one pass, after which longest
+ * prefix match probes the tables from the longest possible length down.  A per-length
+ * Bloom filter is consulted before each probe, so lengths that cannot contain the
+ * prefix cost a few bit tests instead of a hash table lookup.
+ *
+ * Entries are iterated (Begin/Next, Print) in the order they were added.
+ */
+class FibHash : public Fib
+{
+public:
+  /**
+   * \brief Interface ID
+   *
+   * \return interface ID
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \brief Constructor
+   */
+  FibHash ();
+
+  virtual Ptr<Entry>
+  LongestPrefixMatch (const Interest &interest);
+
+  virtual Ptr<fib::Entry>
+  Find (const Name &prefix);
+
+  virtual Ptr<Entry>
+  Add (const Name &prefix, Ptr<Face> face, int32_t metric);
+
+  virtual Ptr<Entry>
+  Add (const Ptr<const Name> &prefix, Ptr<Face> face, int32_t metric);
+
+  virtual void
+  Remove (const Ptr<const Name> &prefix);
+
+  virtual void
+  InvalidateAll ();
+
+  virtual void
+  RemoveFromAll (Ptr<Face> face);
+
+  virtual void
+  Print (std::ostream &os) const;
+
+  virtual uint32_t
+  GetSize () const;
+
+  virtual Ptr<const Entry>
+  Begin () const;
+
+  virtual Ptr<Entry>
+  Begin ();
+
+  virtual Ptr<const Entry>
+  End () const;
+
+  virtual Ptr<Entry>
+  End ();
+
+  virtual Ptr<const Entry>
+  Next (Ptr<const Entry> item) const;
+
+  virtual Ptr<Entry>
+  Next (Ptr<Entry> item);
+
+protected:
+  // inherited from Object class
+  virtual void NotifyNewAggregate (); ///< @brief Notify when object is aggregated
+  virtual void DoDispose (); ///< @brief Perform cleanup
+
+private:
+  typedef boost::unordered_multimap< std::size_t, Ptr<HashEntryImpl> > table;
+
+  /**
+   * @brief Entries of one prefix length
+   */
+  struct Level
+  {
+    Level () : removed (0) { }
+
+    table entries;
+    BloomFilter filter;           ///< @brief Bloom filter of entry digests (without bits if not built)
+    uint32_t removed;             ///< @brief Entries removed since the filter was built
+  };
+
+  /**
+   * @brief Calculate digests of the first 0..length components of the name
+   *
+   * digests[i] is equal to hash_value (name.getPrefix (i))
+   */
+  static void
+  CalculateDigests (const Name &name, uint32_t length, std::vector<std::size_t> &digests);
+
+  Ptr<HashEntryImpl>
+  FindEntry (const Level &level, const Name &name, uint32_t length, std::size_t digest) const;
+
+  void
+  AddToFilter (Level &level, std::size_t digest);
+
+  void
+  RebuildFilter (Level &level);
+
+  /**
+   * @brief Remove entry from the hash table and the iteration list (no notification)
+   */
+  void
+  Erase (Ptr<HashEntryImpl> entry);
+
+private:
+  std::vector<Level> m_levels; ///< @brief Hash tables indexed by prefix length
+  HashEntryImpl::list m_entries;
+
+  bool m_useBloomFilter;
+  uint32_t m_bloomBitsPerEntry;
+
+  std::vector<std::size_t> m_digests; ///< @brief Scratch buffer for LongestPrefixMatch
+};
+
+} // namespace fib
+} // namespace ndn
+} // namespace ns3
+
+#endif	/* _NDN_FIB_HASH_H_ */
@@ -0,0 +1,236 @@
+#include "face-prefix-counters.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE ("FacePrefixCounters");
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+const uint32_t FacePrefixCounters::NO_PREFIX;
+
+FacePrefixCounters::FacePrefixCounters()
+    : nFaces(0)
+    , epoch(1)
+    , halfLife(0)
+{
+}
+
+void FacePrefixCounters::addFace(uint32_t faceId)
+{
+    if(faceId < nFaces)
+    {
+        return;
+    }
+
+    uint32_t newNFaces = faceId + 1;
+    widen(cells, newNFaces);
+    if(halfLife > 0)
+    {
+        widen(decayedCells, newNFaces);
+    }
+
+    nFaces = newNFaces;
+    perFace.resize(nFaces, Cell());
+}
+
+template<class T>
+void FacePrefixCounters::widen(std::vector<T> &rows, uint32_t newNFaces)
+{
+    if(prefixes.empty())
+    {
+        return;
+    }
+
+    // Widen every prefix row
+    std::vector<T> newRows(prefixes.size() * newNFaces, T());
+    for(uint32_t prefixId = 0; prefixId < prefixes.size(); prefixId++)
+    {
+        std::copy(rows.begin() + prefixId * nFaces, rows.begin() + (prefixId + 1) * nFaces,
+                newRows.begin() + prefixId * newNFaces);
+    }
+    rows.swap(newRows);
+}
+
+void FacePrefixCounters::setHalfLife(double halfLife)
+{
+    this->halfLife = halfLife;
+    decayedCells.clear();
+    if(halfLife > 0)
+    {
+        decayedCells.resize(prefixes.size() * nFaces, DecayedCell());
+    }
+}
+
+uint32_t FacePrefixCounters::addPrefix(const Name &prefix)
+{
+    uint32_t prefixId = freePrefixIds.empty() ? prefixes.size() : freePrefixIds.back();
+    std::pair<boost::unordered_map<Name, uint32_t>::iterator, bool> inserted =
+        prefixIds.insert(std::make_pair(prefix, prefixId));
+
+    if(!inserted.second)
+    {
+        return inserted.first->second;
+    }
+
+    NS_LOG_DEBUG("Prefix " << prefix << " has id " << prefixId);
+    if(prefixId < prefixes.size())
+    {
+        // Reuse the id of a removed prefix, its row has been cleared by removePrefix
+        freePrefixIds.pop_back();
+        prefixes[prefixId] = prefix;
+        return prefixId;
+    }
+
+    prefixes.push_back(prefix);
+    cells.resize(prefixes.size() * nFaces, Cell());
+    perPrefix.push_back(Cell());
+    if(halfLife > 0)
+    {
+        decayedCells.resize(prefixes.size() * nFaces, DecayedCell());
+    }
+
+    return prefixId;
+}
+
+void FacePrefixCounters::removePrefix(uint32_t prefixId)
+{
+    if(!hasPrefix(prefixId))
+    {
+        return;
+    }
+
+    NS_LOG_DEBUG("Prefix " << prefixes[prefixId] << " frees id " << prefixId);
+    prefixIds.erase(prefixes[prefixId]);
+    prefixes[prefixId] = Name();
+    freePrefixIds.push_back(prefixId);
+
+    std::fill(cells.begin() + prefixId * nFaces, cells.begin() + (prefixId + 1) * nFaces, Cell());
+    perPrefix[prefixId] = Cell();
+    if(halfLife > 0)
+    {
+        std::fill(decayedCells.begin() + prefixId * nFaces, decayedCells.begin() + (prefixId + 1) * nFaces,
+                DecayedCell());
+    }
+}
+
+uint32_t FacePrefixCounters::getPrefixId(const Name &prefix) const
+{
+    boost::unordered_map<Name, uint32_t>::const_iterator it = prefixIds.find(prefix);
+    return it == prefixIds.end() ? NO_PREFIX : it->second;
+}
+
+bool FacePrefixCounters::hasPrefix(uint32_t prefixId) const
+{
+    if(prefixId >= prefixes.size())
+    {
+        return false;
+    }
+
+    // Removed ids keep an empty name, which may also be a prefix in use with another id
+    boost::unordered_map<Name, uint32_t>::const_iterator it = prefixIds.find(prefixes[prefixId]);
+    return it != prefixIds.end() && it->second == prefixId;
+}
+
+uint32_t FacePrefixCounters::getNPrefixes() const
+{
+    return prefixes.size();
+}
+
+uint32_t FacePrefixCounters::getNUsedPrefixes() const
+{
+    return prefixIds.size();
+}
+
+const Name &FacePrefixCounters::getPrefix(uint32_t prefixId) const
+{
+    return prefixes[prefixId];
+}
+
+void FacePrefixCounters::increment(uint32_t faceId, uint32_t prefixId, Counter counter, double now)
+{
+    addFace(faceId);
+
+    touch(cells[prefixId * nFaces + faceId]).count[counter]++;
+    touch(perFace[faceId]).count[counter]++;
+    touch(perPrefix[prefixId]).count[counter]++;
+
+    if(halfLife > 0)
+    {
+        DecayedCell &cell = decayedCells[prefixId * nFaces + faceId];
+        double factor = std::pow(0.5, (now - cell.lastUpdate) / halfLife);
+        for(int i = 0; i < N_COUNTERS; i++)
+        {
+            cell.count[i] *= factor;
+        }
+        cell.count[counter] += 1;
+        cell.lastUpdate = now;
+    }
+}
+
+uint32_t FacePrefixCounters::get(uint32_t faceId, uint32_t prefixId, Counter counter) const
+{
+    if(faceId >= nFaces || prefixId >= prefixes.size())
+    {
+        return 0;
+    }
+
+    return read(cells[prefixId * nFaces + faceId], counter);
+}
+
+uint32_t FacePrefixCounters::getPerFace(uint32_t faceId, Counter counter) const
+{
+    return faceId < nFaces ? read(perFace[faceId], counter) : 0;
+}
+
+uint32_t FacePrefixCounters::getPerPrefix(uint32_t prefixId, Counter counter) const
+{
+    return prefixId < prefixes.size() ? read(perPrefix[prefixId], counter) : 0;
+}
+
+double FacePrefixCounters::getDecayed(uint32_t faceId, uint32_t prefixId, Counter counter, double now) const
+{
+    if(halfLife <= 0 || faceId >= nFaces || prefixId >= prefixes.size())
+    {
+        return 0;
+    }
+
+    const DecayedCell &cell = decayedCells[prefixId * nFaces + faceId];
+    return cell.count[counter] * std::pow(0.5, (now - cell.lastUpdate) / halfLife);
+}
+
+void FacePrefixCounters::reset()
+{
+    epoch++;
+
+    if(epoch == 0)
+    {
+        // The epoch wrapped around, old stamps could become current again
+        std::fill(cells.begin(), cells.end(), Cell());
+        std::fill(perFace.begin(), perFace.end(), Cell());
+        std::fill(perPrefix.begin(), perPrefix.end(), Cell());
+        epoch = 1;
+    }
+}
+
+FacePrefixCounters::Cell &FacePrefixCounters::touch(Cell &cell)
+{
+    if(cell.epoch != epoch)
+    {
+        cell = Cell();
+        cell.epoch = epoch;
+    }
+    return cell;
+}
+
+uint32_t FacePrefixCounters::read(const Cell &cell, Counter counter) const
+{
+    return cell.epoch == epoch ? cell.count[counter] : 0;
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
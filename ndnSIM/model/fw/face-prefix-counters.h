@@ -0,0 +1,113 @@
+#ifndef FACE_PREFIX_COUNTERS_H_
+#define FACE_PREFIX_COUNTERS_H_
+
+#include "ns3/ndnSIM/ndn.cxx/name.h"
+
+#include <boost/unordered_map.hpp>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+/**
+ * Satisfied/timed out counters per face and prefix of one node (e.g., for MAR attack detection).
+ *
+ * Faces are indexed by their id (Face::GetId, dense per node), prefixes get dense ids the first
+ * time they are counted. Counters are stored in a flat array, one row of all faces per prefix,
+ * together with the totals per face and per prefix, so an update is a few plain increments.
+ *
+ * Every cell is stamped with the epoch it has been written in. reset only starts a new epoch,
+ * cells of older epochs read as 0 and are cleared when they are incremented next.
+ *
+ * removePrefix clears the row of a prefix and frees its id for the next added prefix, so the memory
+ * is bounded by the number of prefixes in use at the same time, not by all prefixes ever added.
+ * The totals per face are not affected.
+ *
+ * With setHalfLife every cell also keeps exponentially decaying counts, which halve every
+ * half-life and are not affected by reset. They are decayed lazily (when incremented or read), so
+ * an update is still O(1).
+ */
+class FacePrefixCounters
+{
+public:
+    enum Counter {SATISFIED, TIMED_OUT, N_COUNTERS};
+
+    static const uint32_t NO_PREFIX = 0xffffffff;
+
+    FacePrefixCounters();
+
+    // Make room for the face (faces are normally added before any prefix is counted)
+    void addFace(uint32_t faceId);
+
+    uint32_t addPrefix(const Name &prefix);
+    // Forget the prefix and its counters, its id is reused by the next added prefix
+    void removePrefix(uint32_t prefixId);
+    uint32_t getPrefixId(const Name &prefix) const;
+    bool hasPrefix(uint32_t prefixId) const;
+    // Number of prefix ids (including removed ones, which read as 0)
+    uint32_t getNPrefixes() const;
+    // Number of prefixes in use
+    uint32_t getNUsedPrefixes() const;
+    const Name &getPrefix(uint32_t prefixId) const;
+
+    // Enable decaying counts (0 disables them)
+    void setHalfLife(double halfLife);
+
+    // now (e.g., in seconds) is only needed for decaying counts
+    void increment(uint32_t faceId, uint32_t prefixId, Counter counter, double now = 0);
+
+    uint32_t get(uint32_t faceId, uint32_t prefixId, Counter counter) const;
+    uint32_t getPerFace(uint32_t faceId, Counter counter) const;
+    uint32_t getPerPrefix(uint32_t prefixId, Counter counter) const;
+    double getDecayed(uint32_t faceId, uint32_t prefixId, Counter counter, double now) const;
+
+    // Set all counters to 0
+    void reset();
+
+private:
+    struct Cell
+    {
+        uint32_t epoch;
+        uint32_t count[N_COUNTERS];
+    };
+
+    struct DecayedCell
+    {
+        double lastUpdate;
+        double count[N_COUNTERS];
+    };
+
+    Cell &touch(Cell &cell);
+    uint32_t read(const Cell &cell, Counter counter) const;
+
+    template<class T>
+    void widen(std::vector<T> &rows, uint32_t newNFaces);
+
+    // Dense ids of prefixes (index into prefixes). Prefixes keep their ids across resets.
+    boost::unordered_map<Name, uint32_t> prefixIds;
+    std::vector<Name> prefixes;
+    // Ids of removed prefixes
+    std::vector<uint32_t> freePrefixIds;
+
+    uint32_t nFaces;
+
+    // cells[prefixId * nFaces + faceId]
+    std::vector<Cell> cells;
+    std::vector<Cell> perFace;
+    std::vector<Cell> perPrefix;
+
+    // Cells stamped with another epoch are 0 (epoch 0 is never current)
+    uint32_t epoch;
+
+    // decayedCells[prefixId * nFaces + faceId], empty if decaying counts are disabled
+    std::vector<DecayedCell> decayedCells;
+    double halfLife;
+
+};
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,80 @@
+#include "face-satisfaction.h"
+
+#include <cmath>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+FaceSatisfaction::FaceSatisfaction()
+    : halfLife(1)
+    , sumRatios(0)
+    , nActive(0)
+{
+}
+
+void FaceSatisfaction::setHalfLife(double halfLife)
+{
+    this->halfLife = halfLife;
+}
+
+void FaceSatisfaction::addFace(uint32_t faceId)
+{
+    if(faceId >= faces.size())
+    {
+        faces.resize(faceId + 1);
+    }
+}
+
+void FaceSatisfaction::satisfied(uint32_t faceId, double now)
+{
+    update(faceId, true, now);
+}
+
+void FaceSatisfaction::timedOut(uint32_t faceId, double now)
+{
+    update(faceId, false, now);
+}
+
+double FaceSatisfaction::getRatio(uint32_t faceId) const
+{
+    return faceId < faces.size() ? faces[faceId].ratio : 1;
+}
+
+double FaceSatisfaction::getAverageRatio() const
+{
+    return nActive == 0 ? 1 : sumRatios / nActive;
+}
+
+void FaceSatisfaction::update(uint32_t faceId, bool isSatisfied, double now)
+{
+    addFace(faceId);
+    FaceState &face = faces[faceId];
+
+    double factor = halfLife > 0 ? std::pow(0.5, (now - face.lastUpdate) / halfLife) : 1;
+    face.satisfied *= factor;
+    face.timedOut *= factor;
+    face.lastUpdate = now;
+
+    if(isSatisfied)
+        face.satisfied += 1;
+    else
+        face.timedOut += 1;
+
+    if(face.active)
+    {
+        sumRatios -= face.ratio;
+    }
+    else
+    {
+        face.active = true;
+        nActive++;
+    }
+
+    face.ratio = face.satisfied / (face.satisfied + face.timedOut);
+    sumRatios += face.ratio;
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
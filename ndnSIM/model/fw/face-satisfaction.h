@@ -0,0 +1,64 @@
+#ifndef FACE_SATISFACTION_H_
+#define FACE_SATISFACTION_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+/**
+ * Satisfaction ratios of Interests per incoming face (e.g., for the router-local defenses SBA and
+ * SBP against Interest flooding).
+ *
+ * Satisfied and timed out PIT entries are counted per face (Face::GetId, dense per node) with
+ * exponentially decaying counts, which halve every half-life. Decaying both counts by the same
+ * factor does not change their ratio, so the ratio of a face is updated only when an entry is
+ * counted. The sum of the ratios of all faces with counted entries is kept up to date along with
+ * it, so both the ratio of a face and the average ratio are O(1).
+ */
+class FaceSatisfaction
+{
+public:
+    FaceSatisfaction();
+
+    void setHalfLife(double halfLife);
+    void addFace(uint32_t faceId);
+
+    // now (e.g., in seconds) is used to decay the counts
+    void satisfied(uint32_t faceId, double now);
+    void timedOut(uint32_t faceId, double now);
+
+    // Ratio of satisfied entries of the face (1 if no entry has been counted)
+    double getRatio(uint32_t faceId) const;
+    // Average ratio of the faces with counted entries (1 if there are none)
+    double getAverageRatio() const;
+
+private:
+    struct FaceState
+    {
+        FaceState() : lastUpdate(0), satisfied(0), timedOut(0), ratio(1), active(false) {}
+
+        double lastUpdate;
+        double satisfied;
+        double timedOut;
+        double ratio;
+        bool active;
+    };
+
+    void update(uint32_t faceId, bool isSatisfied, double now);
+
+    std::vector<FaceState> faces;
+    double halfLife;
+
+    double sumRatios;
+    uint32_t nActive;
+
+};
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -2,22 +2,175 @@
 #include "ns3/log.h"
 #include "ns3/simulation-singleton.h"
 
+#include <algorithm>
+
 NS_LOG_COMPONENT_DEFINE ("GlobalRoutingInfo");
 
 namespace ns3 {
 namespace ndn {
 namespace fw {
 
+const uint32_t GlobalRoutingInfo::NO_PREFIX;
+const uint32_t GlobalRoutingInfo::NO_MONITOR;
+
+GlobalRoutingInfo::GlobalRoutingInfo()
+    : version(1)
+{
+}
+
+uint32_t GlobalRoutingInfo::addMonitor(uint32_t nodeId)
+{
+    GlobalRoutingInfo *info = SimulationSingleton<GlobalRoutingInfo>::Get();
+
+    if(nodeId < info->monitorIndexes.size() && info->monitorIndexes[nodeId] != NO_MONITOR)
+    {
+        return info->monitorIndexes[nodeId];
+    }
+
+    NS_LOG_DEBUG("Node " << nodeId << " is monitor " << info->monitors.size());
+
+    if(nodeId >= info->monitorIndexes.size())
+    {
+        info->monitorIndexes.resize(nodeId + 1, NO_MONITOR);
+    }
+
+    // Monitors are normally added before any prefix, otherwise rows have to be widened
+    uint32_t nMonitors = info->monitors.size();
+    if(!info->prefixes.empty())
+    {
+        std::vector<int32_t> distances(info->prefixes.size() * (nMonitors + 1), 0);
+        for(uint32_t prefixId = 0; prefixId < info->prefixes.size(); prefixId++)
+        {
+            std::copy(info->distances.begin() + prefixId * nMonitors,
+                      info->distances.begin() + (prefixId + 1) * nMonitors,
+                      distances.begin() + prefixId * (nMonitors + 1));
+        }
+        info->distances.swap(distances);
+    }
+
+    info->monitorIndexes[nodeId] = nMonitors;
+    info->monitors.push_back(nodeId);
+    info->version++;
+
+    return nMonitors;
+}
+
+uint32_t GlobalRoutingInfo::addPrefix(const Name &prefix)
+{
+    GlobalRoutingInfo *info = SimulationSingleton<GlobalRoutingInfo>::Get();
+
+    std::map<Name, uint32_t>::const_iterator id = info->prefixIds.find(prefix);
+    if(id != info->prefixIds.end())
+    {
+        return id->second;
+    }
+
+    uint32_t prefixId = info->prefixes.size();
+    info->prefixIds[prefix] = prefixId;
+    info->prefixes.push_back(prefix);
+    info->distances.resize(info->prefixes.size() * info->monitors.size(), 0);
+    info->version++;
+
+    return prefixId;
+}
+
+uint32_t GlobalRoutingInfo::getMonitorIndex(uint32_t nodeId)
+{
+    GlobalRoutingInfo *info = SimulationSingleton<GlobalRoutingInfo>::Get();
+
+    if(nodeId >= info->monitorIndexes.size())
+    {
+        return NO_MONITOR;
+    }
+
+    return info->monitorIndexes[nodeId];
+}
+
+uint32_t GlobalRoutingInfo::getNMonitors()
+{
+    return SimulationSingleton<GlobalRoutingInfo>::Get()->monitors.size();
+}
+
+uint32_t GlobalRoutingInfo::getMonitorNodeId(uint32_t monitorIndex)
+{
+    return SimulationSingleton<GlobalRoutingInfo>::Get()->monitors[monitorIndex];
+}
+
+uint32_t GlobalRoutingInfo::getPrefixId(const Name &prefix)
+{
+    GlobalRoutingInfo *info = SimulationSingleton<GlobalRoutingInfo>::Get();
+
+    std::map<Name, uint32_t>::const_iterator id = info->prefixIds.find(prefix);
+    if(id == info->prefixIds.end())
+    {
+        return NO_PREFIX;
+    }
+
+    return id->second;
+}
+
+uint32_t GlobalRoutingInfo::getNPrefixes()
+{
+    return SimulationSingleton<GlobalRoutingInfo>::Get()->prefixes.size();
+}
+
+const Name &GlobalRoutingInfo::getPrefix(uint32_t prefixId)
+{
+    return SimulationSingleton<GlobalRoutingInfo>::Get()->prefixes[prefixId];
+}
+
+void GlobalRoutingInfo::putDistance(uint32_t monitorIndex, uint32_t prefixId, int32_t distance)
+{
+    GlobalRoutingInfo *info = SimulationSingleton<GlobalRoutingInfo>::Get();
+    info->distances[prefixId * info->monitors.size() + monitorIndex] = distance;
+}
+
+int32_t GlobalRoutingInfo::getDistance(uint32_t monitorIndex, uint32_t prefixId)
+{
+    GlobalRoutingInfo *info = SimulationSingleton<GlobalRoutingInfo>::Get();
+    return info->distances[prefixId * info->monitors.size() + monitorIndex];
+}
+
+void GlobalRoutingInfo::resetDistances()
+{
+    GlobalRoutingInfo *info = SimulationSingleton<GlobalRoutingInfo>::Get();
+    std::fill(info->distances.begin(), info->distances.end(), 0);
+}
+
 void GlobalRoutingInfo::put(uint32_t nodeId, Name prefix, int32_t distance)
 {
     NS_LOG_DEBUG("Node " << nodeId << " reported route to " << prefix << " for "  << distance);
-    SimulationSingleton<GlobalRoutingInfo>::Get()->routingMap[nodeId][prefix] = distance;
+
+    uint32_t monitorIndex = addMonitor(nodeId);
+    uint32_t prefixId = addPrefix(prefix);
+    putDistance(monitorIndex, prefixId, distance);
+
+    SimulationSingleton<GlobalRoutingInfo>::Get()->version++;
 }
 
 int32_t GlobalRoutingInfo::get(uint32_t nodeId, Name prefix)
 {
     NS_LOG_DEBUG("Query route to " << prefix << " from monitor" << nodeId);
-    return SimulationSingleton<GlobalRoutingInfo>::Get()->routingMap[nodeId][prefix];
+
+    uint32_t monitorIndex = getMonitorIndex(nodeId);
+    uint32_t prefixId = getPrefixId(prefix);
+    if(monitorIndex == NO_MONITOR || prefixId == NO_PREFIX)
+    {
+        return 0;
+    }
+
+    return getDistance(monitorIndex, prefixId);
+}
+
+uint32_t GlobalRoutingInfo::getVersion()
+{
+    return SimulationSingleton<GlobalRoutingInfo>::Get()->version;
+}
+
+void GlobalRoutingInfo::invalidate()
+{
+    NS_LOG_DEBUG("Routes have changed");
+    SimulationSingleton<GlobalRoutingInfo>::Get()->version++;
 }
 
 } // namespace fw
@@ -3,21 +3,70 @@
 
 #include "ns3/ndnSIM/ndn.cxx/name.h"
 
+#include <map>
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 namespace fw {
 
+/**
+ * Distances from monitors to prefixes, shared by all nodes (e.g., for MAR2 path selection).
+ *
+ * Monitors (by node id) and prefixes get dense ids in the order they are added. Distances are
+ * stored in a flat array, one row of all monitors per prefix, so a lookup is two array indexes.
+ * Unknown distances are 0.
+ *
+ * Monitors are registered with addMonitor before routes are calculated. GlobalRoutingHelper then
+ * fills the distances of all registered monitors to all prefixes directly from the calculated
+ * shortest path trees (see putDistance), and refreshes them whenever routes are updated.
+ */
 class GlobalRoutingInfo
 {
-private:
-    typedef std::map<uint32_t, std::map<Name, int32_t > >  GlobalRoutingMap;
-
 public:
-    GlobalRoutingMap routingMap;
+    static const uint32_t NO_PREFIX = 0xffffffff;
+    static const uint32_t NO_MONITOR = 0xffffffff;
+
+    GlobalRoutingInfo();
+
+    static uint32_t addMonitor(uint32_t nodeId);
+    static uint32_t addPrefix(const Name &prefix);
+
+    static uint32_t getMonitorIndex(uint32_t nodeId);
+    static uint32_t getNMonitors();
+    static uint32_t getMonitorNodeId(uint32_t monitorIndex);
+
+    static uint32_t getPrefixId(const Name &prefix);
+    static uint32_t getNPrefixes();
+    static const Name &getPrefix(uint32_t prefixId);
 
+    static void putDistance(uint32_t monitorIndex, uint32_t prefixId, int32_t distance);
+    static int32_t getDistance(uint32_t monitorIndex, uint32_t prefixId);
+    static void resetDistances();
+
+    // Register monitor and prefix if needed and set the distance
     static void put(uint32_t nodeId, Name prefix, int32_t distance);
     static int32_t get(uint32_t nodeId, Name prefix);
 
+    static uint32_t getVersion();
+    static void invalidate();
+
+private:
+    // Dense monitor index by node id (NO_MONITOR for other nodes) and node id by monitor index
+    std::vector<uint32_t> monitorIndexes;
+    std::vector<uint32_t> monitors;
+
+    // Dense ids of prefixes (index into prefixes)
+    std::map<Name, uint32_t> prefixIds;
+    std::vector<Name> prefixes;
+
+    // distances[prefixId * monitors.size() + monitorIndex]
+    std::vector<int32_t> distances;
+
+    // Incremented whenever distances or routes change, so that precomputed tables
+    // (e.g., MAR2 routing table) can detect that they are stale
+    uint32_t version;
+
 };
 
 } // namespace fw
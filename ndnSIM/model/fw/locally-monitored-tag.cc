@@ -0,0 +1,111 @@
+#include "locally-monitored-tag.h"
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+LocallyMonitoredTag::LocallyMonitoredTag(uint32_t prefixId, boost::shared_ptr<EntryCounts> entryCounts)
+    : prefixId(prefixId)
+    , entryCounts(entryCounts)
+    , faces(0)
+    , nFaces(0)
+{
+    if(prefixId >= entryCounts->size())
+    {
+        entryCounts->resize(prefixId + 1, EntryCount());
+    }
+    (*entryCounts)[prefixId].tags++;
+}
+
+LocallyMonitoredTag::~LocallyMonitoredTag()
+{
+    if(nFaces > 0)
+    {
+        (*entryCounts)[prefixId].entries--;
+    }
+    (*entryCounts)[prefixId].tags--;
+}
+
+uint32_t LocallyMonitoredTag::getPrefixId() const
+{
+    return prefixId;
+}
+
+bool LocallyMonitoredTag::add(uint32_t faceId)
+{
+    uint64_t *word = findWord(faceId, true);
+    uint64_t bit = uint64_t(1) << (faceId % 64);
+    if(*word & bit)
+    {
+        return false;
+    }
+
+    *word |= bit;
+    if(nFaces++ == 0)
+    {
+        (*entryCounts)[prefixId].entries++;
+    }
+    return true;
+}
+
+bool LocallyMonitoredTag::remove(uint32_t faceId)
+{
+    uint64_t *word = findWord(faceId, false);
+    uint64_t bit = uint64_t(1) << (faceId % 64);
+    if(word == 0 || !(*word & bit))
+    {
+        return false;
+    }
+
+    *word &= ~bit;
+    if(--nFaces == 0)
+    {
+        (*entryCounts)[prefixId].entries--;
+    }
+    return true;
+}
+
+bool LocallyMonitoredTag::contains(uint32_t faceId) const
+{
+    const uint64_t *word = findWord(faceId);
+    return word != 0 && (*word & (uint64_t(1) << (faceId % 64))) != 0;
+}
+
+bool LocallyMonitoredTag::empty() const
+{
+    return nFaces == 0;
+}
+
+uint64_t *LocallyMonitoredTag::findWord(uint32_t faceId, bool create)
+{
+    if(faceId < 64)
+    {
+        return &faces;
+    }
+
+    uint32_t index = faceId / 64 - 1;
+    if(index >= moreFaces.size())
+    {
+        if(!create)
+        {
+            return 0;
+        }
+        moreFaces.resize(index + 1, 0);
+    }
+    return &moreFaces[index];
+}
+
+const uint64_t *LocallyMonitoredTag::findWord(uint32_t faceId) const
+{
+    if(faceId < 64)
+    {
+        return &faces;
+    }
+
+    uint32_t index = faceId / 64 - 1;
+    return index < moreFaces.size() ? &moreFaces[index] : 0;
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,72 @@
+#ifndef LOCALLY_MONITORED_TAG_H_
+#define LOCALLY_MONITORED_TAG_H_
+
+#include "ndn-fw-tag.h"
+
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+/**
+ * PIT entry tag with the incoming faces on which the Interests of the entry have been monitored
+ * by this node first (MAR).
+ *
+ * Faces are kept as a bitmask of their ids (Face::GetId, dense per node), the first 64 faces
+ * without any allocation. The tag also keeps the prefix id of the entry, so the statistics do
+ * not have to look up the prefix again when the entry is satisfied or times out.
+ *
+ * Entries with at least one face are counted per prefix id in entryCounts, which is shared by all
+ * tags of a node. A tag takes its entry out of the count when its last face is removed or when the
+ * PIT entry (and the tag with it) is destroyed, so the counts are always up to date. All tags are
+ * counted as well (with or without faces), a prefix id without tags may be reused for another
+ * prefix.
+ */
+class LocallyMonitoredTag : public Tag
+{
+public:
+    struct EntryCount
+    {
+        // Entries with at least one face
+        uint32_t entries;
+        // All tags referring to the prefix id
+        uint32_t tags;
+    };
+
+    // Indexed by prefix id
+    typedef std::vector<EntryCount> EntryCounts;
+
+    LocallyMonitoredTag(uint32_t prefixId, boost::shared_ptr<EntryCounts> entryCounts);
+    virtual ~LocallyMonitoredTag();
+
+    uint32_t getPrefixId() const;
+
+    // Return whether the face has not been in the set
+    bool add(uint32_t faceId);
+    // Return whether the face has been in the set
+    bool remove(uint32_t faceId);
+    bool contains(uint32_t faceId) const;
+    bool empty() const;
+
+private:
+    uint64_t *findWord(uint32_t faceId, bool create);
+    const uint64_t *findWord(uint32_t faceId) const;
+
+    uint32_t prefixId;
+    boost::shared_ptr<EntryCounts> entryCounts;
+
+    // Bit faceId of faces, faces from 64 on are in moreFaces
+    uint64_t faces;
+    std::vector<uint64_t> moreFaces;
+    uint32_t nFaces;
+
+};
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -15,10 +15,15 @@
 #include "ns3/ndnSIM/apps/cnmr-flooding-attacker.h"
 
 #include <limits.h>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <memory>
 
 #include <boost/ref.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/bind.hpp>
@@ -48,24 +53,55 @@ TypeId MonitorAwareRouting::GetTypeId()
         .AddTraceSource ("EntriesSatisfiedBefore",  "EntriesSatisfiedBefore",  MakeTraceSourceAccessor (&MonitorAwareRouting::entriesSatisfiedBeforeTrace))
         .AddTraceSource ("MaliciousRequestedMulti",  "MaliciousRequestedMulti",  MakeTraceSourceAccessor (&MonitorAwareRouting::maliciousRequestedMultiTrace))
         .AddTraceSource ("InterestConsumed",  "InterestConsumed",  MakeTraceSourceAccessor (&MonitorAwareRouting::interestConsumedTrace))
+        .AddTraceSource ("PathStretch",  "MAR-3 path stretch of unmonitored interests, traced once per interest by the first router",  MakeTraceSourceAccessor (&MonitorAwareRouting::pathStretchTrace))
 
         .AddAttribute("FTBM", "Enable/Disable 'Forward till be monitoredl'",
                 BooleanValue(true),
                 MakeBooleanAccessor (&MonitorAwareRouting::m_ftbm),
                 MakeBooleanChecker ())
 
-        .AddAttribute ("Detection", "Used detection scheme",
+        .AddAttribute ("Detection", "Used detection scheme (4: SBA, 5: SBP, 6: as 2 with exponentially decaying statistics)",
                 StringValue ("0"),
                 MakeUintegerAccessor (&MonitorAwareRouting::detection),
-                MakeUintegerChecker<uint32_t> (0, 5))
+                MakeUintegerChecker<uint32_t> (0, 6))
+
+        .AddAttribute ("HalfLife", "Half-life of the decaying statistics of detection schemes 4 to 6",
+                TimeValue (Seconds (1)),
+                MakeTimeAccessor (&MonitorAwareRouting::halfLife),
+                MakeTimeChecker ())
 
         .AddAttribute("Mode", "MAR mode (opportunistic/MAR-1/MAR-2/MAR-3)",
                 EnumValue(MonitorAwareRouting::MAR1),
                 MakeEnumAccessor (&MonitorAwareRouting::m_mode),
                 MakeEnumChecker (MonitorAwareRouting::OPPORTUNISTIC, "0",
                     MonitorAwareRouting::MAR1, "1",
-                    MonitorAwareRouting::MAR2, "2"))
-                    /* MonitorAwareRouting::MAR3, "3")) */
+                    MonitorAwareRouting::MAR2, "2",
+                    MonitorAwareRouting::MAR3, "3"))
+
+        .AddAttribute ("MaxDetourRatio", "MAR-3: maximum ratio of the path cost via a monitor to the direct path cost",
+                DoubleValue (1.5),
+                MakeDoubleAccessor (&MonitorAwareRouting::maxDetourRatio),
+                MakeDoubleChecker<double> (1))
+
+        .AddAttribute ("ExactNames", "Track satisfied and requested content names in exact sets instead of Bloom filters",
+                BooleanValue (false),
+                MakeBooleanAccessor (&MonitorAwareRouting::exactNames),
+                MakeBooleanChecker ())
+
+        .AddAttribute ("NameFilterCapacity", "Expected number of distinct content names per observation period (Bloom filter size)",
+                UintegerValue (10000),
+                MakeUintegerAccessor (&MonitorAwareRouting::nameFilterCapacity),
+                MakeUintegerChecker<uint32_t> (1))
+
+        .AddAttribute ("NameFilterFalsePositiveRate", "False positive rate of the content name Bloom filters",
+                DoubleValue (0.001),
+                MakeDoubleAccessor (&MonitorAwareRouting::nameFilterFalsePositiveRate),
+                MakeDoubleChecker<double> (0, 1))
+
+        .AddAttribute ("TopKPrefixes", "Number of timed out prefixes tracked per face and reported to the CC (0: all)",
+                UintegerValue (0),
+                MakeUintegerAccessor (&MonitorAwareRouting::topKPrefixes),
+                MakeUintegerChecker<uint32_t> ())
 
         .AddAttribute ("tau", "The minimum PIT usage for the dectecion schemes to kick in",
                 StringValue ("0.3"),
@@ -84,11 +120,25 @@ MonitorAwareRouting::MonitorAwareRouting()
     hasClient = false;
     resetStats();
     resetRound = 0;
+    routingTableMAR2Version = 0;
+    routingTableMAR3Version = 0;
+    prefixIdLimit = 0;
+    locallyMonitoredEntries = boost::make_shared<LocallyMonitoredTag::EntryCounts>();
 }
 
 void MonitorAwareRouting::AddFace(Ptr<Face> face)
 {
     super::AddFace(face);
+    unmonitoredStats.addFace(face->GetId());
+    faceSatisfaction.addFace(face->GetId());
+
+    if(topKPrefixes > 0)
+    {
+        if(face->GetId() >= timedOutTopKPerFace.size())
+            timedOutTopKPerFace.resize(face->GetId() + 1);
+        timedOutTopKPerFace[face->GetId()].setCapacity(topKPrefixes);
+    }
+
     if(face->GetFlags() == MonitorApp::FLAG)
     {
         hasMonitor = true;
@@ -107,6 +157,18 @@ void MonitorAwareRouting::AddFace(Ptr<Face> face)
         StringValue svPitSize;
         pit->GetAttribute("MaxSize", svPitSize);
         pitMaxSize = atoi(svPitSize.Get().c_str());
+
+        // Attributes are set by now
+        satisfiedNames.configure(5 * nameFilterCapacity, nameFilterFalsePositiveRate);
+        satisfiedNames.setExact(exactNames);
+        requestedNames.configure(nameFilterCapacity, nameFilterFalsePositiveRate);
+        requestedNames.setExact(exactNames);
+
+        if(detection == 6)
+        {
+            unmonitoredStats.setHalfLife(halfLife.GetSeconds());
+        }
+        faceSatisfaction.setHalfLife(halfLife.GetSeconds());
     }
 
 }
@@ -156,6 +218,8 @@ bool MonitorAwareRouting::CanAcceptInterest(Ptr<Face> inFace, Ptr<Interest> inte
 
     ns3::ndn::Name name = interest->GetName();
     Name prefix = name.getSubName(0, 1);
+    uint32_t faceId = inFace->GetId();
+    uint32_t prefixId = unmonitoredStats.getPrefixId(prefix);
     bool isMonitored = interest->GetMonitored() != 0;
 
     switch(detection)
@@ -171,9 +235,9 @@ bool MonitorAwareRouting::CanAcceptInterest(Ptr<Face> inFace, Ptr<Interest> inte
             if(hasMonitor
                     && !isMonitored // has not been monitored by another CNMR
                     && getPitUsage() > tau // PIT usage above threshold
-                    && timedOutPrefixesPerFace[inFace].find(prefix) != timedOutPrefixesPerFace[inFace].end()) // isMaliciousPrefix?
+                    && isTimedOutPrefix(faceId, prefixId)) // isMaliciousPrefix?
             {
-                double p_Drop = getSatisfactionRatioUnmonitored(inFace, prefix);
+                double p_Drop = getSatisfactionRatioUnmonitored(faceId, prefixId);
                 double rnd = rnd_Drop.GetValue();
                 if(rnd > p_Drop)
                 {
@@ -185,15 +249,16 @@ bool MonitorAwareRouting::CanAcceptInterest(Ptr<Face> inFace, Ptr<Interest> inte
         }
 
         case 2:
+        case 6: // same as 2, isTimedOutPrefix and getSatisfactionRatioUnmonitored use decaying statistics
         {
             if(hasMonitor
                     && !isMonitored // has not been monitored by another CNMR
                     && getPitUsage() > tau // PIT usage above threshold
-                    && timedOutPrefixesPerFace[inFace].find(prefix) != timedOutPrefixesPerFace[inFace].end() // isMaliciousPrefix?
-                    && satisfiedNames.find(name) == satisfiedNames.end() // content name has been satisfied before
-                    && requestedNames.find(name) == requestedNames.end()) // content name has been requested before
+                    && isTimedOutPrefix(faceId, prefixId) // isMaliciousPrefix?
+                    && !satisfiedNames.contains(name) // content name has been satisfied before
+                    && !requestedNames.contains(name)) // content name has been requested before
             {
-                double p_Drop = getSatisfactionRatioUnmonitored(inFace, prefix);
+                double p_Drop = getSatisfactionRatioUnmonitored(faceId, prefixId);
                 double rnd = rnd_Drop.GetValue();
                 if(rnd > p_Drop)
                 {
@@ -209,12 +274,12 @@ bool MonitorAwareRouting::CanAcceptInterest(Ptr<Face> inFace, Ptr<Interest> inte
             if(hasMonitor
                     && !isMonitored // has not been monitored by another CNMR
                     && ((getPitUsage() > tau // PIT usage above threshold
-                    && timedOutPrefixesPerFace[inFace].find(prefix) != timedOutPrefixesPerFace[inFace].end()) // isMaliciousPrefix?
+                    && isTimedOutPrefix(faceId, prefixId)) // isMaliciousPrefix?
                         || maliciousPrefixes.find(prefix) != maliciousPrefixes.end()) // OR is malicious prefix identified by CC, regardless of PIT usage
-                    && satisfiedNames.find(name) == satisfiedNames.end() // content name has been satisfied before
-                    && requestedNames.find(name) == requestedNames.end()) // content name has been requested before
+                    && !satisfiedNames.contains(name) // content name has been satisfied before
+                    && !requestedNames.contains(name)) // content name has been requested before
             {
-                double p_Drop = getSatisfactionRatioUnmonitored(inFace, prefix);
+                double p_Drop = getSatisfactionRatioUnmonitored(faceId, prefixId);
                 double rnd = rnd_Drop.GetValue();
                 if(rnd > p_Drop)
                 {
@@ -225,6 +290,44 @@ bool MonitorAwareRouting::CanAcceptInterest(Ptr<Face> inFace, Ptr<Interest> inte
             return true;
         }
 
+        case 4:
+        {
+            // Satisfaction-based acceptance (SBA): Interests of a face are accepted at the rate of
+            // its satisfaction ratio
+            if(getPitUsage() > tau) // PIT usage above threshold
+            {
+                double p_Accept = faceSatisfaction.getRatio(faceId);
+                double rnd = rnd_Drop.GetValue();
+                if(rnd > p_Accept)
+                {
+                    // Drop interest with probability 1 - P(p_Accept)
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        case 5:
+        {
+            // Satisfaction-based pushback (SBP): faces share the accepted Interests in proportion to
+            // their satisfaction ratios, faces above the average ratio are not limited. Downstream
+            // nodes see their Interests on the limited face time out, so the limit is pushed back
+            // towards the sources.
+            if(getPitUsage() > tau) // PIT usage above threshold
+            {
+                double average = faceSatisfaction.getAverageRatio();
+                double ratio = faceSatisfaction.getRatio(faceId);
+                double p_Accept = average > 0 ? std::min(1.0, ratio / average) : ratio;
+                double rnd = rnd_Drop.GetValue();
+                if(rnd > p_Accept)
+                {
+                    // Drop interest with probability 1 - P(p_Accept)
+                    return false;
+                }
+            }
+            return true;
+        }
+
         default:
         {
             return true;
@@ -293,7 +396,18 @@ void MonitorAwareRouting::OnInterest(Ptr<Face> inFace, Ptr<Interest> interest)
             if(hasMonitor && !interestMonitored)
             {
                 // Monitor apps count previously unmonitored interests seperately
-                locallyMonitored[inFace].insert(pitEntry);
+                boost::shared_ptr<LocallyMonitoredTag> tag = pitEntry->GetFwTag<LocallyMonitoredTag>();
+                if(!tag)
+                {
+                    if(topKPrefixes > 0 && unmonitoredStats.getNUsedPrefixes() >= prefixIdLimit)
+                    {
+                        // Do not keep the stats of every prefix an attacker has ever used
+                        recyclePrefixIds();
+                    }
+                    tag = boost::make_shared<LocallyMonitoredTag>(unmonitoredStats.addPrefix(prefix), locallyMonitoredEntries);
+                    pitEntry->AddFwTag(tag);
+                }
+                tag->add(inFace->GetId());
             }
         }
     }
@@ -332,22 +446,31 @@ void MonitorAwareRouting::OnInterest(Ptr<Face> inFace, Ptr<Interest> interest)
                 NS_LOG_DEBUG("Served interest from cache but it's not monitored. Forwarding...");
 
                 // If FTMB monitored is enabled and this interest has not been monitored before, we
-                // have to forward it. Thus we create a copy of this interest and forward it to this
-                // nodes routing module
-
-                FwHopCountTag hopCountTag;
-                interest->GetPayload ()->PeekPacketTag (hopCountTag);
+                // have to forward it. The served interest shares name and payload (with the hop
+                // count tag) with this interest. It has already been accepted by this node, so it is
+                // forwarded right away instead of passing it to OnInterest again.
+                Ptr<Interest> servedInterest = interest->Derive();
+                servedInterest->SetServed(1);
+
+                Ptr<pit::Entry> servedPitEntry = m_pit->Lookup (*servedInterest);
+                if (servedPitEntry == 0)
+                {
+                    servedPitEntry = m_pit->Create(servedInterest);
+                    if (servedPitEntry == 0)
+                    {
+                        FailedToCreatePitEntry (inFace, servedInterest);
+                        return;
+                    }
+                }
 
-                Ptr<Name> nameWithSequence = Create<Name> (interest->GetName ());
+                if (!servedPitEntry->IsNonceSeen (servedInterest->GetNonce ()))
+                {
+                    servedPitEntry->AddSeenNonce (servedInterest->GetNonce ());
+                }
 
-                Ptr<Interest> newInterest = Create<Interest> ();
-                newInterest->SetNonce (interest->GetNonce ());
-                newInterest->SetName (interest->GetName ());
-                newInterest->SetInterestLifetime (interest->GetInterestLifetime ());
-                newInterest->SetServed(1);
-                newInterest->GetPayload()->AddPacketTag(hopCountTag);
+                PropagateInterest (inFace, servedInterest, servedPitEntry);
 
-                OnInterest(inFace, newInterest);
+                pitUsageTrace(getPitUsage(), pit->GetSize());
             }
             else
             {
@@ -384,30 +507,34 @@ void MonitorAwareRouting::WillSatisfyPendingInterest (Ptr<Face> inFace, Ptr<pit:
 {
     super::WillSatisfyPendingInterest(inFace, pitEntry);
 
-    if(recordStats())
+    if(detection == 4 || detection == 5)
     {
-        Name name = pitEntry->GetPrefix();
-        Name prefix = name.getSubName(0, 1);
+        BOOST_FOREACH(const pit::IncomingFace &face, pitEntry->GetIncoming())
+        {
+            faceSatisfaction.satisfied(face.m_face->GetId(), Simulator::Now().GetSeconds());
+        }
+    }
 
-        satisfiedNames.insert(name);
+    if(recordStats())
+    {
+        satisfiedNames.insert(pitEntry->GetPrefix());
 
         entriesSatisfiedBeforeTrace(satisfiedNames.size());
 
-        // Increase the counters according to the number of incoming faces of the PIT entry
-        BOOST_FOREACH(const pit::IncomingFace &face, pitEntry->GetIncoming())
+        boost::shared_ptr<LocallyMonitoredTag> tag = pitEntry->GetFwTag<LocallyMonitoredTag>();
+        if(tag && !tag->empty())
         {
-            satisfiedPerFace[face.m_face]++;
-
-            std::set<Ptr<pit::Entry> >::iterator monitoredFirst = locallyMonitored[face.m_face].find(pitEntry);
-            if(monitoredFirst != locallyMonitored[face.m_face].end())
+            // Increase the counters according to the number of incoming faces of the PIT entry
+            BOOST_FOREACH(const pit::IncomingFace &face, pitEntry->GetIncoming())
             {
-                // The interest on this interface has been monitored by this node first
-                locallyMonitored[face.m_face].erase(monitoredFirst);
-                satisfiedUnmonitored++;
-                satisfiedUnmonitoredPerFace[face.m_face]++;
-                satisfiedUnmonitoredPerFacePerName[face.m_face][prefix]++;
+                uint32_t faceId = face.m_face->GetId();
+                if(tag->remove(faceId))
+                {
+                    // The interest on this interface has been monitored by this node first
+                    satisfiedUnmonitored++;
+                    unmonitoredStats.increment(faceId, tag->getPrefixId(), FacePrefixCounters::SATISFIED, Simulator::Now().GetSeconds());
+                }
             }
-
         }
     }
 }
@@ -609,67 +736,206 @@ bool MonitorAwareRouting::DoPropagateInterestMAR2(Ptr<Face> inFace, Ptr<const In
 
     if(!interestMonitored && !hasMonitor)
     {
+        if(routingTableMAR2Version != GlobalRoutingInfo::getVersion())
+        {
+            // Routes or distances reported by monitors have changed since the table was calculated
+            CalculateRoutesMAR2();
+        }
+
         Name prefix = interest->GetName().getSubName(0, interest->GetName().size() - 1);
-        Ptr<Face> forwardVia;
+        uint32_t prefixId = GlobalRoutingInfo::getPrefixId(prefix);
 
-        if(routingTableMAR2[prefix] != NULL)
+        Ptr<Face> forwardVia = prefixId != GlobalRoutingInfo::NO_PREFIX ? routingTableMAR2[prefixId] : defaultRouteMAR2;
+        if(forwardVia == 0)
         {
-            // We already have calculated the best route to the given prefix
-            forwardVia = routingTableMAR2[prefix];
+            // There is no route to any monitor
+            return DoPropagateInterestOpportunistic(inFace, interest, pitEntry);
         }
-        else
+
+        NS_LOG_INFO("Forward to " << boost::cref(*forwardVia));
+        return TrySendOutInterest(inFace, forwardVia, interest, pitEntry);
+
+    }
+    else
+    {
+        return DoPropagateInterestOpportunistic(inFace, interest, pitEntry);
+    }
+
+}
+
+void MonitorAwareRouting::CalculateRoutesMAR2()
+{
+    NS_LOG_FUNCTION (this);
+
+    // For every prefix reported by monitors, find the face via which the sum of the cost to the
+    // monitor and the cost from the monitor to the server is minimal. This is done once for all
+    // prefixes, whenever GlobalRoutingInfo reports a change.
+    uint32_t nPrefixes = GlobalRoutingInfo::getNPrefixes();
+
+    std::vector<int> &currentMinCost = routingCostMAR2;
+    currentMinCost.assign(nPrefixes, INT_MAX);
+    routingTableMAR2.assign(nPrefixes, 0);
+
+    int defaultMinCost = INT_MAX;
+    defaultRouteMAR2 = 0;
+
+    for (Ptr<fib::Entry> entry = m_fib->Begin (); entry != m_fib->End (); entry = m_fib->Next (entry))
+    {
+        if(entry->GetPrefix().size() < 2 || entry->GetPrefix().getSubName(0, 1) != monitorPrefix)
         {
-            // We have to calculate the best route
+            // Skip faces whose prefix has only 1 component (eg. "monitor"). We only want
+            // something like "monitor/2" here.
+            continue;
+        }
 
-            int currentMinCost = INT_MAX;
+        // The FIB entries to the different monitors have the prefixes monitor/<node id>, e.g.
+        // monitor/1, monitor/2. In the global routing we can only query by the id, thus we
+        // extract the last part of the FIB entry here
+        uint32_t monitorId = atoi(entry->GetPrefix().get(1).toUri().c_str());
+        uint32_t monitorIndex = GlobalRoutingInfo::getMonitorIndex(monitorId);
 
-            for (Ptr<fib::Entry> entry = m_fib->Begin (); entry != m_fib->End (); entry = m_fib->Next (entry))
+        std::vector<int32_t> costMonitorToServer(nPrefixes, 0);
+        if(monitorIndex != GlobalRoutingInfo::NO_MONITOR)
+        {
+            for(uint32_t prefixId = 0; prefixId < nPrefixes; prefixId++)
             {
-                if(entry->GetPrefix().size() < 2 || entry->GetPrefix().getSubName(0, 1) != monitorPrefix)
-                {
-                    // Skip faces whose prefix has only 1 component (eg. "monitor"). We only want
-                    // something like "monitor/2" here.
-                    continue;
-                }
+                costMonitorToServer[prefixId] = GlobalRoutingInfo::getDistance(monitorIndex, prefixId);
+            }
+        }
 
-                BOOST_FOREACH (const fib::FaceMetric &metricFace, entry->m_faces.get<fib::i_metric> ())
-                {
-                    // The FIB entries to the different monitors have the prefixes monitor/1, monitor/2,
-                    // etc. In the global routing we can only query by the id, e.g. 1 or 2. Thus we
-                    // extract the last part of the FIB entry here
-                    int monitorId = atoi(entry->GetPrefix().get(1).toUri().c_str());
+        BOOST_FOREACH (const fib::FaceMetric &metricFace, entry->m_faces.get<fib::i_metric> ())
+        {
+            int costMeToMonitor = metricFace.GetRoutingCost();
 
-                    int costMeToMonitor = metricFace.GetRoutingCost();
-                    int costMonitorToServer = GlobalRoutingInfo::get(monitorId, prefix);
-                    int cost = costMeToMonitor + costMonitorToServer;
+            NS_LOG_DEBUG("Could forward via " << entry->GetPrefix() << " for " << costMeToMonitor << " + distance from monitor");
 
-                    NS_LOG_DEBUG("Could forward via " << entry->GetPrefix() << " for " << cost);
+            // Prefixes unknown to the monitors have zero distance from every monitor
+            if(costMeToMonitor < defaultMinCost)
+            {
+                defaultMinCost = costMeToMonitor;
+                defaultRouteMAR2 = metricFace.GetFace();
+            }
 
-                    if(cost < currentMinCost)
-                    {
-                        currentMinCost = cost;
-                        forwardVia = metricFace.GetFace();
-                    }
+            for(uint32_t prefixId = 0; prefixId < nPrefixes; prefixId++)
+            {
+                int cost = costMeToMonitor + costMonitorToServer[prefixId];
+                if(cost < currentMinCost[prefixId])
+                {
+                    currentMinCost[prefixId] = cost;
+                    routingTableMAR2[prefixId] = metricFace.GetFace();
                 }
             }
-
-            routingTableMAR2[prefix] = forwardVia;
         }
+    }
 
-        NS_LOG_INFO("Forward to " << boost::cref(*forwardVia));
-        return TrySendOutInterest(inFace, forwardVia, interest, pitEntry);
+    routingTableMAR2Version = GlobalRoutingInfo::getVersion();
+}
+
+bool MonitorAwareRouting::DoPropagateInterestMAR3(Ptr<Face> inFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry)
+{
+    NS_LOG_FUNCTION (this);
+    bool interestMonitored = interest->GetMonitored() != 0;
+
+    if(interestMonitored || hasMonitor)
+    {
+        return DoPropagateInterestOpportunistic(inFace, interest, pitEntry);
+    }
+
+    // Only the first router decides whether the interest takes the detour via a monitor. Later
+    // routers would compare the detour left with their own direct path and could abandon a
+    // detour that has been paid for in part.
+    switch(interest->GetDetour())
+    {
+        case Interest::DETOUR_MONITOR:
+            return DoPropagateInterestMAR2(inFace, interest, pitEntry);
+        case Interest::DETOUR_DIRECT:
+            return DoPropagateInterestOpportunistic(inFace, interest, pitEntry);
+    }
+
+    if(routingTableMAR3Version != GlobalRoutingInfo::getVersion())
+    {
+        CalculateRoutesMAR3();
+    }
+
+    Name prefix = interest->GetName().getSubName(0, interest->GetName().size() - 1);
+    uint32_t prefixId = GlobalRoutingInfo::getPrefixId(prefix);
 
+    Ptr<Face> forwardVia;
+    if(prefixId == GlobalRoutingInfo::NO_PREFIX)
+    {
+        // The detour cannot be bounded, use the nearest monitor as MAR-2 does
+        forwardVia = defaultRouteMAR2;
     }
     else
     {
-        return DoPropagateInterestOpportunistic(inFace, interest, pitEntry);
+        forwardVia = routingTableMAR3[prefixId];
+        // The stretch of the whole path, traced once per interest
+        pathStretchTrace(interest, forwardVia != 0 ? routingStretchMAR3[prefixId] : 1.0);
     }
 
+    Ptr<Interest> decided = interest->Derive();
+    decided->SetDetour(forwardVia != 0 ? Interest::DETOUR_MONITOR : Interest::DETOUR_DIRECT);
+
+    if(forwardVia == 0)
+    {
+        // The detour via a monitor is too long (or there is no monitor), forward directly.
+        // The interest may still be monitored on the way.
+        return DoPropagateInterestOpportunistic(inFace, decided, pitEntry);
+    }
+
+    NS_LOG_INFO("Forward to " << boost::cref(*forwardVia));
+    return TrySendOutInterest(inFace, forwardVia, decided, pitEntry);
 }
 
-bool MonitorAwareRouting::DoPropagateInterestMAR3(Ptr<Face> inFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry)
+void MonitorAwareRouting::CalculateRoutesMAR3()
 {
-    return false;
+    NS_LOG_FUNCTION (this);
+
+    if(routingTableMAR2Version != GlobalRoutingInfo::getVersion())
+    {
+        CalculateRoutesMAR2();
+    }
+
+    // Use the best route via a monitor (MAR-2) for every prefix, unless its cost exceeds the cost
+    // of the direct path (best FIB route) by more than maxDetourRatio
+    uint32_t nPrefixes = GlobalRoutingInfo::getNPrefixes();
+    routingTableMAR3.assign(nPrefixes, 0);
+    routingStretchMAR3.assign(nPrefixes, 1.0);
+
+    for(uint32_t prefixId = 0; prefixId < nPrefixes; prefixId++)
+    {
+        if(routingTableMAR2[prefixId] == 0)
+        {
+            continue;
+        }
+
+        // Longest prefix match as for the interests themselves (the prefix may be covered by a
+        // shorter entry, e.g. after FIB compression)
+        Ptr<Interest> probe = Create<Interest>();
+        probe->SetName(Create<Name>(GlobalRoutingInfo::getPrefix(prefixId)));
+        Ptr<fib::Entry> entry = m_fib->LongestPrefixMatch(*probe);
+        if(entry == 0 || entry->m_faces.empty())
+        {
+            // No direct path known, so the detour cannot be bounded
+            routingTableMAR3[prefixId] = routingTableMAR2[prefixId];
+            continue;
+        }
+
+        int32_t directCost = entry->FindBestCandidate(0).GetRoutingCost();
+        double stretch = directCost > 0 ? (double)routingCostMAR2[prefixId] / directCost
+            : (routingCostMAR2[prefixId] > 0 ? std::numeric_limits<double>::infinity() : 1.0);
+
+        NS_LOG_DEBUG("Prefix " << GlobalRoutingInfo::getPrefix(prefixId) << ": " << routingCostMAR2[prefixId]
+                << " via monitor, " << directCost << " direct (stretch " << stretch << ")");
+
+        if(stretch <= maxDetourRatio)
+        {
+            routingTableMAR3[prefixId] = routingTableMAR2[prefixId];
+            routingStretchMAR3[prefixId] = stretch;
+        }
+    }
+
+    routingTableMAR3Version = GlobalRoutingInfo::getVersion();
 }
 
 bool MonitorAwareRouting::TrySendOutInterest (Ptr<Face> inFace, Ptr<Face> outFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry)
@@ -713,43 +979,42 @@ void MonitorAwareRouting::WillEraseTimedOutPendingInterest (Ptr<pit::Entry> pitE
 {
     super::WillEraseTimedOutPendingInterest(pitEntry);
 
+    if(detection == 4 || detection == 5)
+    {
+        BOOST_FOREACH(const pit::IncomingFace &face, pitEntry->GetIncoming())
+        {
+            faceSatisfaction.timedOut(face.m_face->GetId(), Simulator::Now().GetSeconds());
+        }
+    }
+
     if(recordStats())
     {
-        Name prefix = pitEntry->GetPrefix().getSubName(0, 1);
+        boost::shared_ptr<LocallyMonitoredTag> tag = pitEntry->GetFwTag<LocallyMonitoredTag>();
+        if(!tag || tag->empty())
+            return;
+
+        uint32_t prefixId = tag->getPrefixId();
         BOOST_FOREACH(const pit::IncomingFace &face, pitEntry->GetIncoming())
         {
             // Count the timeout for every interface the interest has been received on
-            timedOutPerFace[face.m_face]++;
-
-            std::set<Ptr<pit::Entry> >::iterator monitoredFirst = locallyMonitored[face.m_face].find(pitEntry);
-            if(monitoredFirst != locallyMonitored[face.m_face].end())
+            if(tag->remove(face.m_face->GetId()))
             {
                 // The interest on this interface has been monitored by this node first
 
-                locallyMonitored[face.m_face].erase(monitoredFirst);
                 timedOutUnmonitored++;
-                timedOutUnmonitoredPerName[prefix]++;
-                timedOutUnmonitoredPerFace[face.m_face]++;
-                timedOutUnmonitoredPerFacePerName[face.m_face][prefix]++;
 
-                // if(timedOutPrefixesPerFace[face.m_face].find(prefix) == timedOutPrefixesPerFace[face.m_face].end())
+                // if(!isTimedOutPrefix(face.m_face->GetId(), prefixId))
                 // {
-                //     std::cout << "Identified: " << prefix << " @ " << getSatisfactionRatioUnmonitored(face.m_face, prefix)
-                //         << " satU=" << satisfiedUnmonitoredPerFacePerName[face.m_face][prefix]
-                //         << " timU=" << timedOutUnmonitoredPerFacePerName[face.m_face][prefix]
-                //         << " sat=" << satisfiedPerFace[face.m_face]
-                //         << " tim=" << timedOutPerFace[face.m_face]
-                //         << std::endl;
-                //     NS_LOG_DEBUG("Identified: " << prefix << " @ " << getSatisfactionRatioUnmonitored(face.m_face, prefix)
-                //         << " satU=" << satisfiedUnmonitoredPerFacePerName[face.m_face][prefix]
-                //         << " timU=" << timedOutUnmonitoredPerFacePerName[face.m_face][prefix]
-                //         << " sat=" << satisfiedPerFace[face.m_face]
-                //         << " tim=" << timedOutPerFace[face.m_face]);
+                //     NS_LOG_DEBUG("Identified: " << unmonitoredStats.getPrefix(prefixId)
+                //         << " @ " << getSatisfactionRatioUnmonitored(face.m_face->GetId(), prefixId)
+                //         << " satU=" << unmonitoredStats.get(face.m_face->GetId(), prefixId, FacePrefixCounters::SATISFIED)
+                //         << " timU=" << unmonitoredStats.get(face.m_face->GetId(), prefixId, FacePrefixCounters::TIMED_OUT));
                 // }
 
-                // Identify the prefix as "malicious"
-                timedOutPrefixesPerFace[face.m_face].insert(prefix);
-                timedOutPrefixes.insert(prefix);
+                // Counting the timeout also identifies the prefix as "malicious"
+                unmonitoredStats.increment(face.m_face->GetId(), prefixId, FacePrefixCounters::TIMED_OUT, Simulator::Now().GetSeconds());
+                if(topKPrefixes > 0)
+                    timedOutTopKPerFace[face.m_face->GetId()].add(prefixId);
             }
 
         }
@@ -759,14 +1024,47 @@ void MonitorAwareRouting::WillEraseTimedOutPendingInterest (Ptr<pit::Entry> pitE
 
 double MonitorAwareRouting::getSatisfactionRatioUnmonitored(Ptr<Face> inFace, Name name)
 {
-    double result;
+    return getSatisfactionRatioUnmonitored(inFace->GetId(), unmonitoredStats.getPrefixId(name));
+}
 
-    if(timedOutUnmonitoredPerFacePerName[inFace][name] == 0 && satisfiedUnmonitoredPerFacePerName[inFace][name] == 0)
-        result = 1;
-    else
-        result = (double) satisfiedUnmonitoredPerFacePerName[inFace][name] / (timedOutUnmonitoredPerFacePerName[inFace][name] + satisfiedUnmonitoredPerFacePerName[inFace][name]);
+double MonitorAwareRouting::getSatisfactionRatioUnmonitored(uint32_t faceId, uint32_t prefixId)
+{
+    if(detection == 6)
+    {
+        double now = Simulator::Now().GetSeconds();
+        double satisfied = unmonitoredStats.getDecayed(faceId, prefixId, FacePrefixCounters::SATISFIED, now);
+        double timedOut = unmonitoredStats.getDecayed(faceId, prefixId, FacePrefixCounters::TIMED_OUT, now);
 
-    return result;
+        if(timedOut + satisfied <= 0)
+            return 1;
+
+        return satisfied / (timedOut + satisfied);
+    }
+
+    uint32_t satisfied = unmonitoredStats.get(faceId, prefixId, FacePrefixCounters::SATISFIED);
+    uint32_t timedOut = unmonitoredStats.get(faceId, prefixId, FacePrefixCounters::TIMED_OUT);
+
+    if(timedOut == 0 && satisfied == 0)
+        return 1;
+
+    return (double) satisfied / (timedOut + satisfied);
+}
+
+bool MonitorAwareRouting::isTimedOutPrefix(uint32_t faceId, uint32_t prefixId)
+{
+    if(topKPrefixes > 0 && (faceId >= timedOutTopKPerFace.size() || !timedOutTopKPerFace[faceId].contains(prefixId)))
+    {
+        // Only the prefixes with the most timeouts on the face are considered malicious
+        return false;
+    }
+
+    if(detection == 6)
+    {
+        // A single timeout marks the prefix for one half-life
+        return unmonitoredStats.getDecayed(faceId, prefixId, FacePrefixCounters::TIMED_OUT, Simulator::Now().GetSeconds()) >= 0.5;
+    }
+
+    return unmonitoredStats.get(faceId, prefixId, FacePrefixCounters::TIMED_OUT) > 0;
 }
 
 double MonitorAwareRouting::getPitUsage()
@@ -794,36 +1092,86 @@ MonitorAwareRouting::PerNameCounter MonitorAwareRouting::getEntriesPerNameUnmoni
 {
     MonitorAwareRouting::PerNameCounter result;
 
-    // Get the number of PIT entries that have been monitored first by this node
-    std::pair<Ptr<Face>, std::set<Ptr<pit::Entry> > > pair;
+    // Get the number of PIT entries that have been monitored first by this node (kept up to date
+    // by the LocallyMonitoredTags of the entries)
+    std::vector<std::pair<uint32_t, Name> > counts;
+    for(uint32_t prefixId = 0; prefixId < locallyMonitoredEntries->size(); prefixId++)
+    {
+        uint32_t entries = (*locallyMonitoredEntries)[prefixId].entries;
+        if(entries > 0
+                && unmonitoredStats.getPerPrefix(prefixId, FacePrefixCounters::TIMED_OUT) > 0
+                && (topKPrefixes == 0 || isTopKPrefix(prefixId)))
+            counts.push_back(std::make_pair(entries, unmonitoredStats.getPrefix(prefixId)));
+    }
 
-    std::set<Ptr<pit::Entry> > entries;
-    std::map<Name, std::set<Ptr<pit::Entry> > > entriesPerName;
+    if(topKPrefixes > 0 && counts.size() > topKPrefixes)
+    {
+        // Report only the prefixes with the most entries
+        std::partial_sort(counts.begin(), counts.begin() + topKPrefixes, counts.end(),
+                std::greater<std::pair<uint32_t, Name> >());
+        counts.resize(topKPrefixes);
+    }
 
-    BOOST_FOREACH(pair, locallyMonitored)
+    for(uint32_t i = 0; i < counts.size(); i++)
     {
-        entries.insert(pair.second.begin(), pair.second.end());
+        result[counts[i].second] = counts[i].first;
+    }
 
-        BOOST_FOREACH(const Ptr<pit::Entry> e, pair.second)
+    return result;
+}
+
+bool MonitorAwareRouting::isTopKPrefix(uint32_t prefixId)
+{
+    for(uint32_t faceId = 0; faceId < timedOutTopKPerFace.size(); faceId++)
+    {
+        if(timedOutTopKPerFace[faceId].contains(prefixId))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Free the ids of prefixes that are neither in a top-k summary nor referred to by the tag of a PIT
+ * entry, so the stats are bounded by the summaries and the PIT instead of the number of prefixes
+ * seen. Prefixes that are not in a summary are never considered malicious, losing their stats only
+ * affects the satisfaction ratio they start with once they get into a summary.
+ */
+void MonitorAwareRouting::recyclePrefixIds()
+{
+    std::vector<bool> keep(unmonitoredStats.getNPrefixes(), false);
+    for(uint32_t faceId = 0; faceId < timedOutTopKPerFace.size(); faceId++)
+    {
+        std::vector<SpaceSaving::Item> top = timedOutTopKPerFace[faceId].getTop();
+        for(uint32_t i = 0; i < top.size(); i++)
         {
-            Name prefix = e->GetPrefix().getSubName(0, 1);
-            if(timedOutPrefixes.find(prefix) != timedOutPrefixes.end())
-                entriesPerName[prefix].insert(e);
+            keep[top[i].key] = true;
         }
     }
 
-    std::pair<Name, std::set<Ptr<pit::Entry> > > entry;
-    BOOST_FOREACH(entry, entriesPerName)
+    for(uint32_t prefixId = 0; prefixId < keep.size(); prefixId++)
     {
-        result[entry.first] = entry.second.size();
+        if(!keep[prefixId]
+                && (prefixId >= locallyMonitoredEntries->size() || (*locallyMonitoredEntries)[prefixId].tags == 0))
+            unmonitoredStats.removePrefix(prefixId);
     }
 
-    return result;
+    // Amortize the sweep over at least as many new prefixes as are left
+    prefixIdLimit = std::max<uint32_t>(2 * unmonitoredStats.getNUsedPrefixes(),
+            2 * topKPrefixes * timedOutTopKPerFace.size());
 }
 
 MonitorAwareRouting::PerNameCounter MonitorAwareRouting::getTimedOutEntriesPerNameUnmonitored()
 {
-    return timedOutUnmonitoredPerName;
+    MonitorAwareRouting::PerNameCounter result;
+
+    for(uint32_t prefixId = 0; prefixId < unmonitoredStats.getNPrefixes(); prefixId++)
+    {
+        uint32_t timedOut = unmonitoredStats.getPerPrefix(prefixId, FacePrefixCounters::TIMED_OUT);
+        if(timedOut > 0)
+            result[unmonitoredStats.getPrefix(prefixId)] = timedOut;
+    }
+
+    return result;
 }
 
 void MonitorAwareRouting::resetStats()
@@ -831,10 +1179,10 @@ void MonitorAwareRouting::resetStats()
     if(!recordStats())
         return;
 
-    // Keep satisfiedNames for 10 observation periods
-    if(resetRound == 9)
+    // Keep satisfiedNames for 5 to 10 observation periods
+    if(resetRound == 4)
     {
-        satisfiedNames.clear();
+        satisfiedNames.rotate();
         resetRound = 0;
     }
     else
@@ -842,29 +1190,35 @@ void MonitorAwareRouting::resetStats()
         resetRound++;
     }
 
-    timedOutPrefixesPerFace.clear();
-    timedOutPrefixes.clear();
     requestedNames.clear();
 
     timedOutUnmonitored = 0;
     satisfiedUnmonitored = 0;
 
-    satisfiedPerFace.clear();
-    timedOutPerFace.clear();
+    unmonitoredStats.reset();
 
-    satisfiedUnmonitoredPerFace.clear();
-    timedOutUnmonitoredPerFace.clear();
-
-    satisfiedUnmonitoredPerFacePerName.clear();
-    timedOutUnmonitoredPerFacePerName.clear();
+    // Scheme 6 only considers prefixes in the summaries malicious, clearing them would discard its
+    // decaying statistics every period
+    double factor = 0;
+    if(detection == 6)
+    {
+        double elapsed = (Simulator::Now() - lastStatsReset).GetSeconds();
+        factor = halfLife.IsStrictlyPositive() ? std::pow(0.5, elapsed / halfLife.GetSeconds()) : 1;
+    }
+    lastStatsReset = Simulator::Now();
 
-    satisfiedUnmonitoredPerName.clear();
-    timedOutUnmonitoredPerName.clear();
+    for(uint32_t faceId = 0; faceId < timedOutTopKPerFace.size(); faceId++)
+    {
+        if(detection == 6)
+            timedOutTopKPerFace[faceId].decay(factor);
+        else
+            timedOutTopKPerFace[faceId].clear();
+    }
 }
 
 bool MonitorAwareRouting::recordStats()
 {
-    return (detection >= 1 && detection <= 2) || hasMonitor;
+    return (detection >= 1 && detection <= 2) || detection == 6 || hasMonitor;
 }
 
 /*
@@ -8,6 +8,12 @@
 #include "ns3/traced-callback.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/random-variable.h"
+#include "ns3/nstime.h"
+#include "face-prefix-counters.h"
+#include "recent-names.h"
+#include "space-saving.h"
+#include "face-satisfaction.h"
+#include "locally-monitored-tag.h"
 
 namespace ns3 {
 namespace ndn {
@@ -83,7 +89,23 @@ private:
     Name monitorPrefix;
     Ptr<Face> localMonitorFace;
     Ptr<Face> nearestMonitorFace;
-    std::map<Name, Ptr<Face> > routingTableMAR2;
+
+    // MAR2 routing table: best face via a monitor, indexed by GlobalRoutingInfo prefix id
+    std::vector<Ptr<Face> > routingTableMAR2;
+    // Face to the nearest monitor, used for prefixes that no monitor has reported
+    Ptr<Face> defaultRouteMAR2;
+    // Cost of the best path via a monitor (to the monitor and from there to the server) per prefix
+    std::vector<int> routingCostMAR2;
+    // GlobalRoutingInfo version the MAR2 routing table has been calculated for (0: never)
+    uint32_t routingTableMAR2Version;
+
+    // MAR3 routing table: the MAR2 route if its detour is bounded by maxDetourRatio, 0 otherwise
+    // (forward directly), and the stretch of the route (cost via monitor / direct cost). Only the
+    // first router uses it, it marks the decision in the interest (Interest::SetDetour).
+    std::vector<Ptr<Face> > routingTableMAR3;
+    std::vector<double> routingStretchMAR3;
+    uint32_t routingTableMAR3Version;
+    double maxDetourRatio;
 
     Ptr<ndn::Pit> pit;
     int pitMaxSize;
@@ -91,40 +113,52 @@ private:
     //
     // Stats
     //
-    PerFaceCounter satisfiedPerFace;
-    PerFaceCounter timedOutPerFace;
+    // Satisfied/timed out PIT entries that have been monitored by this node first, per incoming
+    // face and prefix. A prefix with timed out entries on a face is considered malicious for
+    // that face. Detection scheme 6 uses the decaying counts, which are not reset by resetStats.
+    FacePrefixCounters unmonitoredStats;
 
-    PerFaceCounter satisfiedUnmonitoredPerFace;
-    PerFaceCounter timedOutUnmonitoredPerFace;
+    // Timed out prefixes with the most timeouts per face (indexed by face id), if the number of
+    // tracked prefixes is limited. Only these are considered malicious and reported to the CC.
+    // resetStats clears them, except with detection scheme 6, where their counts decay with halfLife
+    // so that prefixes stay tracked across observation periods.
+    uint32_t topKPrefixes;
+    std::vector<SpaceSaving> timedOutTopKPerFace;
 
-    PerNameCounter satisfiedUnmonitoredPerName;
-    PerNameCounter timedOutUnmonitoredPerName;
+    // With a limited number of tracked prefixes, the ids of unmonitoredStats are recycled once
+    // this many prefixes are in use, keeping only the top-k prefixes and those of PIT entries.
+    uint32_t prefixIdLimit;
 
-    PerFacePerNameCounter satisfiedUnmonitoredPerFacePerName;
-    PerFacePerNameCounter timedOutUnmonitoredPerFacePerName;
+    // Satisfaction ratios per incoming face of all PIT entries (detection schemes 4 and 5)
+    FaceSatisfaction faceSatisfaction;
 
     // The malicious prefixes as identified by the CC
     std::set<Name> maliciousPrefixes;
 
-    // The prefixes of which PIT entries have timedout (per face)
-    std::map<Ptr<Face>, std::set<Name> > timedOutPrefixesPerFace;
-    std::set<Name> timedOutPrefixes;
-
     // To keep tack of content names that have been satisfied previously
-    std::set<Name> satisfiedNames;
+    RecentNames satisfiedNames;
 
     // To keep track of content names that have been requested before in this observation period
-    std::set<Name> requestedNames;
+    RecentNames requestedNames;
 
-    // std::set<Name> satisfiedNames is only reset every 10 observation periods. this is just a
-    // counter to keep track of that.
+    // satisfiedNames starts a new generation only every 5 observation periods, so that names are
+    // kept for 5 to 10 periods. this is just a counter to keep track of that.
     int resetRound;
+    // Time of the last resetStats, to decay timedOutTopKPerFace
+    Time lastStatsReset;
+
+    // Track names in exact sets instead of Bloom filters
+    bool exactNames;
+    // Expected number of distinct names per observation period and Bloom filter false positive rate
+    uint32_t nameFilterCapacity;
+    double nameFilterFalsePositiveRate;
 
     int satisfiedUnmonitored;
     int timedOutUnmonitored;
 
-    // To keep track of PIT entries that have been monitored by this CNMR first (per face)
-    std::map<Ptr<Face>, std::set<Ptr<pit::Entry> > > locallyMonitored;
+    // Number of PIT entries that have been monitored by this CNMR first per prefix id of
+    // unmonitoredStats. The faces are kept in a LocallyMonitoredTag of each entry.
+    boost::shared_ptr<LocallyMonitoredTag::EntryCounts> locallyMonitoredEntries;
 
     bool DoPropagateInterestOpportunistic (Ptr<Face> inFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry);
     bool DoPropagateInterestBestRoute (Ptr<Face> inFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry);
@@ -132,15 +166,23 @@ private:
     bool DoPropagateInterestMAR2 (Ptr<Face> inFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry);
     bool DoPropagateInterestMAR3 (Ptr<Face> inFace, Ptr<const Interest> interest, Ptr<pit::Entry> pitEntry);
 
+    void CalculateRoutesMAR2();
+    void CalculateRoutesMAR3();
+
     void WillEraseTimedOutPendingInterest(Ptr<pit::Entry> pitEntry);
 
     bool CanAcceptInterest(Ptr<Face> inFace, Ptr<Interest> interest);
+    bool isTimedOutPrefix(uint32_t faceId, uint32_t prefixId);
+    bool isTopKPrefix(uint32_t prefixId);
+    void recyclePrefixIds();
+    double getSatisfactionRatioUnmonitored(uint32_t faceId, uint32_t prefixId);
     bool recordStats();
 
     TracedCallback<uint32_t> entriesSatisfiedBeforeTrace;
     TracedCallback<uint32_t> maliciousRequestedMultiTrace;
     TracedCallback<double, uint32_t> pitUsageTrace;
     TracedCallback<Ptr<const Interest>, bool, bool > interestConsumedTrace;
+    TracedCallback<Ptr<const Interest>, double> pathStretchTrace;
 
     // The used detection scheme
     uint32_t detection;
@@ -148,6 +190,10 @@ private:
     // The minimum PIT usage for the dectecion schemes to kick in
     double tau;
 
+    // Half-life of the decaying statistics (detection schemes 4 to 6). Defaults to the observation
+    // period of RouterApp (1 s), not to the longer one of MonitorApp (2 s).
+    Time halfLife;
+
     UniformVariable rnd_Drop;
 
 };
@@ -29,6 +29,7 @@
 #include "ns3/ndn-fib.h"
 #include "ns3/ndn-content-store.h"
 #include "ns3/ndn-face.h"
+#include "../ndn-global-router.h"
 
 #include "ns3/assert.h"
 #include "ns3/ptr.h"
@@ -36,6 +37,10 @@
 #include "ns3/simulator.h"
 #include "ns3/boolean.h"
 #include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
 
 #include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
 
@@ -100,11 +105,28 @@ TypeId ForwardingStrategy::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&ForwardingStrategy::m_detectRetransmissions),
                    MakeBooleanChecker ())
+
+    .AddAttribute ("CachingDecision", "On-path caching decision for solicited data: "
+                                      "Always, Lcd (leave copy down), ProbCache, or Betweenness "
+                                      "(requires GlobalRoutingHelper::CalculateBetweenness)",
+                   EnumValue (CACHE_ALWAYS),
+                   MakeEnumAccessor (&ForwardingStrategy::m_cachingDecision),
+                   MakeEnumChecker (CACHE_ALWAYS, "Always",
+                                    CACHE_LCD, "Lcd",
+                                    CACHE_PROB_CACHE, "ProbCache",
+                                    CACHE_BETWEENNESS, "Betweenness"))
+
+    .AddAttribute ("ProbCacheTargetWindow", "Target time window (in number of cached copies) of ProbCache decision",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&ForwardingStrategy::m_probCacheTargetWindow),
+                   MakeDoubleChecker<double> (1.0))
     ;
   return tid;
 }
 
 ForwardingStrategy::ForwardingStrategy ()
+  : m_cachingDecision (CACHE_ALWAYS)
+  , m_probCacheTargetWindow (10.0)
 {
 }
 
@@ -252,7 +274,7 @@ ForwardingStrategy::OnData (Ptr<Face> inFace,
     }
   else
     {
-      bool cached = m_contentStore->Add (data);
+      bool cached = ShouldCacheData (inFace, data, pitEntry) && m_contentStore->Add (data);
       DidReceiveSolicitedData (inFace, data, cached);
     }
 
@@ -401,6 +423,67 @@ ForwardingStrategy::DidReceiveUnsolicitedData (Ptr<Face> inFace,
   // do nothing
 }
 
+bool
+ForwardingStrategy::ShouldCacheData (Ptr<Face> inFace,
+                                     Ptr<const Data> data,
+                                     Ptr<pit::Entry> pitEntry)
+{
+  if (m_cachingDecision == CACHE_ALWAYS)
+    return true;
+
+  FwHopCountTag interestTag;
+  FwHopCountTag dataTag;
+  if (!pitEntry->GetInterest ()->GetPayload ()->PeekPacketTag (interestTag) ||
+      !data->GetPayload ()->PeekPacketTag (dataTag) ||
+      dataTag.Get () < interestTag.Get ())
+    {
+      // no way to figure out position on the path
+      return true;
+    }
+
+  // Data carries the Interest's hop count from the source (producer or cache hit),
+  // so it travelled the same number of hops in both directions
+  uint32_t fromSource = (dataTag.Get () - interestTag.Get ()) / 2;
+  uint32_t pathLength = interestTag.Get () + fromSource;
+
+  switch (m_cachingDecision)
+    {
+    case CACHE_LCD:
+      return fromSource == 1;
+
+    case CACHE_PROB_CACHE:
+      {
+        if (fromSource == 0 || pathLength == 0)
+          return false;
+
+        double timesIn = (pathLength - fromSource + 1) / m_probCacheTargetWindow;
+        double weight = static_cast<double> (fromSource) / pathLength;
+        return m_cachingRand.GetValue () < timesIn * weight;
+      }
+
+    case CACHE_BETWEENNESS:
+      {
+        Ptr<GlobalRouter> self = GetObject<GlobalRouter> ();
+        if (self == 0)
+          return true;
+
+        BOOST_FOREACH (uint32_t nodeId, dataTag.GetHops ())
+          {
+            if (nodeId >= NodeList::GetNNodes ())
+              continue;
+
+            Ptr<GlobalRouter> other = NodeList::GetNode (nodeId)->GetObject<GlobalRouter> ();
+            if (other != 0 && other->GetBetweenness () > self->GetBetweenness ())
+              return false;
+          }
+        return true;
+      }
+
+    default:
+      return true;
+    }
+}
+
 void
 ForwardingStrategy::WillSatisfyPendingInterest (Ptr<Face> inFace,
                                                 Ptr<pit::Entry> pitEntry)
@@ -25,6 +25,7 @@
 #include "ns3/callback.h"
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
+#include "ns3/random-variable.h"
 
 namespace ns3 {
 namespace ndn {
@@ -64,6 +65,17 @@ class ForwardingStrategy :
 public:
   static TypeId GetTypeId ();
 
+  /**
+   * @brief On-path caching decision for solicited Data packets
+   */
+  enum CachingDecision
+    {
+      CACHE_ALWAYS,      ///< @brief Cache every solicited Data packet (default)
+      CACHE_LCD,         ///< @brief Leave Copy Down: cache only one hop below the source (producer or cache hit)
+      CACHE_PROB_CACHE,  ///< @brief ProbCache: cache with probability depending on the hop distance from the source
+      CACHE_BETWEENNESS  ///< @brief Cache only on the node with the highest betweenness centrality on the path
+    };
+
   /**
    * @brief Helper function to retrieve logging name for the forwarding strategy
    */
@@ -318,6 +330,22 @@ protected:
                              Ptr<const Data> data,
                              bool didCreateCacheEntry);
 
+  /**
+   * @brief Method deciding whether the solicited Data packet should be placed into the content store
+   *
+   * The decision is made according to CachingDecision attribute.  Hop distances are derived from FwHopCountTag
+   * of the pending Interest (hops from the consumer) and of the Data packet (hops from the consumer to the source
+   * and back).  If either tag is missing, the Data packet is always cached.
+   *
+   * @param inFace   incoming face of the Data packet
+   * @param data     Data packet
+   * @param pitEntry PIT entry that is about to be satisfied
+   */
+  virtual bool
+  ShouldCacheData (Ptr<Face> inFace,
+                   Ptr<const Data> data,
+                   Ptr<pit::Entry> pitEntry);
+
   /**
    * @brief Method implementing logic to suppress (collapse) similar Interests
    *
@@ -442,6 +470,10 @@ protected:
   bool m_cacheUnsolicitedData;
   bool m_detectRetransmissions;
 
+  CachingDecision m_cachingDecision;
+  double m_probCacheTargetWindow;
+  UniformVariable m_cachingRand;
+
   TracedCallback<Ptr<const Interest>,
                  Ptr<const Face> > m_outInterests; ///< @brief Transmitted interests trace
 
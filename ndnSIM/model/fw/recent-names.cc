@@ -0,0 +1,160 @@
+#include "recent-names.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE ("RecentNames");
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+RecentNames::RecentNames()
+    : exact(false)
+{
+    configure(10000, 0.001);
+}
+
+void RecentNames::configure(uint32_t capacity, double falsePositiveRate)
+{
+    this->capacity = std::max<uint32_t>(capacity, 1);
+
+    // Optimal number of bits m = -n ln(p) / ln(2)^2, rounded up to a power of two
+    double optimalBits = -(double)this->capacity * std::log(falsePositiveRate) / (std::log(2.0) * std::log(2.0));
+    nBits = BloomFilter::GetRoundedNBits((uint64_t)std::ceil(optimalBits));
+
+    // Optimal number of hashes k = m / n ln(2) for the actual number of bits
+    nHashes = std::max<uint32_t>(1, std::min<uint32_t>(16, (uint32_t)(std::floor((double)nBits / this->capacity * std::log(2.0) + 0.5))));
+
+    NS_LOG_DEBUG("Bloom filter of " << nBits << " bits and " << nHashes << " hashes for " << this->capacity
+            << " names at false positive rate " << falsePositiveRate);
+
+    allocate();
+}
+
+void RecentNames::setExact(bool exact)
+{
+    this->exact = exact;
+    allocate();
+}
+
+void RecentNames::allocate()
+{
+    // Exact sets do not need the filters
+    if(exact)
+    {
+        current.filter.Release();
+        previous.filter.Release();
+    }
+    else
+    {
+        current.filter.Resize(nBits, nHashes);
+        previous.filter.Resize(nBits, nHashes);
+    }
+    clear();
+}
+
+bool RecentNames::insert(const Name &name)
+{
+    if(contains(current, name))
+    {
+        return false;
+    }
+
+    if(exact)
+    {
+        current.names.insert(name);
+    }
+    else
+    {
+        if(current.size >= capacity)
+        {
+            // The filter is full, more names would raise the false positive rate
+            rotate();
+        }
+
+        current.filter.Insert(hash_value(name));
+    }
+
+    // Names of the previous generation are added again, so that they survive the next rotation
+    current.size++;
+    return !contains(previous, name);
+}
+
+bool RecentNames::contains(const Name &name) const
+{
+    return contains(current, name) || contains(previous, name);
+}
+
+bool RecentNames::contains(const Generation &generation, const Name &name) const
+{
+    if(generation.size == 0)
+    {
+        return false;
+    }
+
+    if(exact)
+    {
+        return generation.names.find(name) != generation.names.end();
+    }
+
+    return generation.filter.MayContain(hash_value(name));
+}
+
+void RecentNames::rotate()
+{
+    current.filter.Swap(previous.filter);
+    current.names.swap(previous.names);
+    std::swap(current.size, previous.size);
+    clear(current);
+}
+
+void RecentNames::clear()
+{
+    clear(current);
+    clear(previous);
+}
+
+void RecentNames::clear(Generation &generation)
+{
+    if(generation.size > 0)
+    {
+        generation.filter.Clear();
+        generation.names.clear();
+    }
+    generation.size = 0;
+}
+
+uint32_t RecentNames::size() const
+{
+    return current.size + previous.size;
+}
+
+size_t RecentNames::getMemoryUsage() const
+{
+    if(!exact)
+    {
+        return current.filter.GetMemoryUsage() + previous.filter.GetMemoryUsage();
+    }
+
+    // Tree node overhead (three pointers and the color) plus the name and its components
+    size_t result = 0;
+    const Generation *generations[] = {&current, &previous};
+    for(int g = 0; g < 2; g++)
+    {
+        for(std::set<Name>::const_iterator it = generations[g]->names.begin(); it != generations[g]->names.end(); it++)
+        {
+            result += 4 * sizeof(void *) + sizeof(Name);
+            for(Name::const_iterator comp = it->begin(); comp != it->end(); comp++)
+            {
+                result += sizeof(name::Component) + comp->size();
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,78 @@
+#ifndef RECENT_NAMES_H_
+#define RECENT_NAMES_H_
+
+#include "ns3/ndnSIM/ndn.cxx/name.h"
+#include "ns3/ndnSIM/utils/ndn-bloom-filter.h"
+
+#include <set>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+/**
+ * Names seen in the current or the previous generation (e.g., content names satisfied or
+ * requested recently, for MAR attack detection).
+ *
+ * By default every generation is a Bloom filter sized for a given number of names and false
+ * positive rate, so memory does not grow with the number of distinct names (attackers use a new
+ * name for every Interest). contains may then report names that have never been inserted, but
+ * never misses an inserted name. A generation that reaches its capacity is rotated early, which
+ * keeps the false positive rate bounded at the cost of a shorter memory.
+ *
+ * With setExact the generations are std::sets instead (no false positives, unbounded memory),
+ * e.g., to compare detection accuracy.
+ */
+class RecentNames
+{
+public:
+    RecentNames();
+
+    // Size each Bloom filter for capacity names at the given false positive rate (clears all names)
+    void configure(uint32_t capacity, double falsePositiveRate);
+    void setExact(bool exact);
+
+    // Returns false if the name has (probably) been inserted before in either generation
+    bool insert(const Name &name);
+    bool contains(const Name &name) const;
+
+    // Start a new generation, forgetting the names of the previous one
+    void rotate();
+    void clear();
+
+    // Number of names inserted in both generations (names reported as contained by the current
+    // Bloom filter are not counted, names inserted in both generations are counted twice)
+    uint32_t size() const;
+
+    // Approximate memory used by both generations in bytes
+    size_t getMemoryUsage() const;
+
+private:
+    struct Generation
+    {
+        Generation() : size(0) {}
+
+        BloomFilter filter;
+        std::set<Name> names;
+        uint32_t size;
+    };
+
+    void allocate();
+    bool contains(const Generation &generation, const Name &name) const;
+    void clear(Generation &generation);
+
+    bool exact;
+    uint32_t capacity;
+    uint64_t nBits;
+    uint32_t nHashes;
+
+    Generation current;
+    Generation previous;
+
+};
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,150 @@
+#include "space-saving.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+static bool compareItems(const SpaceSaving::Item &a, const SpaceSaving::Item &b)
+{
+    return a.count > b.count || (a.count == b.count && a.key < b.key);
+}
+
+SpaceSaving::SpaceSaving()
+    : capacity(0)
+{
+}
+
+void SpaceSaving::setCapacity(uint32_t capacity)
+{
+    this->capacity = capacity;
+    clear();
+}
+
+uint32_t SpaceSaving::getCapacity() const
+{
+    return capacity;
+}
+
+void SpaceSaving::add(uint32_t key, uint32_t weight)
+{
+    if(capacity == 0)
+    {
+        return;
+    }
+
+    boost::unordered_map<uint32_t, uint32_t>::iterator position = positions.find(key);
+    if(position != positions.end())
+    {
+        heap[position->second].count += weight;
+        siftDown(position->second);
+        return;
+    }
+
+    if(heap.size() < capacity)
+    {
+        Item item = {key, weight, 0};
+        heap.push_back(item);
+        positions[key] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+        return;
+    }
+
+    // Replace the key with the smallest count
+    positions.erase(heap[0].key);
+    heap[0].key = key;
+    heap[0].error = heap[0].count;
+    heap[0].count += weight;
+    positions[key] = 0;
+    siftDown(0);
+}
+
+bool SpaceSaving::contains(uint32_t key) const
+{
+    return positions.find(key) != positions.end();
+}
+
+uint32_t SpaceSaving::getCount(uint32_t key) const
+{
+    boost::unordered_map<uint32_t, uint32_t>::const_iterator position = positions.find(key);
+    return position == positions.end() ? 0 : heap[position->second].count;
+}
+
+std::vector<SpaceSaving::Item> SpaceSaving::getTop() const
+{
+    std::vector<Item> result(heap);
+    std::sort(result.begin(), result.end(), compareItems);
+    return result;
+}
+
+uint32_t SpaceSaving::size() const
+{
+    return heap.size();
+}
+
+void SpaceSaving::decay(double factor)
+{
+    // Scaling is monotonic, so the heap order is kept
+    for(uint32_t i = 0; i < heap.size(); i++)
+    {
+        heap[i].count = static_cast<uint32_t>(heap[i].count * factor + 0.5);
+        heap[i].error = std::min(heap[i].count, static_cast<uint32_t>(heap[i].error * factor + 0.5));
+    }
+}
+
+void SpaceSaving::clear()
+{
+    heap.clear();
+    positions.clear();
+}
+
+void SpaceSaving::siftUp(uint32_t index)
+{
+    while(index > 0)
+    {
+        uint32_t parent = (index - 1) / 2;
+        if(heap[parent].count <= heap[index].count)
+        {
+            break;
+        }
+        swapItems(parent, index);
+        index = parent;
+    }
+}
+
+void SpaceSaving::siftDown(uint32_t index)
+{
+    while(true)
+    {
+        uint32_t smallest = index;
+        uint32_t left = 2 * index + 1;
+        uint32_t right = left + 1;
+
+        if(left < heap.size() && heap[left].count < heap[smallest].count)
+        {
+            smallest = left;
+        }
+        if(right < heap.size() && heap[right].count < heap[smallest].count)
+        {
+            smallest = right;
+        }
+        if(smallest == index)
+        {
+            break;
+        }
+        swapItems(smallest, index);
+        index = smallest;
+    }
+}
+
+void SpaceSaving::swapItems(uint32_t a, uint32_t b)
+{
+    std::swap(heap[a], heap[b]);
+    positions[heap[a].key] = a;
+    positions[heap[b].key] = b;
+}
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
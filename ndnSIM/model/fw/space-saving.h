@@ -0,0 +1,70 @@
+#ifndef SPACE_SAVING_H_
+#define SPACE_SAVING_H_
+
+#include <boost/unordered_map.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace fw {
+
+/**
+ * Approximate top-k of the most frequent keys (e.g., prefix ids of timed out PIT entries) in
+ * fixed memory, using the Space-Saving algorithm (Metwally et al., 2005).
+ *
+ * At most capacity keys are tracked. A new key replaces the key with the smallest count and
+ * inherits its count, which is recorded as the error of the new key. Counts are therefore
+ * overestimated by at most error, and every key occurring more often than total / capacity
+ * is tracked.
+ *
+ * Keys are kept in a binary min-heap by count, so an update is O(log capacity).
+ */
+class SpaceSaving
+{
+public:
+    struct Item
+    {
+        uint32_t key;
+        uint32_t count;
+        uint32_t error;
+    };
+
+    SpaceSaving();
+
+    // Set the number of tracked keys (clears all keys)
+    void setCapacity(uint32_t capacity);
+    uint32_t getCapacity() const;
+
+    void add(uint32_t key, uint32_t weight = 1);
+
+    bool contains(uint32_t key) const;
+    // Overestimated count of the key (0 if the key is not tracked)
+    uint32_t getCount(uint32_t key) const;
+
+    // Tracked keys by decreasing count
+    std::vector<Item> getTop() const;
+    uint32_t size() const;
+
+    // Scale all counts and errors by factor (rounded), keeping the tracked keys
+    void decay(double factor);
+    void clear();
+
+private:
+    void siftUp(uint32_t index);
+    void siftDown(uint32_t index);
+    void swapItems(uint32_t a, uint32_t b);
+
+    uint32_t capacity;
+
+    // Min-heap by count and the position of every key in it
+    std::vector<Item> heap;
+    boost::unordered_map<uint32_t, uint32_t> positions;
+
+};
+
+} // namespace fw
+} // namespace ndn
+} // namespace ns3
+
+#endif
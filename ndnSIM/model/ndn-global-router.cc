@@ -46,6 +46,7 @@ GlobalRouter::GetTypeId ()
 }
 
 GlobalRouter::GlobalRouter ()
+  : m_betweenness (0)
 {
   m_id = m_idCounter;
   m_idCounter ++;
@@ -97,6 +98,18 @@ GlobalRouter::GetLocalPrefixes () const
   return m_localPrefixes;
 }
 
+void
+GlobalRouter::SetBetweenness (double betweenness)
+{
+  m_betweenness = betweenness;
+}
+
+double
+GlobalRouter::GetBetweenness () const
+{
+  return m_betweenness;
+}
+
 // void
 // GlobalRouter::AddIncidencyChannel (Ptr< NdnFace > face, Ptr< Channel > channel)
 // {
@@ -111,6 +111,18 @@ public:
   const LocalPrefixList &
   GetLocalPrefixes () const;
 
+  /**
+   * @brief Set betweenness centrality of the node (calculated by GlobalRoutingHelper)
+   */
+  void
+  SetBetweenness (double betweenness);
+
+  /**
+   * @brief Get betweenness centrality of the node (0 if it has not been calculated)
+   */
+  double
+  GetBetweenness () const;
+
   // ??
 protected:
   virtual void
@@ -122,6 +134,7 @@ private:
   Ptr<L3Protocol> m_ndn;
   LocalPrefixList m_localPrefixes;
   IncidencyList m_incidencies;
+  double m_betweenness;
 
   static uint32_t m_idCounter;
 };
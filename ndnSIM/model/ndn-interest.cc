@@ -37,6 +37,7 @@ Interest::Interest (Ptr<Packet> payload/* = Create<Packet> ()*/)
   , m_nackType (NORMAL_INTEREST)
   , m_monitored (0)
   , m_served (0)
+  , m_detour (DETOUR_UNDECIDED)
   , m_exclude (0)
   , m_payload (payload)
   , m_wire (0)
@@ -55,6 +56,7 @@ Interest::Interest (const Interest &interest)
   , m_nackType         (interest.m_nackType)
   , m_monitored        (interest.m_monitored)
   , m_served           (interest.m_served)
+  , m_detour           (interest.m_detour)
   , m_exclude          (interest.m_exclude ? Create<Exclude> (*interest.GetExclude ()) : 0)
   , m_payload          (interest.GetPayload ()->Copy ())
   , m_wire             (0)
@@ -62,6 +64,23 @@ Interest::Interest (const Interest &interest)
   NS_LOG_FUNCTION ("correct copy constructor");
 }
 
+Ptr<Interest>
+Interest::Derive () const
+{
+  Ptr<Interest> interest = Create<Interest> (m_payload);
+  interest->m_name             = m_name;
+  interest->m_scope            = m_scope;
+  interest->m_interestLifetime = m_interestLifetime;
+  interest->m_nonce            = m_nonce;
+  interest->m_nackType         = m_nackType;
+  interest->m_monitored        = m_monitored;
+  interest->m_served           = m_served;
+  interest->m_detour           = m_detour;
+  interest->m_exclude          = m_exclude;
+
+  return interest;
+}
+
 void
 Interest::SetName (Ptr<Name> name)
 {
@@ -154,6 +173,19 @@ Interest::GetServed () const
   return m_served;
 }
 
+void
+Interest::SetDetour (uint8_t detour)
+{
+  m_detour = detour;
+  m_wire = 0;
+}
+
+uint8_t
+Interest::GetDetour () const
+{
+  return m_detour;
+}
+
 void
 Interest::SetNack (uint8_t nackType)
 {
@@ -55,6 +55,18 @@ public:
    */
   Interest (const Interest &interest);
 
+  /**
+   * @brief Create a lightweight copy of the interest (e.g., to change its flags when forwarding)
+   *
+   * Unlike the copy constructor, the copy shares name, exclude filter and payload (including its
+   * packet tags) with this interest, only the fixed-size fields are copied.  Shared parts are
+   * never modified in place: Set* methods of the copy replace them without affecting this
+   * interest.  Packet tags must not be added to or removed from the payload of the copy directly,
+   * use SetPayload with a copy of the payload instead.
+   */
+  Ptr<Interest>
+  Derive () const;
+
   /**
    * \brief Set interest name
    *
@@ -156,6 +168,23 @@ public:
   SetServed (uint32_t served);
   uint32_t
   GetServed () const;
+
+  /**
+   * @brief MAR-3 routing decision of the first router
+   * The first router decides whether an unmonitored Interest takes the detour via a monitor, so
+   * that later routers complete the decision instead of taking their own.
+   */
+  enum
+    {
+      DETOUR_UNDECIDED = 0,
+      DETOUR_MONITOR = 1,
+      DETOUR_DIRECT = 2,
+    };
+
+  void
+  SetDetour (uint8_t detour);
+  uint8_t
+  GetDetour () const;
   
   /**
    * @brief NACK Type
@@ -252,6 +281,7 @@ private:
 
   uint8_t  m_monitored;
   uint8_t  m_served;
+  uint8_t  m_detour;
 
   Ptr<Exclude> m_exclude;   ///< @brief Exclude filter
   Ptr<Packet> m_payload;    ///< @brief virtual payload
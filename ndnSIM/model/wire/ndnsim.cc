@@ -104,7 +104,7 @@ Interest::GetSerializedSize (void) const
   size_t size =
     1/*version*/ + 1 /*type*/ + 2/*length*/ +
     (4/*nonce*/ + 1/*scope*/ + 1/*nack type*/ + 2/*timestamp*/ +
-     1/*monitored*/ + 1/*served*/ +
+     1/*monitored*/ + 1/*served*/ + 1/*detour*/ +
      NdnSim::SerializedSizeName (m_interest->GetName ()) +
 
      (2 +
@@ -127,6 +127,7 @@ Interest::Serialize (Buffer::Iterator start) const
 
   start.WriteU8 (m_interest->GetMonitored());
   start.WriteU8 (m_interest->GetServed());
+  start.WriteU8 (m_interest->GetDetour());
 
   start.WriteU32 (m_interest->GetNonce ());
   start.WriteU8 (m_interest->GetScope ());
@@ -169,6 +170,7 @@ Interest::Deserialize (Buffer::Iterator start)
 
   m_interest->SetMonitored (i.ReadU8 ());
   m_interest->SetServed (i.ReadU8 ());
+  m_interest->SetDetour (i.ReadU8 ());
   
   m_interest->SetNonce (i.ReadU32 ());
   m_interest->SetScope (i.ReadU8 ());
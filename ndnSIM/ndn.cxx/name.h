@@ -20,6 +20,8 @@
 
 #include "name-component.h"
 
+#include <boost/functional/hash.hpp>
+
 NDN_NAMESPACE_BEGIN
 
 /**
@@ -415,6 +417,21 @@ operator >> (std::istream &is, Name &name)
   return is;
 }
 
+/**
+ * @brief Hash of the full name (e.g., for exact-match indexes)
+ */
+inline std::size_t
+hash_value (const Name &name)
+{
+  std::size_t seed = 0;
+  for (Name::const_iterator comp = name.begin (); comp != name.end (); comp++)
+    {
+      boost::hash_combine (seed, comp->size ());
+      boost::hash_range (seed, comp->begin (), comp->end ());
+    }
+  return seed;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 // Definition of inline methods
 /////////////////////////////////////////////////////////////////////////////////////
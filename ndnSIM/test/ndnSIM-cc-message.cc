@@ -0,0 +1,211 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndnSIM-cc-message.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/utils/cc-message.h"
+
+#include <boost/lexical_cast.hpp>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.CCMessageTest");
+
+namespace ns3
+{
+
+using ndn::CCMessageEncoder;
+using ndn::CCMessageDecoder;
+
+typedef std::map<ndn::Name, uint32_t> PerNameCounter;
+
+static ndn::Name
+PrefixName (uint32_t i)
+{
+  return ndn::Name ("/prefix" + boost::lexical_cast<std::string> (i));
+}
+
+void
+CCMessageTest::DoRun ()
+{
+  CCMessageEncoder encoder;
+  CCMessageDecoder decoder;
+
+  // reports and prefix sets survive a round trip
+  PerNameCounter counts;
+  counts[ndn::Name ("/evil")] = 300;
+  counts[ndn::Name ("/good/a")] = 0;
+  counts[ndn::Name ("/")] = 1;
+
+  std::string first = encoder.encode (1, counts);
+  PerNameCounter decoded;
+  NS_TEST_ASSERT_MSG_EQ (decoder.decode (1, first, decoded), true, "Report should be decoded");
+  NS_TEST_ASSERT_MSG_EQ ((decoded == counts), true, "Report should survive the round trip");
+
+  std::set<ndn::Name> prefixes;
+  prefixes.insert (ndn::Name ("/evil"));
+  prefixes.insert (ndn::Name ("/other/b"));
+
+  std::string second = encoder.encode (2, prefixes);
+  std::set<ndn::Name> decodedPrefixes;
+  NS_TEST_ASSERT_MSG_EQ (decoder.decode (2, second, decodedPrefixes), true, "Prefixes should be decoded");
+  NS_TEST_ASSERT_MSG_EQ ((decodedPrefixes == prefixes), true, "Prefixes should survive the round trip");
+
+  // names are sent as ids only after the message with their definition has been acknowledged
+  NS_TEST_ASSERT_MSG_EQ (encoder.encode (3, counts).size (), first.size (),
+                         "Names should be defined until acknowledged");
+  encoder.acknowledge (1);
+  std::string idsOnly = encoder.encode (4, counts);
+  NS_TEST_ASSERT_MSG_LT (idsOnly.size (), first.size (), "Acknowledged names should be sent as ids");
+  NS_TEST_ASSERT_MSG_EQ (idsOnly.size (), 1 + 3 + (2 + 1 + 1), "Entries should be an id and a count");
+  decoded.clear ();
+  NS_TEST_ASSERT_MSG_EQ (decoder.decode (4, idsOnly, decoded), true, "Ids should be decoded");
+  NS_TEST_ASSERT_MSG_EQ ((decoded == counts), true, "Ids should be decoded to the defined names");
+
+  // a fresh decoder does not know the ids
+  CCMessageDecoder fresh;
+  NS_TEST_ASSERT_MSG_EQ (fresh.decode (4, idsOnly, decoded), false, "Undefined ids should be rejected");
+
+  // the message defining /lost is lost, the ack of a newer message gives up its definition
+  PerNameCounter lost;
+  lost[ndn::Name ("/lost")] = 5;
+  encoder.encode (5, lost);
+  encoder.encode (6, counts);
+  encoder.acknowledge (6);
+  decoded.clear ();
+  NS_TEST_ASSERT_MSG_EQ (decoder.decode (7, encoder.encode (7, lost), decoded), true,
+                         "Name of a lost message should be defined again");
+  NS_TEST_ASSERT_MSG_EQ (decoded[ndn::Name ("/lost")], 5, "Wrong count");
+
+  // several messages are sent before an ack arrives, some of them are lost, the others arrive
+  // in reverse order
+  CCMessageEncoder reordering;
+  CCMessageDecoder receiver;
+  uint32_t seq = 0;
+  for (uint32_t round = 0; round < 5; round++)
+    {
+      std::vector<std::string> messages;
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          PerNameCounter report;
+          for (uint32_t prefix = (seq + i) / 2; prefix < (seq + i) / 2 + 5; prefix++)
+            {
+              report[PrefixName (prefix)] = seq + i;
+            }
+          messages.push_back (reordering.encode (seq + i, report));
+        }
+
+      // the first message of the round is lost
+      for (uint32_t i = messages.size () - 1; i > 0; i--)
+        {
+          decoded.clear ();
+          NS_TEST_ASSERT_MSG_EQ (receiver.decode (seq + i, messages[i], decoded), true,
+                                 "Message " << seq + i << " should not refer to an undefined id");
+          NS_TEST_ASSERT_MSG_EQ (decoded.size (), 5, "Wrong number of entries");
+          NS_TEST_ASSERT_MSG_EQ (decoded[PrefixName ((seq + i) / 2)], seq + i, "Wrong count");
+        }
+
+      // only the ack of the second message arrives
+      reordering.acknowledge (seq + 1);
+      seq += messages.size ();
+    }
+
+  // more prefixes than ids: the least recently used ids are recycled and defined again
+  CCMessageEncoder large;
+  CCMessageDecoder largeReceiver;
+  const uint32_t nPrefixes = CCMessageDecoder::MAX_PREFIXES + 5000;
+  const uint32_t batch = 1000;
+  uint32_t received = 0;
+  for (uint32_t first = 0; first < nPrefixes; first += batch)
+    {
+      std::set<ndn::Name> batchPrefixes;
+      for (uint32_t prefix = first; prefix < std::min (first + batch, nPrefixes); prefix++)
+        {
+          batchPrefixes.insert (PrefixName (prefix));
+        }
+
+      uint32_t batchSeq = first / batch;
+      std::set<ndn::Name> batchDecoded;
+      NS_TEST_ASSERT_MSG_EQ (largeReceiver.decode (batchSeq, large.encode (batchSeq, batchPrefixes), batchDecoded), true,
+                             "Message " << batchSeq << " should be decoded");
+      NS_TEST_ASSERT_MSG_EQ ((batchDecoded == batchPrefixes), true, "Message " << batchSeq << " should be decoded to its prefixes");
+      received += batchDecoded.size ();
+      large.acknowledge (batchSeq);
+    }
+  NS_TEST_ASSERT_MSG_EQ (received, nPrefixes, "All prefixes should be decoded");
+
+  // the first prefixes lost their ids, the last ones are still known
+  std::set<ndn::Name> recycled;
+  recycled.insert (PrefixName (0));
+  recycled.insert (PrefixName (nPrefixes - 1));
+  std::set<ndn::Name> recycledDecoded;
+  uint32_t recycledSeq = nPrefixes / batch + 1;
+  std::string recycledMessage = large.encode (recycledSeq, recycled);
+  NS_TEST_ASSERT_MSG_EQ (largeReceiver.decode (recycledSeq, recycledMessage, recycledDecoded), true,
+                         "Recycled ids should be decoded");
+  NS_TEST_ASSERT_MSG_EQ ((recycledDecoded == recycled), true, "Recycled ids should be decoded to the new prefixes");
+  NS_TEST_ASSERT_MSG_LT (recycledMessage.size (), CCMessageEncoder ().encode (0, recycled).size (),
+                         "Only the recycled prefix should be defined");
+
+  // a late message refers to an id that has been recycled since, it is rejected rather than
+  // decoded to the new prefix
+  CCMessageEncoder small (2);
+  CCMessageDecoder smallReceiver;
+  std::set<ndn::Name> ab;
+  ab.insert (ndn::Name ("/a"));
+  ab.insert (ndn::Name ("/b"));
+  std::set<ndn::Name> smallDecoded;
+  NS_TEST_ASSERT_MSG_EQ (smallReceiver.decode (1, small.encode (1, ab), smallDecoded), true, "Definitions should be decoded");
+  small.acknowledge (1);
+
+  std::set<ndn::Name> b;
+  b.insert (ndn::Name ("/b"));
+  std::string late = small.encode (2, b);
+
+  // /a is sent as its id, /c takes the id of /b
+  std::set<ndn::Name> ac;
+  ac.insert (ndn::Name ("/c"));
+  ac.insert (ndn::Name ("/a"));
+  smallDecoded.clear ();
+  NS_TEST_ASSERT_MSG_EQ (smallReceiver.decode (3, small.encode (3, ac), smallDecoded), true, "Recycled ids should be decoded");
+  NS_TEST_ASSERT_MSG_EQ ((smallDecoded == ac), true, "Recycled ids should be decoded to the new prefixes");
+  smallDecoded.clear ();
+  NS_TEST_ASSERT_MSG_EQ (smallReceiver.decode (2, late, smallDecoded), false,
+                         "Late message with a recycled id should be rejected");
+
+  // /b takes the id of /c in a message that is lost, the ack of the message that defined /c
+  // does not make the id known
+  small.encode (4, ab);
+  small.acknowledge (3);
+  smallDecoded.clear ();
+  NS_TEST_ASSERT_MSG_EQ (smallReceiver.decode (5, small.encode (5, ab), smallDecoded), true, "Message should be decoded");
+  NS_TEST_ASSERT_MSG_EQ ((smallDecoded == ab), true, "Recycled id should be defined again");
+
+  // malformed input is rejected
+  CCMessageDecoder strict;
+  std::string valid = CCMessageEncoder ().encode (0, counts);
+  for (uint32_t length = 0; length < valid.size (); length++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (strict.decode (0, valid.substr (0, length), decoded), false,
+                             "Truncated message of " << length << " bytes should be rejected");
+    }
+  NS_TEST_ASSERT_MSG_EQ (strict.decode (0, valid + '\x00', decoded), false, "Trailing bytes should be rejected");
+
+  // varint of more than 32 bits, and one that does not end
+  NS_TEST_ASSERT_MSG_EQ (strict.decode (0, std::string ("\x01\xff\xff\xff\xff\x1f", 6), decoded), false,
+                         "Varint overflow should be rejected");
+  NS_TEST_ASSERT_MSG_EQ (strict.decode (0, std::string ("\x01\x81\x80\x80\x80\x80\x01", 7), decoded), false,
+                         "Varint of more than 5 bytes should be rejected");
+
+  // one entry defining id 0 with one component longer than the rest of the message
+  NS_TEST_ASSERT_MSG_EQ (strict.decode (0, std::string ("\x01\x01\x01\x05" "abc", 7), decoded), false,
+                         "Component longer than the message should be rejected");
+  NS_TEST_ASSERT_MSG_EQ (strict.decode (0, std::string ("\x01\x01\x01\x03" "abc" "\x02", 8), decoded), true,
+                         "Component fitting the message should be accepted");
+
+  // definition of id MAX_PREFIXES: key (MAX_PREFIXES << 1 | 1) = 0x20001
+  NS_TEST_ASSERT_MSG_EQ (strict.decode (0, std::string ("\x01\x81\x80\x08\x01\x01" "a" "\x02", 8), decoded), false,
+                         "Ids from MAX_PREFIXES on should be rejected");
+  NS_TEST_ASSERT_MSG_EQ (strict.decode (0, std::string ("\x01\xff\xff\x07\x01\x01" "a" "\x02", 8), decoded), true,
+                         "Id MAX_PREFIXES - 1 should be accepted");
+}
+
+}
@@ -0,0 +1,24 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDNSIM_TEST_CC_MESSAGE_H
+#define NDNSIM_TEST_CC_MESSAGE_H
+
+#include "ns3/test.h"
+
+namespace ns3 {
+
+class CCMessageTest : public TestCase
+{
+public:
+  CCMessageTest ()
+    : TestCase ("CC message dictionary encoding test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+}
+
+#endif // NDNSIM_TEST_CC_MESSAGE_H
@@ -0,0 +1,93 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndnSIM-cs-freshness.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.CsFreshnessTest");
+
+namespace ns3
+{
+
+void
+CsFreshnessTest::Add (Ptr<ndn::ContentStore> cs, const std::string &name, double freshness)
+{
+  Ptr<ndn::Data> data = Create<ndn::Data> (Create<Packet> ());
+  data->SetName (Create<ndn::Name> (name));
+  data->SetFreshness (Seconds (freshness));
+
+  NS_TEST_ASSERT_MSG_EQ (cs->Add (data), true, "Data " << name << " should be added to the cache");
+}
+
+void
+CsFreshnessTest::CheckHit (Ptr<ndn::ContentStore> cs, const std::string &name, const std::string &expected)
+{
+  Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+  interest->SetName (Create<ndn::Name> (name));
+
+  Ptr<ndn::Data> data = cs->Lookup (interest);
+  NS_TEST_ASSERT_MSG_EQ ((data != 0), true, "Interest " << name << " should be satisfied from the cache");
+  if (data != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (data->GetName (), ndn::Name (expected), "Wrong Data returned for " << name);
+    }
+}
+
+void
+CsFreshnessTest::CheckMiss (Ptr<ndn::ContentStore> cs, const std::string &name)
+{
+  Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+  interest->SetName (Create<ndn::Name> (name));
+
+  Ptr<ndn::Data> data = cs->Lookup (interest);
+  NS_TEST_ASSERT_MSG_EQ ((data == 0), true, "Stale Data should never be returned for " << name);
+}
+
+void
+CsFreshnessTest::CheckSize (Ptr<ndn::ContentStore> cs, uint32_t size)
+{
+  NS_TEST_ASSERT_MSG_EQ (cs->GetSize (), size, "Wrong number of entries in the cache");
+}
+
+void
+CsFreshnessTest::DoRun ()
+{
+  ObjectFactory factory ("ns3::ndn::cs::Freshness::Lru");
+  factory.Set ("MaxSize", StringValue ("100"));
+  // very coarse wheel, so lookups happen before the expired entries are cleaned up
+  factory.Set ("ExpirationResolution", StringValue ("10s"));
+
+  Ptr<ndn::ContentStore> cs = factory.Create<ndn::ContentStore> ();
+
+  Simulator::Schedule (Seconds (0.0), &CsFreshnessTest::Add, this, cs, "/a", 1.0);
+  Simulator::Schedule (Seconds (0.0), &CsFreshnessTest::Add, this, cs, "/b", 0.0);
+  Simulator::Schedule (Seconds (0.0), &CsFreshnessTest::Add, this, cs, "/c/1", 1.0);
+  Simulator::Schedule (Seconds (0.0), &CsFreshnessTest::Add, this, cs, "/c/2", 100.0);
+  Simulator::Schedule (Seconds (0.0), &CsFreshnessTest::Add, this, cs, "/d", 300.0);
+
+  Simulator::Schedule (Seconds (0.5), &CsFreshnessTest::CheckHit, this, cs, "/a", "/a");
+  Simulator::Schedule (Seconds (0.5), &CsFreshnessTest::CheckHit, this, cs, "/c/1", "/c/1");
+  Simulator::Schedule (Seconds (0.6), &CsFreshnessTest::CheckSize, this, cs, 5);
+
+  // expired, but the wheel has not reached them yet
+  Simulator::Schedule (Seconds (1.0), &CsFreshnessTest::CheckMiss, this, cs, "/a");
+  Simulator::Schedule (Seconds (2.0), &CsFreshnessTest::CheckMiss, this, cs, "/c/1");
+  Simulator::Schedule (Seconds (2.0), &CsFreshnessTest::CheckHit, this, cs, "/c", "/c/2");
+  Simulator::Schedule (Seconds (2.0), &CsFreshnessTest::CheckHit, this, cs, "/b", "/b");
+
+  // the wheel has cleaned up everything that expired
+  Simulator::Schedule (Seconds (25.0), &CsFreshnessTest::CheckSize, this, cs, 3);
+  Simulator::Schedule (Seconds (150.0), &CsFreshnessTest::CheckMiss, this, cs, "/c");
+  Simulator::Schedule (Seconds (150.0), &CsFreshnessTest::CheckSize, this, cs, 2);
+
+  // long-lived entry stays until it expires
+  Simulator::Schedule (Seconds (299.0), &CsFreshnessTest::CheckHit, this, cs, "/d", "/d");
+  Simulator::Schedule (Seconds (301.0), &CsFreshnessTest::CheckMiss, this, cs, "/d");
+  Simulator::Schedule (Seconds (320.0), &CsFreshnessTest::CheckSize, this, cs, 1);
+
+  Simulator::Stop (Seconds (400.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+}
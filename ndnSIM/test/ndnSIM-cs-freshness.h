@@ -0,0 +1,34 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDNSIM_TEST_CS_FRESHNESS_H
+#define NDNSIM_TEST_CS_FRESHNESS_H
+
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+namespace ndn {
+class ContentStore;
+}
+
+class CsFreshnessTest : public TestCase
+{
+public:
+  CsFreshnessTest ()
+    : TestCase ("Content store with freshness test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void Add (Ptr<ndn::ContentStore> cs, const std::string &name, double freshness);
+  void CheckHit (Ptr<ndn::ContentStore> cs, const std::string &name, const std::string &expected);
+  void CheckMiss (Ptr<ndn::ContentStore> cs, const std::string &name);
+  void CheckSize (Ptr<ndn::ContentStore> cs, uint32_t size);
+};
+
+}
+
+#endif // NDNSIM_TEST_CS_FRESHNESS_H
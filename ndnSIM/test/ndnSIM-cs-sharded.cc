@@ -0,0 +1,80 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndnSIM-cs-sharded.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/model/cs/content-store-sharded.h"
+#include "ns3/ndnSIM/utils/trie/lru-policy.h"
+
+#include <boost/lexical_cast.hpp>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.CsShardedTest");
+
+namespace ns3
+{
+
+typedef ndn::cs::ContentStoreSharded<ndn::ndnSIM::lru_policy_traits> ShardedLru;
+
+static Ptr<ShardedLru>
+CreateSharded (const std::string &maxSize, const std::string &shards)
+{
+  ObjectFactory factory ("ns3::ndn::cs::Sharded::Lru");
+  factory.Set ("MaxSize", StringValue (maxSize));
+  factory.Set ("Shards", StringValue (shards));
+  return factory.Create<ShardedLru> ();
+}
+
+static uint32_t
+GetCapacity (Ptr<ShardedLru> cs)
+{
+  uint32_t capacity = 0;
+  for (uint32_t index = 0; index < cs->GetNShards (); index++)
+    {
+      UintegerValue maxSize;
+      cs->GetShard (index)->GetAttribute ("MaxSize", maxSize);
+      capacity += maxSize.Get ();
+    }
+  return capacity;
+}
+
+static void
+Fill (Ptr<ShardedLru> cs, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<ndn::Data> data = Create<ndn::Data> (Create<Packet> (100));
+      data->SetName (Create<ndn::Name> ("/sharded/" + boost::lexical_cast<std::string> (i)));
+      cs->Add (data);
+    }
+}
+
+void
+CsShardedTest::DoRun ()
+{
+  Ptr<ShardedLru> cs = CreateSharded ("20", "8");
+  NS_TEST_ASSERT_MSG_EQ (cs->GetNShards (), 8, "Wrong number of shards");
+  NS_TEST_ASSERT_MSG_EQ (GetCapacity (cs), 20, "MaxSize should be split between the shards");
+  cs->Dispose ();
+
+  // fewer entries than shards: every used shard gets one entry
+  cs = CreateSharded ("3", "8");
+  NS_TEST_ASSERT_MSG_EQ (cs->GetNShards (), 3, "Only MaxSize shards should be used");
+  NS_TEST_ASSERT_MSG_EQ (GetCapacity (cs), 3, "Total capacity should not exceed MaxSize");
+
+  UintegerValue shards;
+  cs->GetAttribute ("Shards", shards);
+  NS_TEST_ASSERT_MSG_EQ (shards.Get (), 8, "Configured number of shards should be kept");
+
+  Fill (cs, 50);
+  NS_TEST_ASSERT_MSG_EQ (cs->GetSize (), 3, "Content store should hold at most MaxSize entries");
+  cs->Dispose ();
+
+  // no limit
+  cs = CreateSharded ("0", "8");
+  NS_TEST_ASSERT_MSG_EQ (cs->GetNShards (), 8, "All shards should be used without a limit");
+  Fill (cs, 50);
+  NS_TEST_ASSERT_MSG_EQ (cs->GetSize (), 50, "Content store without a limit should keep all entries");
+  cs->Dispose ();
+}
+
+}
@@ -0,0 +1,24 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDNSIM_TEST_CS_SHARDED_H
+#define NDNSIM_TEST_CS_SHARDED_H
+
+#include "ns3/test.h"
+
+namespace ns3 {
+
+class CsShardedTest : public TestCase
+{
+public:
+  CsShardedTest ()
+    : TestCase ("Sharded content store capacity test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+}
+
+#endif // NDNSIM_TEST_CS_SHARDED_H
@@ -0,0 +1,184 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndnSIM-cs-tiered.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndn-wire.h"
+#include "ns3/ndnSIM/model/cs/mapped-data-log.h"
+#include "ns3/ndnSIM/model/cs/content-store-tiered.h"
+#include "ns3/ndnSIM/utils/trie/lru-policy.h"
+
+NS_LOG_COMPONENT_DEFINE ("ndn.CsTieredTest");
+
+namespace ns3
+{
+
+using ndn::cs::MappedDataLog;
+
+typedef ndn::cs::ContentStoreTiered<ndn::ndnSIM::lru_policy_traits> TieredLru;
+
+static Ptr<ndn::Data>
+CreateData (const std::string &name)
+{
+  Ptr<ndn::Data> data = Create<ndn::Data> (Create<Packet> (100));
+  data->SetName (Create<ndn::Name> (name));
+  return data;
+}
+
+static Ptr<ndn::Interest>
+CreateInterest (const std::string &name)
+{
+  Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+  interest->SetName (Create<ndn::Name> (name));
+  return interest;
+}
+
+static size_t
+SameDigest (const ndn::Name &name)
+{
+  return 42;
+}
+
+void
+MappedDataLogTest::DoRun ()
+{
+  uint32_t length = ndn::Wire::FromData (CreateData ("/r/1"))->GetSize ();
+
+  // room for two and a half records
+  MappedDataLog log;
+  log.Open ("", 2 * length + length / 2);
+
+  NS_TEST_ASSERT_MSG_EQ (log.Append (CreateData ("/r/1")), true, "Data should be appended");
+  NS_TEST_ASSERT_MSG_EQ (log.Append (CreateData ("/r/2")), true, "Data should be appended");
+  NS_TEST_ASSERT_MSG_EQ (log.GetUsedBytes (), 2 * length, "Wrong number of used bytes");
+
+  // does not fit till the end of the log, overwrites /r/1
+  NS_TEST_ASSERT_MSG_EQ (log.Append (CreateData ("/r/3")), true, "Data should be appended");
+  NS_TEST_ASSERT_MSG_EQ (log.GetSize (), 2, "Oldest record should be dropped when the log wraps around");
+  NS_TEST_ASSERT_MSG_EQ ((log.Extract (ndn::Name ("/r/1")) == 0), true, "Overwritten record should be gone");
+
+  // overwrites /r/2
+  NS_TEST_ASSERT_MSG_EQ (log.Append (CreateData ("/r/4")), true, "Data should be appended");
+  NS_TEST_ASSERT_MSG_EQ ((log.Extract (ndn::Name ("/r/2")) == 0), true, "Overwritten record should be gone");
+
+  Ptr<ndn::Data> data = log.Extract (ndn::Name ("/r/3"));
+  NS_TEST_ASSERT_MSG_EQ ((data != 0), true, "Record should survive the wrap around");
+  if (data != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (data->GetName (), ndn::Name ("/r/3"), "Wrong Data extracted");
+      NS_TEST_ASSERT_MSG_EQ (data->GetPayload ()->GetSize (), 100, "Payload should be preserved");
+    }
+
+  // prefix match
+  data = log.ExtractMatching (ndn::Name ("/r"));
+  NS_TEST_ASSERT_MSG_EQ ((data != 0), true, "Record should be found by a prefix of its name");
+  if (data != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (data->GetName (), ndn::Name ("/r/4"), "Wrong Data extracted");
+    }
+  NS_TEST_ASSERT_MSG_EQ (log.GetSize (), 0, "Extracted records should be removed");
+  NS_TEST_ASSERT_MSG_EQ (log.GetUsedBytes (), 0, "Extracted records should be removed");
+  NS_TEST_ASSERT_MSG_EQ ((log.ExtractMatching (ndn::Name ("/r")) == 0), true, "Nothing should be left under the prefix");
+
+  log.Close ();
+
+  // all names have the same digest
+  MappedDataLog collisions;
+  collisions.SetDigestFunction (&SameDigest);
+  collisions.Open ("", 16 * length);
+
+  collisions.Append (CreateData ("/x/1"));
+  NS_TEST_ASSERT_MSG_EQ ((collisions.Extract (ndn::Name ("/x/2")) == 0), true,
+                         "Data with another name should not be returned for the same digest");
+  NS_TEST_ASSERT_MSG_EQ ((collisions.ExtractMatching (ndn::Name ("/y")) == 0), true,
+                         "Data with another prefix should not be returned for the same digest");
+  NS_TEST_ASSERT_MSG_EQ (collisions.GetSize (), 1, "Record should not be removed on a digest collision");
+
+  // replaces the record with the same digest
+  collisions.Append (CreateData ("/x/2"));
+  NS_TEST_ASSERT_MSG_EQ (collisions.GetSize (), 1, "Only one record per digest is kept");
+  NS_TEST_ASSERT_MSG_EQ ((collisions.Extract (ndn::Name ("/x/1")) == 0), true, "Replaced record should be gone");
+
+  data = collisions.Extract (ndn::Name ("/x/2"));
+  NS_TEST_ASSERT_MSG_EQ ((data != 0), true, "Record should be found by its name");
+  if (data != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (data->GetName (), ndn::Name ("/x/2"), "Wrong Data extracted");
+    }
+}
+
+void
+CsTieredTest::HotHit (Ptr<const ndn::Interest> interest, Ptr<const ndn::Data> data)
+{
+  m_hotHits++;
+}
+
+void
+CsTieredTest::ColdHit (Ptr<const ndn::Interest> interest, Ptr<const ndn::Data> data)
+{
+  m_coldHits++;
+}
+
+void
+CsTieredTest::DoRun ()
+{
+  ObjectFactory factory ("ns3::ndn::cs::Tiered::Lru");
+  factory.Set ("MaxSize", StringValue ("2"));
+  factory.Set ("ColdMaxBytes", StringValue ("65536"));
+
+  Ptr<TieredLru> cs = factory.Create<TieredLru> ();
+  cs->TraceConnectWithoutContext ("HotHits", MakeCallback (&CsTieredTest::HotHit, this));
+  cs->TraceConnectWithoutContext ("ColdHits", MakeCallback (&CsTieredTest::ColdHit, this));
+
+  // hot tier: [a, b]
+  cs->Add (CreateData ("/a"));
+  cs->Add (CreateData ("/b"));
+  NS_TEST_ASSERT_MSG_EQ (cs->GetColdSize (), 0, "Nothing should be demoted yet");
+
+  // hot tier: [b, c], cold tier: {a}
+  cs->Add (CreateData ("/c"));
+  NS_TEST_ASSERT_MSG_EQ (cs->GetSize (), 2, "Wrong size of the hot tier");
+  NS_TEST_ASSERT_MSG_EQ (cs->GetColdSize (), 1, "Evicted entry should be demoted to the cold tier");
+
+  // promotion of a demotes b: hot tier: [c, a], cold tier: {b}
+  Ptr<ndn::Data> data = cs->Lookup (CreateInterest ("/a"));
+  NS_TEST_ASSERT_MSG_EQ ((data != 0), true, "Demoted Data should be found in the cold tier");
+  NS_TEST_ASSERT_MSG_EQ (m_coldHits, 1, "Lookup should hit the cold tier");
+  NS_TEST_ASSERT_MSG_EQ (cs->GetColdSize (), 1, "Promoted entry should leave the cold tier");
+
+  data = cs->Lookup (CreateInterest ("/a"));
+  NS_TEST_ASSERT_MSG_EQ ((data != 0), true, "Promoted Data should be found");
+  NS_TEST_ASSERT_MSG_EQ (m_hotHits, 1, "Promoted Data should be found in the hot tier");
+  NS_TEST_ASSERT_MSG_EQ (m_coldHits, 1, "Promoted Data should be found in the hot tier");
+
+  // hot tier: [d, e], cold tier: {b, c, a, p/1}
+  cs->Add (CreateData ("/p/1"));
+  cs->Add (CreateData ("/d"));
+  cs->Add (CreateData ("/e"));
+  NS_TEST_ASSERT_MSG_EQ (cs->GetColdSize (), 4, "Evicted entries should be demoted to the cold tier");
+
+  // the cold tier matches prefixes like the hot tier, hot tier: [e, p/1], cold tier: {b, c, a, d}
+  data = cs->Lookup (CreateInterest ("/p"));
+  NS_TEST_ASSERT_MSG_EQ ((data != 0), true, "Demoted Data should be found by a prefix of its name");
+  if (data != 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (data->GetName (), ndn::Name ("/p/1"), "Wrong Data returned");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_coldHits, 2, "Lookup should hit the cold tier");
+  NS_TEST_ASSERT_MSG_EQ (cs->GetColdSize (), 4, "Wrong size of the cold tier");
+
+  // demotes e and erases the cold copy of b: hot tier: [p/1, b], cold tier: {c, a, d, e}
+  cs->Add (CreateData ("/b"));
+  NS_TEST_ASSERT_MSG_EQ (cs->GetColdSize (), 4, "Cold copy should be erased when Data is added to the hot tier");
+
+  data = cs->Lookup (CreateInterest ("/b"));
+  NS_TEST_ASSERT_MSG_EQ ((data != 0), true, "Added Data should be found");
+  NS_TEST_ASSERT_MSG_EQ (m_hotHits, 2, "Added Data should be found in the hot tier");
+  NS_TEST_ASSERT_MSG_EQ (m_coldHits, 2, "Added Data should be found in the hot tier");
+
+  NS_TEST_ASSERT_MSG_EQ ((cs->Lookup (CreateInterest ("/z")) == 0), true, "Unknown Data should not be found");
+
+  cs->Dispose ();
+}
+
+}
@@ -0,0 +1,50 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDNSIM_TEST_CS_TIERED_H
+#define NDNSIM_TEST_CS_TIERED_H
+
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+namespace ndn {
+class Interest;
+class Data;
+}
+
+class MappedDataLogTest : public TestCase
+{
+public:
+  MappedDataLogTest ()
+    : TestCase ("Memory-mapped Data log test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+class CsTieredTest : public TestCase
+{
+public:
+  CsTieredTest ()
+    : TestCase ("Two-tier content store test")
+    , m_hotHits (0)
+    , m_coldHits (0)
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void HotHit (Ptr<const ndn::Interest> interest, Ptr<const ndn::Data> data);
+  void ColdHit (Ptr<const ndn::Interest> interest, Ptr<const ndn::Data> data);
+
+  uint32_t m_hotHits;
+  uint32_t m_coldHits;
+};
+
+}
+
+#endif // NDNSIM_TEST_CS_TIERED_H
@@ -0,0 +1,320 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndnSIM-face-prefix-counters.h"
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/model/fw/face-prefix-counters.h"
+#include "ns3/ndnSIM/model/fw/space-saving.h"
+#include "ns3/ndnSIM/model/fw/face-satisfaction.h"
+#include "ns3/ndnSIM/model/fw/locally-monitored-tag.h"
+#include "ns3/ndnSIM/model/fw/recent-names.h"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <map>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.FacePrefixCountersTest");
+
+namespace ns3
+{
+
+using ndn::fw::FacePrefixCounters;
+using ndn::fw::SpaceSaving;
+using ndn::fw::FaceSatisfaction;
+using ndn::fw::LocallyMonitoredTag;
+using ndn::fw::RecentNames;
+
+static ndn::Name
+RecentName (uint32_t i)
+{
+  return ndn::Name ("/recent/" + boost::lexical_cast<std::string> (i));
+}
+
+void
+FacePrefixCountersTest::DoRun ()
+{
+  FacePrefixCounters counters;
+  counters.addFace (1);
+
+  NS_TEST_ASSERT_MSG_EQ (counters.getPrefixId (ndn::Name ("/evil")), FacePrefixCounters::NO_PREFIX,
+                         "Prefixes should only get ids when added");
+
+  uint32_t evil = counters.addPrefix (ndn::Name ("/evil"));
+  uint32_t good = counters.addPrefix (ndn::Name ("/good"));
+  NS_TEST_ASSERT_MSG_EQ (counters.addPrefix (ndn::Name ("/evil")), evil, "Prefix ids should be stable");
+  NS_TEST_ASSERT_MSG_EQ (counters.getNPrefixes (), 2, "There should be two prefixes");
+
+  counters.increment (0, evil, FacePrefixCounters::TIMED_OUT);
+  counters.increment (0, evil, FacePrefixCounters::TIMED_OUT);
+  counters.increment (0, evil, FacePrefixCounters::SATISFIED);
+  counters.increment (1, good, FacePrefixCounters::SATISFIED);
+
+  // Face 3 has not been added before, its row has to be widened
+  counters.increment (3, evil, FacePrefixCounters::TIMED_OUT);
+
+  NS_TEST_ASSERT_MSG_EQ (counters.get (0, evil, FacePrefixCounters::TIMED_OUT), 2, "Wrong counter");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (0, evil, FacePrefixCounters::SATISFIED), 1, "Wrong counter");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (0, good, FacePrefixCounters::SATISFIED), 0, "Wrong counter");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (1, good, FacePrefixCounters::SATISFIED), 1, "Wrong counter");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (3, evil, FacePrefixCounters::TIMED_OUT), 1, "Wrong counter");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (2, evil, FacePrefixCounters::TIMED_OUT), 0, "Wrong counter");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (7, evil, FacePrefixCounters::TIMED_OUT), 0, "Unknown faces should read as 0");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (0, FacePrefixCounters::NO_PREFIX, FacePrefixCounters::TIMED_OUT), 0,
+                         "Unknown prefixes should read as 0");
+
+  NS_TEST_ASSERT_MSG_EQ (counters.getPerFace (0, FacePrefixCounters::TIMED_OUT), 2, "Wrong per face total");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPerFace (1, FacePrefixCounters::SATISFIED), 1, "Wrong per face total");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPerPrefix (evil, FacePrefixCounters::TIMED_OUT), 3, "Wrong per prefix total");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPerPrefix (good, FacePrefixCounters::SATISFIED), 1, "Wrong per prefix total");
+
+  counters.reset ();
+
+  NS_TEST_ASSERT_MSG_EQ (counters.get (0, evil, FacePrefixCounters::TIMED_OUT), 0, "Counters should be reset");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPerFace (0, FacePrefixCounters::TIMED_OUT), 0, "Totals should be reset");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPerPrefix (evil, FacePrefixCounters::TIMED_OUT), 0, "Totals should be reset");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPrefixId (ndn::Name ("/evil")), evil, "Prefixes should survive a reset");
+
+  counters.increment (0, evil, FacePrefixCounters::SATISFIED);
+  NS_TEST_ASSERT_MSG_EQ (counters.get (0, evil, FacePrefixCounters::SATISFIED), 1,
+                         "Counters of an old epoch should restart from 0");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (0, evil, FacePrefixCounters::TIMED_OUT), 0,
+                         "Counters of an old epoch should restart from 0");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPerPrefix (evil, FacePrefixCounters::SATISFIED), 1, "Wrong per prefix total");
+
+  // decaying counts (half-life 1), which are not reset
+  NS_TEST_ASSERT_MSG_EQ (counters.getDecayed (0, evil, FacePrefixCounters::TIMED_OUT, 0.0), 0,
+                         "Decaying counts should be 0 when disabled");
+  counters.setHalfLife (1.0);
+
+  counters.increment (0, evil, FacePrefixCounters::TIMED_OUT, 10.0);
+  counters.increment (0, evil, FacePrefixCounters::TIMED_OUT, 11.0);
+  counters.increment (0, evil, FacePrefixCounters::SATISFIED, 11.0);
+  counters.increment (5, good, FacePrefixCounters::SATISFIED, 11.0);
+  counters.reset ();
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (counters.getDecayed (0, evil, FacePrefixCounters::TIMED_OUT, 11.0), 1.5, 1e-9,
+                             "Counts should halve every half-life");
+  NS_TEST_ASSERT_MSG_EQ_TOL (counters.getDecayed (0, evil, FacePrefixCounters::TIMED_OUT, 12.0), 0.75, 1e-9,
+                             "Counts should halve every half-life");
+  NS_TEST_ASSERT_MSG_EQ_TOL (counters.getDecayed (0, evil, FacePrefixCounters::SATISFIED, 13.0), 0.25, 1e-9,
+                             "Counts should halve every half-life");
+  NS_TEST_ASSERT_MSG_EQ_TOL (counters.getDecayed (5, good, FacePrefixCounters::SATISFIED, 11.0), 1.0, 1e-9,
+                             "Decaying counts should survive widening");
+  NS_TEST_ASSERT_MSG_EQ (counters.get (0, evil, FacePrefixCounters::TIMED_OUT), 0, "Counters should be reset");
+
+  // removed prefixes free their ids and counters for the next prefixes
+  counters.increment (0, evil, FacePrefixCounters::SATISFIED, 11.0);
+  counters.removePrefix (evil);
+  NS_TEST_ASSERT_MSG_EQ (counters.hasPrefix (evil), false, "Prefix should be removed");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPrefixId (ndn::Name ("/evil")), FacePrefixCounters::NO_PREFIX,
+                         "Removed prefixes should have no id");
+  NS_TEST_ASSERT_MSG_EQ (counters.getNUsedPrefixes (), 1, "One prefix should be left");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPerFace (0, FacePrefixCounters::SATISFIED), 1,
+                         "Per face totals should not be affected by removing a prefix");
+
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      uint32_t spray = counters.addPrefix (RecentName (i));
+      NS_TEST_ASSERT_MSG_EQ (spray, evil, "Id of the removed prefix should be reused");
+      NS_TEST_ASSERT_MSG_EQ (counters.get (0, spray, FacePrefixCounters::SATISFIED), 0,
+                             "Reused ids should start from 0");
+      NS_TEST_ASSERT_MSG_EQ (counters.getDecayed (0, spray, FacePrefixCounters::TIMED_OUT, 11.0), 0,
+                             "Reused ids should start from 0");
+      counters.increment (0, spray, FacePrefixCounters::TIMED_OUT, 11.0);
+      counters.removePrefix (spray);
+    }
+  NS_TEST_ASSERT_MSG_EQ (counters.getNPrefixes (), 2, "Memory should not grow with removed prefixes");
+  NS_TEST_ASSERT_MSG_EQ (counters.getPrefixId (ndn::Name ("/good")), good, "Other prefixes should keep their ids");
+  NS_TEST_ASSERT_MSG_EQ_TOL (counters.getDecayed (5, good, FacePrefixCounters::SATISFIED, 11.0), 1.0, 1e-9,
+                             "Other prefixes should keep their counts");
+}
+
+void
+FaceSatisfactionTest::DoRun ()
+{
+  FaceSatisfaction satisfaction;
+  satisfaction.setHalfLife (1.0);
+  satisfaction.addFace (2);
+
+  NS_TEST_ASSERT_MSG_EQ (satisfaction.getRatio (0), 1, "Faces without entries should be satisfied");
+  NS_TEST_ASSERT_MSG_EQ (satisfaction.getAverageRatio (), 1, "Average without entries should be 1");
+
+  // face 0: 0.5 satisfied, 0.5 + 1 timed out at time 1
+  satisfaction.satisfied (0, 0.0);
+  satisfaction.timedOut (0, 0.0);
+  satisfaction.timedOut (0, 1.0);
+  satisfaction.satisfied (1, 0.0);
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (satisfaction.getRatio (0), 0.25, 1e-9, "Wrong ratio");
+  NS_TEST_ASSERT_MSG_EQ_TOL (satisfaction.getRatio (1), 1.0, 1e-9, "Wrong ratio");
+  NS_TEST_ASSERT_MSG_EQ_TOL (satisfaction.getAverageRatio (), 0.625, 1e-9, "Face 2 has no entries and should not be averaged");
+  NS_TEST_ASSERT_MSG_EQ (satisfaction.getRatio (7), 1, "Unknown faces should be satisfied");
+}
+
+void
+LocallyMonitoredTagTest::DoRun ()
+{
+  boost::shared_ptr<LocallyMonitoredTag::EntryCounts> entries =
+    boost::make_shared<LocallyMonitoredTag::EntryCounts> ();
+
+  {
+    LocallyMonitoredTag first (1, entries);
+    LocallyMonitoredTag second (1, entries);
+    NS_TEST_ASSERT_MSG_EQ (entries->size (), 2, "Counts should be resized to the prefix id");
+    NS_TEST_ASSERT_MSG_EQ ((*entries)[1].entries, 0, "Entries without faces should not be counted");
+    NS_TEST_ASSERT_MSG_EQ ((*entries)[1].tags, 2, "Tags should be counted with or without faces");
+
+    NS_TEST_ASSERT_MSG_EQ (first.add (0), true, "Face should be new");
+    NS_TEST_ASSERT_MSG_EQ (first.add (0), false, "Face should not be new");
+    NS_TEST_ASSERT_MSG_EQ (first.add (130), true, "Face should be new");
+    NS_TEST_ASSERT_MSG_EQ (second.add (3), true, "Face should be new");
+    NS_TEST_ASSERT_MSG_EQ ((*entries)[1].entries, 2, "Every entry should be counted once");
+
+    NS_TEST_ASSERT_MSG_EQ (first.contains (130), true, "Face should be in the set");
+    NS_TEST_ASSERT_MSG_EQ (first.contains (66), false, "Face should not be in the set");
+    NS_TEST_ASSERT_MSG_EQ (first.contains (300), false, "Face should not be in the set");
+    NS_TEST_ASSERT_MSG_EQ (first.remove (300), false, "Face should not be in the set");
+
+    NS_TEST_ASSERT_MSG_EQ (first.remove (0), true, "Face should be in the set");
+    NS_TEST_ASSERT_MSG_EQ ((*entries)[1].entries, 2, "Entry with a face left should still be counted");
+    NS_TEST_ASSERT_MSG_EQ (first.remove (130), true, "Face should be in the set");
+    NS_TEST_ASSERT_MSG_EQ (first.empty (), true, "All faces should be removed");
+    NS_TEST_ASSERT_MSG_EQ ((*entries)[1].entries, 1, "Entry without faces should not be counted");
+  }
+
+  NS_TEST_ASSERT_MSG_EQ ((*entries)[1].entries, 0, "Destroyed entries should not be counted");
+  NS_TEST_ASSERT_MSG_EQ ((*entries)[1].tags, 0, "Destroyed tags should not be counted");
+}
+
+void
+SpaceSavingTest::DoRun ()
+{
+  SpaceSaving topK;
+  topK.setCapacity (4);
+
+  // three heavy keys (each more than total / capacity) among many light ones
+  std::map<uint32_t, uint32_t> counts;
+  UniformVariable rnd (0, 1);
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      uint32_t key = rnd.GetValue () < 0.9 ? i % 3 : 100 + i;
+      topK.add (key);
+      counts[key] ++;
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (topK.size (), 4, "Only four keys should be tracked");
+
+  for (uint32_t key = 0; key < 3; key++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (topK.contains (key), true, "Heavy key " << key << " should be tracked");
+    }
+
+  std::vector<SpaceSaving::Item> top = topK.getTop ();
+  for (uint32_t i = 0; i < top.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (top[i].count >= counts[top[i].key], true, "Counts should not be underestimated");
+      NS_TEST_ASSERT_MSG_EQ (top[i].count - top[i].error <= counts[top[i].key], true, "Error should bound the overestimation");
+      if (i > 0)
+        NS_TEST_ASSERT_MSG_EQ (top[i].count <= top[i - 1].count, true, "Keys should be sorted by count");
+    }
+
+  // decay keeps the tracked keys, a new key replaces the one with the smallest decayed count
+  uint32_t heaviest = top[0].key;
+  uint32_t heaviestCount = top[0].count;
+  topK.decay (0.5);
+  NS_TEST_ASSERT_MSG_EQ (topK.size (), 4, "Decay should keep the tracked keys");
+  NS_TEST_ASSERT_MSG_EQ (topK.getCount (heaviest), static_cast<uint32_t> (heaviestCount * 0.5 + 0.5),
+                         "Counts should be halved");
+  std::vector<SpaceSaving::Item> decayed = topK.getTop ();
+  for (uint32_t i = 0; i < decayed.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (topK.contains (top[i].key), true, "Decay should keep key " << top[i].key);
+      NS_TEST_ASSERT_MSG_EQ (decayed[i].error <= decayed[i].count, true, "Error should not exceed the count");
+    }
+  topK.add (1000000);
+  NS_TEST_ASSERT_MSG_EQ (topK.contains (1000000), true, "New key should be tracked");
+  NS_TEST_ASSERT_MSG_EQ (topK.contains (decayed.back ().key), false, "New key should replace the smallest count");
+  NS_TEST_ASSERT_MSG_EQ (topK.contains (heaviest), true, "Heaviest key should stay tracked");
+
+  topK.clear ();
+  NS_TEST_ASSERT_MSG_EQ (topK.size (), 0, "Keys should be cleared");
+  NS_TEST_ASSERT_MSG_EQ (topK.getCount (0), 0, "Cleared keys should have no count");
+}
+
+void
+RecentNamesTest::DoRun ()
+{
+  RecentNames names;
+
+  // m = -1000 ln(0.01) / ln(2)^2 = 9586 bits, rounded up to 16384 bits per generation
+  names.configure (1000, 0.01);
+  NS_TEST_ASSERT_MSG_EQ (names.getMemoryUsage (), 2 * 16384 / 8, "Wrong size of the Bloom filters");
+
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      names.insert (RecentName (i));
+    }
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (names.contains (RecentName (i)), true, "Inserted name " << i << " should be contained");
+    }
+  NS_TEST_ASSERT_MSG_EQ (names.insert (RecentName (0)), false, "Name should have been inserted before");
+
+  // generations of 4 names, a full generation is rotated by the next insert
+  names.configure (4, 0.01);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (names.insert (RecentName (i)), true, "Name " << i << " should be new");
+    }
+  names.insert (RecentName (4));
+  NS_TEST_ASSERT_MSG_EQ (names.size (), 5, "Full generation should be kept as the previous one");
+  NS_TEST_ASSERT_MSG_EQ (names.contains (RecentName (0)), true, "Previous generation should be remembered");
+
+  for (uint32_t i = 5; i < 9; i++)
+    {
+      names.insert (RecentName (i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (names.size (), 5, "Full generation should be rotated early");
+  NS_TEST_ASSERT_MSG_EQ (names.contains (RecentName (0)), false, "Generation before the previous one should be forgotten");
+  NS_TEST_ASSERT_MSG_EQ (names.contains (RecentName (4)), true, "Previous generation should be remembered");
+
+  // names of the previous generation are inserted again into the current one
+  names.rotate ();
+  NS_TEST_ASSERT_MSG_EQ (names.contains (RecentName (4)), false, "Generation before the previous one should be forgotten");
+  NS_TEST_ASSERT_MSG_EQ (names.insert (RecentName (8)), false, "Name of the previous generation should not be new");
+  names.rotate ();
+  NS_TEST_ASSERT_MSG_EQ (names.contains (RecentName (8)), true, "Name inserted again should survive the rotation");
+  names.rotate ();
+  names.rotate ();
+  NS_TEST_ASSERT_MSG_EQ (names.size (), 0, "All generations should be forgotten");
+  NS_TEST_ASSERT_MSG_EQ (names.contains (RecentName (8)), false, "All generations should be forgotten");
+
+  // Bloom filters far from their capacity answer like exact sets
+  RecentNames bloom;
+  bloom.configure (10000, 0.001);
+  RecentNames exact;
+  exact.setExact (true);
+
+  UniformVariable rnd (0, 1);
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      ndn::Name name = RecentName (rnd.GetInteger (0, 300));
+      if (rnd.GetValue () < 0.5)
+        {
+          NS_TEST_ASSERT_MSG_EQ (bloom.insert (name), exact.insert (name), "Different result of insert " << name);
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (bloom.contains (name), exact.contains (name), "Different result of contains " << name);
+        }
+
+      if (i % 500 == 499)
+        {
+          bloom.rotate ();
+          exact.rotate ();
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (bloom.size (), exact.size (), "Different number of names");
+}
+
+}
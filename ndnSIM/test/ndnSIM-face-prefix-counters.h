@@ -0,0 +1,72 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDNSIM_TEST_FACE_PREFIX_COUNTERS_H
+#define NDNSIM_TEST_FACE_PREFIX_COUNTERS_H
+
+#include "ns3/test.h"
+
+namespace ns3 {
+
+class FacePrefixCountersTest : public TestCase
+{
+public:
+  FacePrefixCountersTest ()
+    : TestCase ("Flat per face and prefix counters test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+class FaceSatisfactionTest : public TestCase
+{
+public:
+  FaceSatisfactionTest ()
+    : TestCase ("Per face satisfaction ratio test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+class LocallyMonitoredTagTest : public TestCase
+{
+public:
+  LocallyMonitoredTagTest ()
+    : TestCase ("Locally monitored PIT entry tag test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+class RecentNamesTest : public TestCase
+{
+public:
+  RecentNamesTest ()
+    : TestCase ("Recent names (Bloom filter generations) test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+class SpaceSavingTest : public TestCase
+{
+public:
+  SpaceSavingTest ()
+    : TestCase ("Space-Saving top-k test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+}
+
+#endif // NDNSIM_TEST_FACE_PREFIX_COUNTERS_H
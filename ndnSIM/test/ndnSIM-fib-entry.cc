@@ -30,6 +30,11 @@
 #include <boost/make_shared.hpp>
 
 #include "ns3/ndn-fib-entry.h"
+#include "ns3/ndn-fib-face-metric-array.h"
+
+#include <boost/lambda/lambda.hpp>
+#include <boost/lambda/bind.hpp>
+namespace ll = boost::lambda;
 
 NS_LOG_COMPONENT_DEFINE ("ndn.FibEntryTest");
 
@@ -149,4 +154,244 @@ FibEntryTest::DoRun ()
   NS_TEST_ASSERT_MSG_EQ (recorders.front ()->count, 2, "two events should have been reported");
 }
 
+void
+FibFaceMetricArrayTest::DoRun ()
+{
+  using ndn::fib::FaceMetric;
+
+  Ptr<Node> node = CreateObject<Node> ();
+  std::vector< Ptr<ndn::Face> > faces;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      faces.push_back (CreateObject<ndn::Face> (node));
+      faces.back ()->SetId (i);
+    }
+
+  ndn::fib::FaceMetricArray array;
+  NS_TEST_ASSERT_MSG_EQ (array.insert (FaceMetric (faces[0], 30)).second, true, "face 0 should be inserted");
+  NS_TEST_ASSERT_MSG_EQ (array.insert (FaceMetric (faces[1], 10)).second, true, "face 1 should be inserted");
+  NS_TEST_ASSERT_MSG_EQ (array.insert (FaceMetric (faces[2], 20)).second, true, "face 2 should be inserted");
+  NS_TEST_ASSERT_MSG_EQ (array.insert (FaceMetric (faces[2], 5)).second, false, "face 2 is already in the table");
+
+  NS_TEST_ASSERT_MSG_EQ (array.size (), 3, "three next hops expected");
+  NS_TEST_ASSERT_MSG_EQ (array.get<ndn::fib::i_nth> () [0].GetFace (), faces[1], "face 1 has the lowest cost");
+  NS_TEST_ASSERT_MSG_EQ (array.get<ndn::fib::i_nth> () [1].GetFace (), faces[2], "face 2 is the second");
+  NS_TEST_ASSERT_MSG_EQ (array.get<ndn::fib::i_nth> () [2].GetFace (), faces[0], "face 0 is the last");
+
+  StatusRecorder recorder (node, 0, faces[1]);
+  const_cast<FaceMetric &> (*array.get<ndn::fib::i_face> ().find (faces[1])).GetStatusTrace ()
+    .ConnectWithoutContext (MakeCallback (&StatusRecorder::StatusChange, &recorder));
+
+  // best next hop goes RED and moves to the end, record (and trace connection) stays the same
+  array.modify (array.get<ndn::fib::i_face> ().find (faces[1]),
+                ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_RED));
+  NS_TEST_ASSERT_MSG_EQ (array.get<ndn::fib::i_nth> () [0].GetFace (), faces[2], "face 2 should become the best");
+  NS_TEST_ASSERT_MSG_EQ (array.get<ndn::fib::i_nth> () [2].GetFace (), faces[1], "RED face 1 should be the last");
+
+  array.modify (array.get<ndn::fib::i_face> ().find (faces[1]),
+                ll::bind (&FaceMetric::SetStatus, ll::_1, FaceMetric::NDN_FIB_GREEN));
+  NS_TEST_ASSERT_MSG_EQ (array.get<ndn::fib::i_nth> () [0].GetFace (), faces[1], "GREEN face 1 should be the best");
+  NS_TEST_ASSERT_MSG_EQ (recorder.count, 2, "two status changes should have been reported");
+
+  NS_TEST_ASSERT_MSG_EQ (array.erase (faces[2]), 1, "face 2 should be removed");
+  NS_TEST_ASSERT_MSG_EQ (array.erase (faces[2]), 0, "face 2 is not in the table anymore");
+  NS_TEST_ASSERT_MSG_EQ ((array.find (faces[2]) == array.end ()), true, "face 2 should not be found");
+
+  // random updates: array order should always match multi-index i_metric order
+  ndn::fib::FaceMetricMultiIndex::type multiIndex;
+  BOOST_FOREACH (const FaceMetric &metric, array)
+    {
+      multiIndex.insert (metric);
+    }
+
+  UniformVariable rnd;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Ptr<ndn::Face> face = faces[rnd.GetInteger (0, faces.size () - 1)];
+      if (array.find (face) == array.end ())
+        {
+          int32_t cost = rnd.GetInteger (0, 10);
+          array.insert (FaceMetric (face, cost));
+          multiIndex.insert (FaceMetric (face, cost));
+        }
+      else if (rnd.GetInteger (0, 9) == 0)
+        {
+          array.erase (face);
+          multiIndex.erase (face);
+        }
+      else if (rnd.GetInteger (0, 1) == 0)
+        {
+          FaceMetric::Status status = static_cast<FaceMetric::Status> (rnd.GetInteger (1, 3));
+          array.modify (array.find (face), ll::bind (&FaceMetric::SetStatus, ll::_1, status));
+          multiIndex.modify (multiIndex.find (face), ll::bind (&FaceMetric::SetStatus, ll::_1, status));
+        }
+      else
+        {
+          int32_t cost = rnd.GetInteger (0, 10);
+          array.modify (array.find (face), ll::bind (&FaceMetric::SetRoutingCost, ll::_1, cost));
+          multiIndex.modify (multiIndex.find (face), ll::bind (&FaceMetric::SetRoutingCost, ll::_1, cost));
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (array.size (), multiIndex.size (), "tables should have the same size");
+
+      ndn::fib::FaceMetricArray::iterator record = array.begin ();
+      BOOST_FOREACH (const FaceMetric &metric, multiIndex.get<ndn::fib::i_metric> ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (record->GetStatus (), metric.GetStatus (), "status order mismatch at step " << i);
+          NS_TEST_ASSERT_MSG_EQ (record->GetRoutingCost (), metric.GetRoutingCost (), "cost order mismatch at step " << i);
+          NS_TEST_ASSERT_MSG_EQ (array.find (metric.GetFace ())->GetRoutingCost (), metric.GetRoutingCost (),
+                                 "cost mismatch for face " << metric.GetFace ()->GetId ());
+          record++;
+        }
+    }
+}
+
+void
+FibEntryRttTest::DoRun ()
+{
+  using ndn::fib::FaceMetric;
+
+  Ptr<Node> node = CreateObject<Node> ();
+  ndn::StackHelper ndnHelper;
+  ndnHelper.Install (node);
+
+  std::vector< Ptr<ndn::Face> > faces;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      faces.push_back (CreateObject<ndn::Face> (node));
+      faces.back ()->SetId (i);
+    }
+
+  Ptr<ndn::Fib> fib = node->GetObject<ndn::Fib> ();
+  Ptr<ndn::fib::Entry> entry = fib->Add (ndn::Name ("/prefix"), faces[0], 30);
+  fib->Add (ndn::Name ("/prefix"), faces[1], 10);
+  fib->Add (ndn::Name ("/prefix"), faces[2], 20);
+
+  NS_TEST_ASSERT_MSG_EQ (entry->FindBestCandidate (0).GetFace (), faces[1], "face 1 has the lowest cost");
+  NS_TEST_ASSERT_MSG_EQ (entry->FindBestCandidate (1).GetFace (), faces[2], "face 2 is the second");
+
+  // RTT samples do not change the order of next hops
+  entry->UpdateFaceRtt (faces[1], MilliSeconds (100));
+  entry->UpdateFaceRtt (faces[1], MilliSeconds (200));
+  const FaceMetric &metric = *entry->m_faces.get<ndn::fib::i_face> ().find (faces[1]);
+  NS_TEST_ASSERT_MSG_EQ (metric.GetSRtt (), MilliSeconds (112.5), "SRTT should be updated (RFC 2988)");
+  NS_TEST_ASSERT_MSG_EQ (metric.GetRttVar (), MilliSeconds (62.5), "RTTVAR should be updated (RFC 2988)");
+  NS_TEST_ASSERT_MSG_EQ (entry->FindBestCandidate (0).GetFace (), faces[1], "face 1 is still the best");
+
+  // several status changes between lookups, order reflects all of them
+  entry->UpdateStatus (faces[1], FaceMetric::NDN_FIB_RED);
+  entry->UpdateStatus (faces[2], FaceMetric::NDN_FIB_RED);
+  entry->UpdateStatus (faces[0], FaceMetric::NDN_FIB_GREEN);
+  NS_TEST_ASSERT_MSG_EQ (entry->FindBestCandidate (0).GetFace (), faces[0], "GREEN face 0 should be the best");
+  NS_TEST_ASSERT_MSG_EQ (entry->FindBestCandidate (1).GetFace (), faces[1], "RED face 1 is cheaper than RED face 2");
+  NS_TEST_ASSERT_MSG_EQ (entry->FindBestCandidate (2).GetFace (), faces[2], "RED face 2 should be the last");
+
+  // invalidation makes every next hop equal, best candidate should follow metric order
+  entry->Invalidate ();
+  NS_TEST_ASSERT_MSG_EQ (entry->FindBestCandidate (0).GetFace (), entry->m_faces.get<ndn::fib::i_metric> ().begin ()->GetFace (),
+                         "best candidate should be the first in metric order");
+
+  Simulator::Destroy ();
+}
+
+void
+FibHashTest::DoRun ()
+{
+  // same routes in the trie-based and the hash-based FIB, longest prefix matches should agree
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.SetFib ("ns3::ndn::fib::Default");
+  ndnHelper.Install (nodes.Get (0));
+  // tiny filters, so false positives are exercised too
+  ndnHelper.SetFib ("ns3::ndn::fib::Hash", "BloomFilterBitsPerEntry", "1");
+  ndnHelper.Install (nodes.Get (1));
+
+  Ptr<ndn::Fib> trie = nodes.Get (0)->GetObject<ndn::Fib> ();
+  Ptr<ndn::Fib> hash = nodes.Get (1)->GetObject<ndn::Fib> ();
+
+  std::vector< Ptr<ndn::Face> > faces;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      faces.push_back (CreateObject<ndn::Face> (nodes.Get (1)));
+      faces.back ()->SetId (i);
+    }
+
+  UniformVariable rnd;
+  std::vector<std::string> prefixes;
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      std::string prefix;
+      uint32_t length = rnd.GetInteger (1, 4);
+      for (uint32_t comp = 0; comp < length; comp++)
+        {
+          prefix += "/" + boost::lexical_cast<std::string> (rnd.GetInteger (0, 3));
+        }
+      prefixes.push_back (prefix);
+
+      Ptr<ndn::Face> face = faces[rnd.GetInteger (0, faces.size () - 1)];
+      trie->Add (ndn::Name (prefix), face, 1);
+      hash->Add (ndn::Name (prefix), face, 1);
+    }
+  NS_TEST_ASSERT_MSG_EQ (hash->GetSize (), trie->GetSize (), "FIBs should have the same number of entries");
+
+  uint32_t nEntries = 0;
+  for (Ptr<ndn::fib::Entry> entry = hash->Begin (); entry != hash->End (); entry = hash->Next (entry))
+    {
+      NS_TEST_ASSERT_MSG_NE (trie->Find (entry->GetPrefix ()), 0, "entry " << entry->GetPrefix () << " should be in both FIBs");
+      nEntries ++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (nEntries, hash->GetSize (), "iteration should visit all entries");
+
+  for (uint32_t step = 0; step < 3; step++)
+    {
+      for (uint32_t i = 0; i < 1000; i++)
+        {
+          std::string name;
+          uint32_t length = rnd.GetInteger (0, 6);
+          for (uint32_t comp = 0; comp < length; comp++)
+            {
+              name += "/" + boost::lexical_cast<std::string> (rnd.GetInteger (0, 4));
+            }
+          Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+          interest->SetName (Create<ndn::Name> (name == "" ? "/" : name));
+
+          Ptr<ndn::fib::Entry> expected = trie->LongestPrefixMatch (*interest);
+          Ptr<ndn::fib::Entry> found = hash->LongestPrefixMatch (*interest);
+          if (expected == 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (found, 0, "no match expected for " << interest->GetName ());
+            }
+          else
+            {
+              NS_TEST_ASSERT_MSG_NE (found, 0, "match expected for " << interest->GetName ());
+              NS_TEST_ASSERT_MSG_EQ (found->GetPrefix (), expected->GetPrefix (), "wrong match for " << interest->GetName ());
+            }
+        }
+
+      if (step == 0)
+        {
+          // drop half of the prefixes
+          for (uint32_t i = 0; i < prefixes.size (); i += 2)
+            {
+              trie->Remove (Create<ndn::Name> (prefixes[i]));
+              hash->Remove (Create<ndn::Name> (prefixes[i]));
+            }
+        }
+      else if (step == 1)
+        {
+          // default route and removal of all routes via one face
+          trie->Add (ndn::Name ("/"), faces[1], 1);
+          hash->Add (ndn::Name ("/"), faces[1], 1);
+
+          trie->RemoveFromAll (faces[0]);
+          hash->RemoveFromAll (faces[0]);
+        }
+      NS_TEST_ASSERT_MSG_EQ (hash->GetSize (), trie->GetSize (), "FIBs should have the same number of entries");
+    }
+
+  Simulator::Destroy ();
+}
+
 }
@@ -43,6 +43,42 @@ private:
   virtual void DoRun ();
 };
 
+class FibFaceMetricArrayTest : public TestCase
+{
+public:
+  FibFaceMetricArrayTest ()
+    : TestCase ("FIB entry compact next hop array test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+class FibEntryRttTest : public TestCase
+{
+public:
+  FibEntryRttTest ()
+    : TestCase ("FIB entry RTT update and lazy next hop order test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
+class FibHashTest : public TestCase
+{
+public:
+  FibHashTest ()
+    : TestCase ("Hash-based FIB longest prefix match test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+};
+
 }
 
 #endif // NDNSIM_TEST_FIB_ENTRY_H
@@ -0,0 +1,467 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ndnSIM-global-routing.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndn-fib-entry.h"
+#include "ns3/ndnSIM/helper/ndn-global-routing-graph.h"
+#include "ns3/ndnSIM/helper/boost-graph-ndn-global-routing-helper.h"
+#include "ns3/ndnSIM/model/ndn-net-device-face.h"
+#include "ns3/ndnSIM/model/ndn-global-router.h"
+#include "ns3/ndnSIM/model/fw/global-routing-info.h"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/foreach.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+
+#include <limits>
+#include <set>
+
+NS_LOG_COMPONENT_DEFINE ("ndn.GlobalRoutingTest");
+
+namespace ns3
+{
+
+static std::string
+RouteKey (uint32_t node, const ndn::Name &prefix, uint32_t face)
+{
+  return "node " + boost::lexical_cast<std::string> (node) +
+    " prefix " + boost::lexical_cast<std::string> (prefix) +
+    " face " + boost::lexical_cast<std::string> (face);
+}
+
+GlobalRoutingTest::Routes
+GlobalRoutingTest::GetFibRoutes ()
+{
+  Routes routes;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      Ptr<ndn::Fib> fib = (*node)->GetObject<ndn::Fib> ();
+      for (Ptr<ndn::fib::Entry> entry = fib->Begin (); entry != fib->End (); entry = fib->Next (entry))
+        {
+          BOOST_FOREACH (const ndn::fib::FaceMetric &faceMetric, entry->m_faces)
+            {
+              routes[RouteKey ((*node)->GetId (), entry->GetPrefix (), faceMetric.GetFace ()->GetId ())] =
+                std::make_pair (faceMetric.GetRoutingCost (), faceMetric.GetRealDelay ().ToDouble (Time::S));
+            }
+        }
+    }
+  return routes;
+}
+
+GlobalRoutingTest::Routes
+GlobalRoutingTest::GetReferenceRoutes ()
+{
+  // Original route calculation on the Boost Graph Library adapter: one Dijkstra per face of
+  // every node, with all other faces of the node disabled through their metrics
+  boost::NdnGlobalRouterGraph graph;
+
+  Routes routes;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      Ptr<ndn::GlobalRouter> source = (*node)->GetObject<ndn::GlobalRouter> ();
+      if (source == 0)
+        continue;
+
+      Ptr<ndn::L3Protocol> l3 = source->GetObject<ndn::L3Protocol> ();
+
+      std::vector<uint16_t> originalMetric (l3->GetNFaces ());
+      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+        {
+          originalMetric[faceId] = l3->GetFace (faceId)->GetMetric ();
+          l3->GetFace (faceId)->SetMetric (std::numeric_limits<uint16_t>::max ()-1);
+        }
+
+      for (uint32_t enabledFaceId = 0; enabledFaceId < l3->GetNFaces (); enabledFaceId++)
+        {
+          if (DynamicCast<ndn::NetDeviceFace> (l3->GetFace (enabledFaceId)) == 0)
+            continue;
+
+          l3->GetFace (enabledFaceId)->SetMetric (originalMetric[enabledFaceId]);
+
+          boost::DistancesMap distances;
+          boost::dijkstra_shortest_paths (graph, source,
+                                          boost::distance_map (boost::ref (distances))
+                                          .distance_inf (boost::WeightInf)
+                                          .distance_zero (boost::WeightZero)
+                                          .distance_compare (boost::WeightCompare ())
+                                          .distance_combine (boost::WeightCombine ()));
+
+          for (boost::DistancesMap::iterator i = distances.begin (); i != distances.end (); i++)
+            {
+              if (i->first == source || i->second.get<0> () == 0)
+                continue;
+
+              // first face of the route is disabled
+              if (i->second.get<0> ()->GetMetric () == std::numeric_limits<uint16_t>::max ()-1)
+                continue;
+
+              BOOST_FOREACH (const Ptr<const ndn::Name> &prefix, i->first->GetLocalPrefixes ())
+                {
+                  routes[RouteKey ((*node)->GetId (), *prefix, i->second.get<0> ()->GetId ())] =
+                    std::make_pair (static_cast<int32_t> (i->second.get<1> ()), i->second.get<2> ());
+                }
+            }
+
+          l3->GetFace (enabledFaceId)->SetMetric (std::numeric_limits<uint16_t>::max ()-1);
+        }
+
+      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+        {
+          l3->GetFace (faceId)->SetMetric (originalMetric[faceId]);
+        }
+    }
+  return routes;
+}
+
+void
+GlobalRoutingTest::DoRun ()
+{
+  // ring of 8 nodes with chords, so that shortest paths of many neighbors go back through the node
+  NodeContainer nodes;
+  nodes.Create (8);
+
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      p2p.Install (nodes.Get (i), nodes.Get ((i + 1) % nodes.GetN ()));
+    }
+  p2p.Install (nodes.Get (0), nodes.Get (4));
+  p2p.Install (nodes.Get (1), nodes.Get (6));
+  p2p.Install (nodes.Get (2), nodes.Get (5));
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll ();
+
+  // asymmetric metrics
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ndn::L3Protocol> l3 = nodes.Get (i)->GetObject<ndn::L3Protocol> ();
+      for (uint32_t faceId = 0; faceId < l3->GetNFaces (); faceId++)
+        {
+          l3->GetFace (faceId)->SetMetric (1 + (3 * i + 7 * faceId) % 5);
+        }
+    }
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll ();
+  ndnGlobalRoutingHelper.AddOrigin ("/prefix0", nodes.Get (0));
+  ndnGlobalRoutingHelper.AddOrigin ("/prefix3", nodes.Get (3));
+  ndnGlobalRoutingHelper.AddOrigin ("/prefix6", nodes.Get (6));
+  ndnGlobalRoutingHelper.AddOrigin ("/prefix7", nodes.Get (7));
+
+  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes ();
+
+  Routes fibRoutes = GetFibRoutes ();
+  Routes referenceRoutes = GetReferenceRoutes ();
+
+  NS_TEST_ASSERT_MSG_EQ (fibRoutes.size (), referenceRoutes.size (), "Different number of routes installed into FIBs");
+  BOOST_FOREACH (const Routes::value_type &route, referenceRoutes)
+    {
+      Routes::const_iterator fibRoute = fibRoutes.find (route.first);
+      NS_TEST_ASSERT_MSG_EQ ((fibRoute != fibRoutes.end ()), true, "Missing route: " << route.first);
+      if (fibRoute != fibRoutes.end ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (fibRoute->second.first, route.second.first, "Wrong cost of route: " << route.first);
+          NS_TEST_ASSERT_MSG_EQ_TOL (fibRoute->second.second, route.second.second, 1e-9,
+                                     "Wrong real delay of route: " << route.first);
+        }
+    }
+
+  Simulator::Destroy ();
+}
+
+void
+GlobalRoutingUpdateTest::CheckRoutes (const std::string &state)
+{
+  // every FIB entry should have one face per first edge of the shortest paths to the origins of its
+  // prefix, which is up and has the cost of the shortest of these paths
+  ndn::GlobalRoutingGraph graph;
+  ndn::GlobalRoutingShortestPaths paths;
+
+  typedef std::map<ndn::Name, std::map<Ptr<ndn::Face>, int32_t> > NextHops;
+
+  for (uint32_t source = 0; source < graph.GetNNodes (); source++)
+    {
+      paths.Calculate (graph, source);
+      Ptr<ndn::Fib> fib = graph.GetRouter (source)->GetObject<ndn::Fib> ();
+      uint32_t nodeId = graph.GetRouter (source)->GetObject<Node> ()->GetId ();
+      bool isMonitor = ndn::fw::GlobalRoutingInfo::getMonitorIndex (nodeId) != ndn::fw::GlobalRoutingInfo::NO_MONITOR;
+
+      NextHops nextHops;
+      std::map<ndn::Name, int32_t> distances;
+      for (uint32_t origin = 0; origin < graph.GetNVertices (); origin++)
+        {
+          if (origin == source)
+            continue;
+
+          BOOST_FOREACH (const Ptr<ndn::Name> &prefix, graph.GetRouter (origin)->GetLocalPrefixes ())
+            {
+              std::map<Ptr<ndn::Face>, int32_t> &hops = nextHops[*prefix];
+              int32_t &distance = distances[*prefix];
+              if (!paths.IsReachable (origin))
+                continue;
+
+              int32_t cost = paths.GetCost (origin);
+              if (distance == 0 || cost < distance)
+                distance = cost;
+
+              Ptr<ndn::Face> face = graph.GetEdgeFace (paths.GetFirstEdge (origin));
+              if (hops.find (face) == hops.end () || cost < hops[face])
+                hops[face] = cost;
+            }
+        }
+
+      BOOST_FOREACH (const NextHops::value_type &prefixHops, nextHops)
+        {
+          const ndn::Name &prefix = prefixHops.first;
+          if (isMonitor)
+            {
+              // distances from monitors are reported by the route calculation
+              NS_TEST_ASSERT_MSG_EQ (ndn::fw::GlobalRoutingInfo::get (nodeId, prefix), distances[prefix],
+                                     state << ": wrong distance from monitor " << nodeId << " to " << prefix);
+            }
+
+          Ptr<ndn::fib::Entry> entry = fib->Find (prefix);
+          if (prefixHops.second.empty ())
+            {
+              NS_TEST_ASSERT_MSG_EQ ((entry == 0), true, state << ": route to unreachable " << prefix << " should be removed");
+              continue;
+            }
+
+          NS_TEST_ASSERT_MSG_EQ ((entry != 0), true, state << ": missing route to " << prefix);
+          if (entry == 0)
+            continue;
+
+          NS_TEST_ASSERT_MSG_EQ (entry->m_faces.size (), prefixHops.second.size (),
+                                 state << ": wrong number of faces for " << prefix << " at node " << nodeId);
+          BOOST_FOREACH (const ndn::fib::FaceMetric &faceMetric, entry->m_faces)
+            {
+              NS_TEST_ASSERT_MSG_EQ (faceMetric.GetFace ()->IsUp (), true, state << ": route to " << prefix << " uses a failed face");
+
+              std::map<Ptr<ndn::Face>, int32_t>::const_iterator hop = prefixHops.second.find (faceMetric.GetFace ());
+              NS_TEST_ASSERT_MSG_EQ ((hop != prefixHops.second.end ()), true,
+                                     state << ": route to " << prefix << " at node " << nodeId << " should not use face " << faceMetric.GetFace ()->GetId ());
+              if (hop != prefixHops.second.end ())
+                {
+                  NS_TEST_ASSERT_MSG_EQ (faceMetric.GetRoutingCost (), hop->second,
+                                         state << ": wrong cost of route to " << prefix << " at node " << nodeId);
+                }
+            }
+        }
+    }
+}
+
+void
+GlobalRoutingUpdateTest::DoRun ()
+{
+  // line 0-1-2-3 closed into a ring through node 4, plus a separate tail node 5 behind node 3
+  NodeContainer nodes;
+  nodes.Create (6);
+
+  PointToPointHelper p2p;
+  p2p.Install (nodes.Get (0), nodes.Get (1));
+  p2p.Install (nodes.Get (1), nodes.Get (2));
+  p2p.Install (nodes.Get (2), nodes.Get (3));
+  p2p.Install (nodes.Get (3), nodes.Get (4));
+  p2p.Install (nodes.Get (4), nodes.Get (0));
+  p2p.Install (nodes.Get (3), nodes.Get (5));
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll ();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll ();
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      ndnGlobalRoutingHelper.AddOrigin ("/prefix" + boost::lexical_cast<std::string> (i), nodes.Get (i));
+    }
+
+  // prefixes with several origins: when link 4-0 fails, the route of node 3 towards origin 0 of
+  // /both leaves the face that origin 4 still uses, and the cost of node 5 towards origin 0 of
+  // /shared increases on the face that origin 3 uses at a lower cost
+  ndnGlobalRoutingHelper.AddOrigins ("/shared", NodeContainer (nodes.Get (0), nodes.Get (3)));
+  ndnGlobalRoutingHelper.AddOrigins ("/both", NodeContainer (nodes.Get (0), nodes.Get (4)));
+
+  ndn::fw::GlobalRoutingInfo::addMonitor (nodes.Get (0)->GetId ());
+  ndn::fw::GlobalRoutingInfo::addMonitor (nodes.Get (5)->GetId ());
+
+  ndn::GlobalRoutingHelper::CalculateRoutes ();
+  CheckRoutes ("initial");
+
+  ndn::LinkControlHelper::FailLink (nodes.Get (1), nodes.Get (2));
+  CheckRoutes ("link 1-2 failed");
+
+  ndn::LinkControlHelper::FailLink (nodes.Get (3), nodes.Get (5));
+  CheckRoutes ("link 3-5 failed");
+
+  ndn::LinkControlHelper::UpLink (nodes.Get (1), nodes.Get (2));
+  CheckRoutes ("link 1-2 recovered");
+
+  ndn::LinkControlHelper::UpLink (nodes.Get (3), nodes.Get (5));
+  CheckRoutes ("link 3-5 recovered");
+
+  ndn::LinkControlHelper::FailLink (nodes.Get (4), nodes.Get (0));
+  CheckRoutes ("link 4-0 failed");
+
+  ndn::LinkControlHelper::UpLink (nodes.Get (4), nodes.Get (0));
+  CheckRoutes ("link 4-0 recovered");
+
+  Simulator::Destroy ();
+}
+
+GlobalRoutingCompressionTest::Lookups
+GlobalRoutingCompressionTest::GetLookups (const std::vector<std::string> &names)
+{
+  Lookups lookups;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      Ptr<ndn::Fib> fib = (*node)->GetObject<ndn::Fib> ();
+      BOOST_FOREACH (const std::string &name, names)
+        {
+          Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+          interest->SetName (Create<ndn::Name> (name));
+
+          std::string &hops = lookups["node " + boost::lexical_cast<std::string> ((*node)->GetId ()) + " " + name];
+          Ptr<ndn::fib::Entry> entry = fib->LongestPrefixMatch (*interest);
+          if (entry == 0)
+            continue;
+
+          std::set<std::string> faces;
+          BOOST_FOREACH (const ndn::fib::FaceMetric &faceMetric, entry->m_faces)
+            {
+              faces.insert (boost::lexical_cast<std::string> (faceMetric.GetFace ()->GetId ()) + ":" +
+                            boost::lexical_cast<std::string> (faceMetric.GetRoutingCost ()));
+            }
+          BOOST_FOREACH (const std::string &face, faces)
+            {
+              hops += face + " ";
+            }
+        }
+    }
+  return lookups;
+}
+
+uint32_t
+GlobalRoutingCompressionTest::GetFibSize ()
+{
+  uint32_t size = 0;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      size += (*node)->GetObject<ndn::Fib> ()->GetSize ();
+    }
+  return size;
+}
+
+void
+GlobalRoutingCompressionTest::DoRun ()
+{
+  // tree 0-1, 0-2, 1-3, 1-4, 2-5, 2-6, with prefixes of the nodes grouped under two sites
+  NodeContainer nodes;
+  nodes.Create (7);
+
+  PointToPointHelper p2p;
+  for (uint32_t i = 1; i < nodes.GetN (); i++)
+    {
+      p2p.Install (nodes.Get ((i - 1) / 2), nodes.Get (i));
+    }
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll ();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll ();
+
+  std::vector<std::string> names;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      // routes to /.../data are the same as to their parents and are removed
+      std::string prefix = "/site" + boost::lexical_cast<std::string> (i % 2) + "/node" + boost::lexical_cast<std::string> (i);
+      ndnGlobalRoutingHelper.AddOrigin (prefix, nodes.Get (i));
+      ndnGlobalRoutingHelper.AddOrigin (prefix + "/data", nodes.Get (i));
+      names.push_back (prefix);
+      names.push_back (prefix + "/data/1");
+    }
+
+  // siblings without a parent route, which can be aggregated only into a route covering unrouted names
+  ndnGlobalRoutingHelper.AddOrigin ("/shared/a", nodes.Get (3));
+  ndnGlobalRoutingHelper.AddOrigin ("/shared/b", nodes.Get (3));
+  names.push_back ("/shared/a/1");
+  names.push_back ("/shared/b/1");
+
+  // looked up by exact name, kept even though they are the same as their parent
+  ndnGlobalRoutingHelper.AddOrigin ("/monitor", nodes.Get (4));
+  ndnGlobalRoutingHelper.AddOrigin ("/monitor/4", nodes.Get (4));
+  ndn::GlobalRoutingHelper::AddExactNamespace ("/monitor");
+
+  std::vector<std::string> unrouted;
+  unrouted.push_back ("/shared");
+  unrouted.push_back ("/shared/c");
+  unrouted.push_back ("/site1");
+  unrouted.push_back ("/other/1");
+
+  ndn::GlobalRoutingHelper::CalculateRoutes ();
+  uint32_t size = GetFibSize ();
+  Lookups lookups = GetLookups (names);
+  Lookups unroutedLookups = GetLookups (unrouted);
+
+  ndn::GlobalRoutingHelper::CompressFibs (true);
+  uint32_t compressedSize = GetFibSize ();
+  NS_TEST_ASSERT_MSG_LT (compressedSize, size, "compression should remove FIB entries");
+
+  Lookups compressed = GetLookups (names);
+  for (Lookups::iterator lookup = lookups.begin (); lookup != lookups.end (); lookup++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (compressed[lookup->first], lookup->second, "next hops of " << lookup->first << " changed");
+    }
+
+  compressed = GetLookups (unrouted);
+  for (Lookups::iterator lookup = unroutedLookups.begin (); lookup != unroutedLookups.end (); lookup++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (lookup->second, "", lookup->first << " should not have a route");
+      NS_TEST_ASSERT_MSG_EQ (compressed[lookup->first], "", lookup->first << " should not get a route by compression");
+    }
+
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      if (i == 4)
+        continue;
+
+      Ptr<ndn::Fib> fib = nodes.Get (i)->GetObject<ndn::Fib> ();
+      NS_TEST_ASSERT_MSG_EQ ((fib->Find (ndn::Name ("/monitor/4")) != 0), true,
+                             "entry /monitor/4 of node " << i << " should be kept");
+    }
+
+  // aggregation into routes covering unrouted names
+  ndn::GlobalRoutingHelper::CalculateRoutes ();
+  ndn::GlobalRoutingHelper::CompressFibs (true, true);
+  NS_TEST_ASSERT_MSG_LT (GetFibSize (), compressedSize, "siblings should be aggregated");
+
+  compressed = GetLookups (names);
+  for (Lookups::iterator lookup = lookups.begin (); lookup != lookups.end (); lookup++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (compressed[lookup->first], lookup->second, "next hops of " << lookup->first << " changed");
+    }
+
+  Ptr<ndn::Fib> fib = nodes.Get (0)->GetObject<ndn::Fib> ();
+  NS_TEST_ASSERT_MSG_EQ ((fib->Find (ndn::Name ("/monitor/4")) != 0), true, "entry /monitor/4 should be kept");
+
+  Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+  interest->SetName (Create<ndn::Name> ("/shared/c"));
+  NS_TEST_ASSERT_MSG_EQ ((fib->LongestPrefixMatch (*interest) != 0), true, "/shared/c should be covered by an aggregated entry");
+
+  // recalculation removes aggregated entries and restores the original FIBs
+  ndn::GlobalRoutingHelper::CalculateRoutes ();
+  NS_TEST_ASSERT_MSG_EQ (GetFibSize (), size, "aggregated entries should be replaced by routes");
+
+  // without the exemption, /monitor/4 is aggregated into /monitor
+  ndn::GlobalRoutingHelper::ClearExactNamespaces ();
+  ndn::GlobalRoutingHelper::CompressFibs (true);
+  NS_TEST_ASSERT_MSG_EQ ((fib->Find (ndn::Name ("/monitor/4")) == 0), true, "entry /monitor/4 should be aggregated");
+
+  Simulator::Destroy ();
+}
+
+}
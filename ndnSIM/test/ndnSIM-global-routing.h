@@ -0,0 +1,65 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef NDNSIM_TEST_GLOBAL_ROUTING_H
+#define NDNSIM_TEST_GLOBAL_ROUTING_H
+
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class GlobalRoutingTest : public TestCase
+{
+public:
+  GlobalRoutingTest ()
+    : TestCase ("Global routing all possible routes test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  typedef std::map<std::string, std::pair<int32_t, double> > Routes; // "node prefix face" -> (cost, real delay in seconds)
+
+  Routes GetFibRoutes ();
+  Routes GetReferenceRoutes ();
+};
+
+class GlobalRoutingUpdateTest : public TestCase
+{
+public:
+  GlobalRoutingUpdateTest ()
+    : TestCase ("Global routing incremental update test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  void CheckRoutes (const std::string &state);
+};
+
+class GlobalRoutingCompressionTest : public TestCase
+{
+public:
+  GlobalRoutingCompressionTest ()
+    : TestCase ("Global routing FIB compression test")
+  {
+  }
+
+private:
+  virtual void DoRun ();
+
+  typedef std::map<std::string, std::string> Lookups; // "node name" -> "face:cost ..."
+
+  Lookups GetLookups (const std::vector<std::string> &names);
+  uint32_t GetFibSize ();
+};
+
+}
+
+#endif // NDNSIM_TEST_GLOBAL_ROUTING_H
@@ -25,6 +25,7 @@
 
 #include <boost/lexical_cast.hpp>
 #include "ns3/ndnSIM/model/wire/ndnsim.h"
+#include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
 
 using namespace std;
 
@@ -97,6 +98,52 @@ InterestSerializationTest::DoRun ()
                          " ----> alex zhenkai ----> ", "exclude should contain only <ANY/>");
 }
 
+void
+InterestDeriveTest::DoRun ()
+{
+  Ptr<Interest> source = Create<Interest> ();
+  source->SetName (Create<Name> (boost::lexical_cast<Name> ("/test/test2")));
+  source->SetInterestLifetime (Seconds (100));
+  source->SetNonce (200);
+
+  FwHopCountTag hopCountTag;
+  hopCountTag.Add (0);
+  hopCountTag.Increment ();
+  hopCountTag.Add (1);
+  source->GetPayload ()->AddPacketTag (hopCountTag);
+
+  Ptr<Packet> sourceWire = wire::ndnSIM::Interest::ToWire (source);
+
+  Ptr<Interest> derived = source->Derive ();
+  NS_TEST_ASSERT_MSG_EQ (derived->GetNamePtr (), source->GetNamePtr (), "name should be shared");
+  NS_TEST_ASSERT_MSG_EQ (derived->GetPayload (), source->GetPayload (), "payload should be shared");
+  NS_TEST_ASSERT_MSG_EQ (derived->GetInterestLifetime (), Seconds (100), "interest lifetime not copied");
+  NS_TEST_ASSERT_MSG_EQ (derived->GetNonce (), 200, "nonce not copied");
+  NS_TEST_ASSERT_MSG_EQ (derived->GetWire (), 0, "Wire should be empty");
+
+  derived->SetMonitored (1);
+  derived->SetServed (1);
+  derived->SetDetour (Interest::DETOUR_MONITOR);
+  NS_TEST_ASSERT_MSG_EQ (source->GetMonitored (), 0, "flags of source should not change");
+  NS_TEST_ASSERT_MSG_EQ (source->GetServed (), 0, "flags of source should not change");
+  NS_TEST_ASSERT_MSG_EQ (source->GetDetour (), Interest::DETOUR_UNDECIDED, "flags of source should not change");
+  NS_TEST_ASSERT_MSG_NE (source->GetWire (), 0, "Wire of source should not be reset");
+
+  Ptr<Interest> target = wire::ndnSIM::Interest::FromWire (wire::ndnSIM::Interest::ToWire (derived));
+  NS_TEST_ASSERT_MSG_EQ (target->GetName (), source->GetName (), "source/target name failed");
+  NS_TEST_ASSERT_MSG_EQ (target->GetNonce (), source->GetNonce (), "source/target nonce failed");
+  NS_TEST_ASSERT_MSG_EQ (target->GetMonitored (), 1, "derived/target monitored failed");
+  NS_TEST_ASSERT_MSG_EQ (target->GetServed (), 1, "derived/target served failed");
+  NS_TEST_ASSERT_MSG_EQ (target->GetDetour (), Interest::DETOUR_MONITOR, "derived/target detour failed");
+
+  FwHopCountTag targetTag;
+  NS_TEST_ASSERT_MSG_EQ (target->GetPayload ()->PeekPacketTag (targetTag), true, "hop count tag should be kept");
+  NS_TEST_ASSERT_MSG_EQ (targetTag.Get (), 1, "hop count tag changed");
+
+  derived->SetName (Create<Name> (boost::lexical_cast<Name> ("/test/test3")));
+  NS_TEST_ASSERT_MSG_EQ (source->GetName (), boost::lexical_cast<Name> ("/test/test2"), "name of source should not change");
+}
+
 void
 DataSerializationTest::DoRun ()
 {
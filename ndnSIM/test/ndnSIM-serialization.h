@@ -39,6 +39,18 @@ private:
   virtual void DoRun ();
 };
 
+class InterestDeriveTest : public TestCase
+{
+public:
+  InterestDeriveTest ()
+    : TestCase ("Interest Derive Test")
+  {
+  }
+    
+private:
+  virtual void DoRun ();
+};
+
 class DataSerializationTest : public TestCase
 {
 public:
@@ -25,6 +25,12 @@
 #include "ndnSIM-pit.h"
 #include "ndnSIM-fib-entry.h"
 #include "ndnSIM-api.h"
+#include "ndnSIM-cs-freshness.h"
+#include "ndnSIM-cs-sharded.h"
+#include "ndnSIM-cs-tiered.h"
+#include "ndnSIM-global-routing.h"
+#include "ndnSIM-face-prefix-counters.h"
+#include "ndnSIM-cc-message.h"
 
 namespace ns3
 {
@@ -38,10 +44,27 @@ public:
     SetDataDir (NS_TEST_SOURCEDIR);
 
     AddTestCase (new InterestSerializationTest (), TestCase::QUICK);
+    AddTestCase (new InterestDeriveTest (), TestCase::QUICK);
     AddTestCase (new DataSerializationTest (), TestCase::QUICK);
     AddTestCase (new FibEntryTest (), TestCase::QUICK);
+    AddTestCase (new FibFaceMetricArrayTest (), TestCase::QUICK);
+    AddTestCase (new FibEntryRttTest (), TestCase::QUICK);
+    AddTestCase (new FibHashTest (), TestCase::QUICK);
     AddTestCase (new PitTest (), TestCase::QUICK);
     AddTestCase (new ApiTest (), TestCase::QUICK);
+    AddTestCase (new CsFreshnessTest (), TestCase::QUICK);
+    AddTestCase (new CsShardedTest (), TestCase::QUICK);
+    AddTestCase (new MappedDataLogTest (), TestCase::QUICK);
+    AddTestCase (new CsTieredTest (), TestCase::QUICK);
+    AddTestCase (new GlobalRoutingTest (), TestCase::QUICK);
+    AddTestCase (new GlobalRoutingUpdateTest (), TestCase::QUICK);
+    AddTestCase (new GlobalRoutingCompressionTest (), TestCase::QUICK);
+    AddTestCase (new FacePrefixCountersTest (), TestCase::QUICK);
+    AddTestCase (new SpaceSavingTest (), TestCase::QUICK);
+    AddTestCase (new RecentNamesTest (), TestCase::QUICK);
+    AddTestCase (new FaceSatisfactionTest (), TestCase::QUICK);
+    AddTestCase (new LocallyMonitoredTagTest (), TestCase::QUICK);
+    AddTestCase (new CCMessageTest (), TestCase::QUICK);
   }
 };
 
@@ -0,0 +1,205 @@
+#include "cc-app.h"
+#include "cc.h"
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ptr.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/ndn-interest.h"
+#include "ns3/ndn-data.h"
+#include "ns3/ndn-fib.h"
+#include "ns3/ndn-wire.h"
+
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE ("CCApp");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED (CCApp);
+
+TypeId CCApp::GetTypeId ()
+{
+    static TypeId tid = TypeId ("CCApp")
+        .SetParent<App> ()
+        .AddConstructor<CCApp> ()
+
+        .AddAttribute("LifeTime", "Lifetime of update Interests (they are sent again if not acknowledged by then)",
+                      TimeValue (Seconds (1)),
+                      MakeTimeAccessor (&CCApp::m_interestLifetime),
+                      MakeTimeChecker ());
+  return tid;
+}
+
+void CCApp::StartApplication ()
+{
+    App::StartApplication();
+
+    m_rand = UniformVariable(0, std::numeric_limits<uint32_t>::max ());
+
+    // Receive the reports of all monitors
+    Ptr<Fib> fib = GetNode()->GetObject<Fib> ();
+    Ptr<fib::Entry> fibEntry = fib->Add (getReportPrefix(), m_face, 0);
+    fibEntry->UpdateStatus (m_face, fib::FaceMetric::NDN_FIB_GREEN);
+
+    CC::setApp(this);
+}
+
+void CCApp::StopApplication ()
+{
+    App::StopApplication();
+}
+
+Name CCApp::getReportPrefix()
+{
+    Name prefix;
+    prefix.append("cc").append("report");
+    return prefix;
+}
+
+Name CCApp::getUpdatePrefix(uint32_t monitorId)
+{
+    Name prefix;
+    prefix.append("cc").append("update").append(boost::lexical_cast<std::string>(monitorId));
+    return prefix;
+}
+
+Ptr<Interest> CCApp::createInterest(const Name &prefix, uint32_t seq, const std::string &message, UniformVariable &rand, Time lifetime)
+{
+    Ptr<Name> name = Create<Name> (prefix);
+    name->appendSeqNum(seq);
+    name->append(message);
+
+    Ptr<Interest> interest = Create<Interest> ();
+    interest->SetName (name);
+    interest->SetNonce (rand.GetValue ());
+    interest->SetInterestLifetime (lifetime);
+
+    // Control messages don't have to be monitored
+    interest->SetMonitored(1);
+
+    return interest;
+}
+
+Ptr<Data> CCApp::createAck(Ptr<const Interest> interest)
+{
+    Ptr<Data> data = Create<Data> (Create<Packet> ());
+    data->SetName (Create<Name> (interest->GetName ()));
+    data->SetTimestamp (Simulator::Now());
+    return data;
+}
+
+void CCApp::OnInterest (Ptr<const Interest> interest)
+{
+    App::OnInterest (interest);
+
+    // /cc/report/<monitor node id>/<seq>/<message>
+    const Name &name = interest->GetName();
+    if(name.size() != 5 || name.getPrefix(2) != getReportPrefix())
+        return;
+
+    uint32_t monitorId;
+    try
+    {
+        monitorId = boost::lexical_cast<uint32_t>(name.get(2).toUri());
+    }
+    catch(boost::bad_lexical_cast &)
+    {
+        NS_LOG_WARN("Invalid report " << name);
+        return;
+    }
+
+    CC::countReceived(Wire::FromInterest(interest)->GetSize());
+
+    uint32_t seq = name.get(3).toSeqNum();
+    const name::Component &message = name.get(4);
+    PrefixTotals::PerNameCounter timedOutEntriesPerName;
+    if(!monitors[monitorId].decoder.decode(seq, std::string(message.begin(), message.end()), timedOutEntriesPerName))
+    {
+        NS_LOG_WARN("Cannot decode report of monitor " << monitorId);
+        return;
+    }
+
+    NS_LOG_INFO("Report of monitor " << monitorId << " with " << timedOutEntriesPerName.size() << " prefixes");
+
+    // Acknowledge first, so that the report is answered before any updates caused by it
+    Ptr<Data> ack = createAck(interest);
+    CC::countSent(Wire::FromData(ack)->GetSize());
+    m_face->ReceiveData (ack);
+    m_transmittedDatas (ack, this, m_face);
+
+    CC::report(monitorId, timedOutEntriesPerName);
+}
+
+void CCApp::OnData (Ptr<const Data> contentObject)
+{
+    App::OnData (contentObject);
+
+    // Acknowledged update: /cc/update/<monitor node id>/<version>/<message>
+    const Name &name = contentObject->GetName();
+    if(name.size() != 5)
+        return;
+
+    uint32_t monitorId;
+    try
+    {
+        monitorId = boost::lexical_cast<uint32_t>(name.get(2).toUri());
+    }
+    catch(boost::bad_lexical_cast &)
+    {
+        return;
+    }
+
+    if(name.getPrefix(3) != getUpdatePrefix(monitorId) || monitors.find(monitorId) == monitors.end())
+        return;
+
+    CC::countReceived(Wire::FromData(contentObject)->GetSize());
+
+    Monitor &monitor = monitors[monitorId];
+    uint32_t version = name.get(3).toSeqNum();
+    monitor.encoder.acknowledge(version);
+    monitor.acknowledged = std::max(monitor.acknowledged, version);
+}
+
+void CCApp::sendUpdate(uint32_t monitorId, const std::set<Name> &prefixes)
+{
+    Monitor &monitor = monitors[monitorId];
+    monitor.version++;
+    monitor.prefixes = prefixes;
+
+    sendUpdateInterest(monitorId);
+}
+
+void CCApp::sendUpdateInterest(uint32_t monitorId)
+{
+    Monitor &monitor = monitors[monitorId];
+
+    std::string message = monitor.encoder.encode(monitor.version, monitor.prefixes);
+    Ptr<Interest> interest = createInterest(getUpdatePrefix(monitorId), monitor.version, message, m_rand, m_interestLifetime);
+
+    NS_LOG_INFO("Update " << monitor.version << " to monitor " << monitorId << " with " << monitor.prefixes.size() << " prefixes");
+
+    CC::countSent(Wire::FromInterest(interest)->GetSize());
+    m_transmittedInterests (interest, this, m_face);
+    m_face->ReceiveInterest (interest);
+
+    Simulator::Schedule(m_interestLifetime, &CCApp::onTimerUpdate, this, monitorId, monitor.version);
+}
+
+void CCApp::onTimerUpdate(uint32_t monitorId, uint32_t version)
+{
+    Monitor &monitor = monitors[monitorId];
+    if(!m_active || monitor.version != version || monitor.acknowledged >= version)
+        // Acknowledged or replaced by a newer update
+        return;
+
+    sendUpdateInterest(monitorId);
+}
+
+} // namespace ndn
+} // namespace ns3
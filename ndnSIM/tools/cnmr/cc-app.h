@@ -0,0 +1,78 @@
+#ifndef CC_APP_H_
+#define CC_APP_H_
+
+#include "ns3/ndn-app.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable.h"
+#include "ns3/ndnSIM/ndn.cxx/name.h"
+
+#include "ns3/ndnSIM/utils/cc-message.h"
+
+#include <map>
+#include <set>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * The network side of the CC: monitors send their reports as Interests to /cc/report, the CC
+ * sends the malicious prefixes as Interests to /cc/update/<monitor node id>. Both carry the
+ * message (see CCMessageEncoder) in the last name component and are acknowledged with an empty
+ * Data packet, so control messages compete for links and PITs like any other traffic.
+ *
+ *   /cc/report/<monitor node id>/<seq>/<message>
+ *   /cc/update/<monitor node id>/<version>/<message>
+ *
+ * Updates that are not acknowledged within the Interest lifetime are sent again, unless a newer
+ * update for the monitor has been sent in the meantime. Control Interests are marked as monitored,
+ * so they are forwarded on the shortest path.
+ */
+class CCApp : public ndn::App
+{
+public:
+    static TypeId GetTypeId ();
+    virtual void StartApplication ();
+    virtual void StopApplication ();
+    virtual void OnInterest (Ptr<const ndn::Interest> interest);
+    virtual void OnData (Ptr<const ndn::Data> contentObject);
+
+    // Send the malicious prefixes to the monitor
+    void sendUpdate(uint32_t monitorId, const std::set<Name> &prefixes);
+
+    static Name getReportPrefix();
+    static Name getUpdatePrefix(uint32_t monitorId);
+
+    // Build a control Interest (prefix/<seq>/<message>)
+    static Ptr<Interest> createInterest(const Name &prefix, uint32_t seq, const std::string &message, UniformVariable &rand, Time lifetime);
+    // Empty Data acknowledging a control Interest
+    static Ptr<Data> createAck(Ptr<const Interest> interest);
+
+private:
+    struct Monitor
+    {
+        Monitor() : version(0), acknowledged(0) {}
+
+        // Decodes the reports of the monitor
+        CCMessageDecoder decoder;
+        // Encodes the updates to the monitor
+        CCMessageEncoder encoder;
+
+        // Version of the last update (starting from 1) and of the last acknowledged update
+        uint32_t version;
+        uint32_t acknowledged;
+        std::set<Name> prefixes;
+    };
+
+    void sendUpdateInterest(uint32_t monitorId);
+    void onTimerUpdate(uint32_t monitorId, uint32_t version);
+
+    std::map<uint32_t, Monitor> monitors;
+
+    UniformVariable m_rand;
+    Time m_interestLifetime;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // CC_APP_H_
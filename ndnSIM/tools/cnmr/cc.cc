@@ -1,10 +1,9 @@
 #include "cc.h"
+#include "cc-app.h"
 #include "ns3/core-module.h"
 #include "ns3/log.h"
 #include "ns3/simulation-singleton.h"
 
-#include <boost/foreach.hpp>
-
 NS_LOG_COMPONENT_DEFINE ("CC");
 
 namespace ns3 {
@@ -30,6 +29,14 @@ CC::CC()
     DoubleValue v_gamma;
     g_gamma.GetValue(v_gamma);
     gamma = v_gamma.Get();
+
+    timedOutEntriesPerName.setThreshold(pitSize, gamma);
+
+    sizeMessagesSent = 0;
+    sizeMessagesReceived = 0;
+    numMessagesSent = 0;
+    numMessagesReceived = 0;
+    reportsCurrentPeriod = 0;
 }
 
 CC::~CC()
@@ -37,87 +44,58 @@ CC::~CC()
     os.close();
 }
 
-void CC::report(Ptr<Node> node, CNMRReport report)
+void CC::report(uint32_t nodeId, const PrefixTotals::PerNameCounter &timedOutEntriesPerName)
 {
     // Get the singleton of the CC
     CC *cc = SimulationSingleton<CC>::Get();
 
-    // Count the number of control messages received
-    cc->numMessagesReceived++;
+    // Report back to every monitor that reports to the CC
+    cc->monitors.insert(nodeId);
 
-    uint32_t nodeId = node->GetId();
+    cc->reportsCurrentPeriod++;
 
-    if(cc->monitors[nodeId] == 0)
-    {
-        // Save a reference to every monitor that reports to the CC, so that the CC can report back
-        // to those monitors
-        cc->monitors[nodeId] = node->GetObject<ndn::fw::MonitorAwareRouting>();
-    }
+    cc->checkForAttack(nodeId, timedOutEntriesPerName);
+}
 
-    // Just save the report
-    cc->reportsCurrentPeriod[nodeId].push_back(report);
-    cc->lastReports[nodeId] = report;
+void CC::setApp(Ptr<CCApp> app)
+{
+    SimulationSingleton<CC>::Get()->app = app;
+}
 
-    // Calculate the size of the report
-    double sizeMsg = cc->getSizeReport(report);
-    cc->sizeReports += sizeMsg;
-    cc->sizeMessagesReceived += sizeMsg;
+void CC::countReceived(uint32_t size)
+{
+    CC *cc = SimulationSingleton<CC>::Get();
     cc->numMessagesReceived++;
-
-    cc->checkForAttack();
+    cc->sizeMessagesReceived += size;
 }
 
-void CC::checkForAttack(void)
+void CC::countSent(uint32_t size)
 {
-    std::set<Name> maliciousPrefixes;
-
-    std::map<Name, std::vector<int> > timedOutEntriesPerName;
+    CC *cc = SimulationSingleton<CC>::Get();
+    cc->numMessagesSent++;
+    cc->sizeMessagesSent += size;
+}
 
-    // Aggregate reported PIT usages of nodes and check if the usage of one prefix is above threshold
-    for(std::map<uint32_t, CNMRReport>::const_iterator it = lastReports.begin(); it != lastReports.end(); ++it)
+void CC::checkForAttack(uint32_t nodeId, const PrefixTotals::PerNameCounter &timedOutEntriesPerName)
+{
+    // Aggregate reported PIT usages of nodes and check if the usage of one prefix is above
+    // threshold. The report replaces the last report of the node, so only the prefixes of these
+    // two reports are checked.
+    if(!this->timedOutEntriesPerName.update(nodeId, timedOutEntriesPerName))
     {
-        CNMRReport report = it->second;
-        for(MonitorAwareRouting::PerNameCounter::iterator count = report.timedOutEntriesPerName.begin(); count != report.timedOutEntriesPerName.end(); ++count)
-        {
-            timedOutEntriesPerName[count->first].push_back(count->second);
-        }
+        // The malicious prefixes are the same as the prefixes that the CC reported as malicious
+        // the last time
+        return;
     }
 
-    std::pair<Name, std::vector<int> > d;
-    BOOST_FOREACH(d, timedOutEntriesPerName)
-    {
-        uint32_t numTimedOut = 0;
-        BOOST_FOREACH(int i, d.second)
-        {
-            numTimedOut += i;
-        }
-
-        float expireRatio = (float)numTimedOut / pitSize;
-
-        if(expireRatio >= gamma)
-        {
-            maliciousPrefixes.insert(d.first);
-        }
-    }
+    const std::set<Name> &maliciousPrefixes = this->timedOutEntriesPerName.getPrefixesAbove();
 
-    // If the determined malicious prefix are different from the prefixes that the CC reported as
-    // malicious the last time, report it!
-    if(maliciousPrefixes != lastReportedPrefixes)
+    // The determined malicious prefix are different from the prefixes that the CC reported as
+    // malicious the last time, report it to CNMRs! The messages are counted by the app when they
+    // are sent.
+    for(std::set<uint32_t>::const_iterator it = monitors.begin(); it != monitors.end(); ++it)
     {
-        // the name for routing the control message, e.g. /cc/control_message/
-        double sizeMsg = sizeof(Name) + sizeof(uint32_t) + (maliciousPrefixes.size() * sizeof(Name));
-        sizeReports += sizeMsg;
-        numMessagesSent++;
-        sizeMessagesSent += sizeMsg;
-
-        lastReportedPrefixes = maliciousPrefixes;
-
-        // Report to CNMRs
-        for(std::map<uint32_t, Ptr<ndn::fw::MonitorAwareRouting> >::const_iterator it = monitors.begin(); it != monitors.end(); ++it)
-        {
-            it->second->setMaliciousPrefixes(maliciousPrefixes);
-        }
-
+        app->sendUpdate(*it, maliciousPrefixes);
     }
 }
 
@@ -142,13 +120,12 @@ void CC::setFilename(std::string filename)
  */
 void CC::print(void)
 {
-    if(reportsCurrentPeriod.size() == 0)
+    if(reportsCurrentPeriod == 0)
         // No reports -> don't print to file
         return;
 
     Time time = Simulator::Now ();
 
-    // os << time.ToDouble(Time::S) << "\tCC\tall\t" << "Overhead\t" << sizeReports << "\n";
     os << time.ToDouble(Time::S) << "\tCC\tall\t" << "NumReceived\t" << numMessagesReceived << "\n";
     os << time.ToDouble(Time::S) << "\tCC\tall\t" << "NumSent\t" << numMessagesSent << "\n";
     os << time.ToDouble(Time::S) << "\tCC\tall\t" << "SizeReceived\t" << sizeMessagesReceived << "\n";
@@ -157,8 +134,7 @@ void CC::print(void)
     os.flush();
 
     // Reset stats
-    reportsCurrentPeriod.clear();
-    sizeReports = 0;
+    reportsCurrentPeriod = 0;
     numMessagesSent = 0;
     numMessagesReceived = 0;
     sizeMessagesSent = 0;
@@ -172,25 +148,5 @@ void CC::onTimerPrint(void)
     Simulator::Schedule(Seconds(intervalPrint), &CC::onTimerPrint, this);
 }
 
-/**
- * Returns the size of the report if it would have been transmitted over the wire.
- */
-double CC::getSizeReport(CNMRReport &report)
-{
-    // Important: keep this up to date
-
-    double size = 0;
-
-    // the name for routing the control message, e.g. /cc/control_message/
-    size += 1 * sizeof(Name);
-
-    // the name for routing the control message, e.g. /cc/control_message/
-    size += 1 * sizeof(uint32_t);
-
-    size += report.timedOutEntriesPerName.size() * (sizeof(Name) + sizeof(uint32_t));
-
-    return size;
-}
-
 } // namespace ndn
 } // namespace ns3
@@ -6,19 +6,30 @@
 #include <vector>
 
 #include "monitor-app.h"
+#include "prefix-totals.h"
 
 namespace ns3 {
 namespace ndn {
 
+class CCApp;
+
 class CC
 {
 public:
     CC();
     ~CC();
 
-    static void report(Ptr<Node> node, CNMRReport report);
+    // Called by the CCApp for every report of a monitor it has received
+    static void report(uint32_t nodeId, const PrefixTotals::PerNameCounter &timedOutEntriesPerName);
     static void setFilename(std::string filename);
 
+    // The app that sends and receives the control messages of the CC
+    static void setApp(Ptr<CCApp> app);
+
+    // Count control messages (Interests and their acknowledging Data) by their wire size
+    static void countReceived(uint32_t size);
+    static void countSent(uint32_t size);
+
 private:
     uint32_t pitSize;
     float gamma;
@@ -26,32 +37,33 @@ private:
     std::string filename;
     std::ofstream os;
 
-    // The CC saves the last report it has sent to CNMRs to be able to detect when an attack stopped
-    std::set<Name> lastReportedPrefixes;
-    std::map<uint32_t, Ptr<ndn::fw::MonitorAwareRouting> > monitors;
+    Ptr<CCApp> app;
+
+    // Every monitor that reports to the CC, so that the CC can report back to those monitors
+    std::set<uint32_t> monitors;
 
     typedef std::map<uint32_t, std::vector<std::pair<int, int> > >  NodePairsMap;
 
     // The interval at which CC information should be printed (seconds) to file for evaluation
     uint32_t intervalPrint;
 
-    double sizeReports;
     double sizeMessagesSent;
     double sizeMessagesReceived;
     uint32_t numMessagesSent;
     uint32_t numMessagesReceived;
 
-    static double getSizeReport(CNMRReport &report);
-
     void print(void);
 
     void onTimerPrint(void);
 
-    void checkForAttack(void);
+    void checkForAttack(uint32_t nodeId, const PrefixTotals::PerNameCounter &timedOutEntriesPerName);
+
+    uint32_t reportsCurrentPeriod;
 
-    typedef std::map<uint32_t, std::vector<CNMRReport> > ReportMap;
-    ReportMap reportsCurrentPeriod;
-    std::map<uint32_t, CNMRReport> lastReports;
+    // Timed out entries per prefix summed over the last reports of all monitors. Its prefixes
+    // above the threshold are the malicious prefixes the CC has sent to CNMRs last, which are
+    // needed to detect when an attack stopped.
+    PrefixTotals timedOutEntriesPerName;
 };
 
 } // namespace ndn
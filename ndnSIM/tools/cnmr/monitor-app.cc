@@ -1,7 +1,6 @@
 #include "monitor-app.h"
-#include "cc.h"
+#include "cc-app.h"
 #include "ns3/ndnSIM/model/fw/monitor-aware-routing.h"
-#include "ns3/ndnSIM/utils/ndn-fw-hop-count-tag.h"
 
 #include "ns3/core-module.h"
 #include "ns3/ndnSIM-module.h"
@@ -22,6 +21,8 @@
 #include "ns3/ndn-l3-protocol.h"
 
 #include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("MonitorApp");
 
@@ -42,6 +43,11 @@ TypeId MonitorApp::GetTypeId ()
         .AddAttribute("ObservationPeriod", "Interval at which a monitor reports to the CC",
                       TimeValue (Seconds (2)),
                       MakeTimeAccessor (&MonitorApp::m_observationPeriod),
+                      MakeTimeChecker ())
+
+        .AddAttribute("ControlLifeTime", "Lifetime of report Interests to the CC",
+                      TimeValue (Seconds (1)),
+                      MakeTimeAccessor (&MonitorApp::m_controlLifetime),
                       MakeTimeChecker ());
   return tid;
 }
@@ -75,6 +81,14 @@ void MonitorApp::StartApplication ()
   m_face->SetUp (true);
   // END INLINED ndn::App::StartApplication ();
 
+  m_controlFace = CreateObject<AppFace> (this);
+  node->GetObject<L3Protocol> ()->AddFace (m_controlFace);
+  m_controlFace->SetUp (true);
+
+  m_rand = UniformVariable (0, std::numeric_limits<uint32_t>::max ());
+  reportSeq = 0;
+  updateVersion = 0;
+
   Ptr<Name> prefix = Create<Name> ();
   prefix->append ("localmonitor");
 
@@ -89,27 +103,36 @@ void MonitorApp::StartApplication ()
   Ptr<fib::Entry> fibEntry = fib->Add (*prefix, m_face, 0);
   fibEntry->UpdateStatus (m_face, fib::FaceMetric::NDN_FIB_GREEN);
 
+  // Receive the updates of the CC
+  Ptr<fib::Entry> updateEntry = fib->Add (CCApp::getUpdatePrefix(node->GetId()), m_controlFace, 0);
+  updateEntry->UpdateStatus (m_controlFace, fib::FaceMetric::NDN_FIB_GREEN);
+
   Simulator::Schedule(m_observationPeriod, &MonitorApp::onTimerObservationPeriod, this);
 
     // Remove FIB entries to other monitors (monitors don't need that)
     monitorPrefix.append("monitor");
     fib->Remove(&monitorPrefix);
 
-    // Share distances to servers to global module so that other routers can access it
-    for (Ptr<fib::Entry> entry = fib->Begin (); entry != fib->End (); entry = fib->Next (entry))
+    // Distances to servers are shared with other routers via the global module. They are
+    // reported by GlobalRoutingHelper for monitors registered before routes are calculated,
+    // otherwise the monitor reports them from its FIB.
+    if(fw::GlobalRoutingInfo::getMonitorIndex(node->GetId()) == fw::GlobalRoutingInfo::NO_MONITOR)
     {
-        if(entry->GetPrefix().size() > 1 && monitorPrefix.compare(entry->GetPrefix().getPrefix(0, 2)) != 0)
+        for (Ptr<fib::Entry> entry = fib->Begin (); entry != fib->End (); entry = fib->Next (entry))
         {
-            // Skip FIB entries to other monitors. They are not of interest here.
-            continue;
-        }
+            if(entry->GetPrefix().size() > 1 && monitorPrefix.compare(entry->GetPrefix().getPrefix(0, 2)) != 0)
+            {
+                // Skip FIB entries to other monitors. They are not of interest here.
+                continue;
+            }
 
-        BOOST_FOREACH (const fib::FaceMetric &metricFace, entry->m_faces.get<fib::i_metric> ())
-        {
-            if(metricFace.GetRoutingCost() != 0)
+            BOOST_FOREACH (const fib::FaceMetric &metricFace, entry->m_faces.get<fib::i_metric> ())
             {
-                // If routing cost is zero, this is a local app -> don't report that
-                fw::GlobalRoutingInfo::put(node->GetId(), entry->GetPrefix(), metricFace.GetRoutingCost());
+                if(metricFace.GetRoutingCost() != 0)
+                {
+                    // If routing cost is zero, this is a local app -> don't report that
+                    fw::GlobalRoutingInfo::put(node->GetId(), entry->GetPrefix(), metricFace.GetRoutingCost());
+                }
             }
         }
     }
@@ -121,6 +144,13 @@ void MonitorApp::StartApplication ()
 
 void MonitorApp::StopApplication ()
 {
+    if(m_active)
+    {
+        m_controlFace->SetUp (false);
+        node->GetObject<L3Protocol> ()->RemoveFace (m_controlFace);
+        m_controlFace = 0;
+    }
+
     // cleanup ndn::App
     App::StopApplication ();
 }
@@ -129,6 +159,12 @@ void MonitorApp::OnInterest (Ptr<const Interest> interest)
 {
     App::OnInterest (interest);
 
+    if(interest->GetName().getPrefix(3) == CCApp::getUpdatePrefix(node->GetId()))
+    {
+        onUpdate(interest);
+        return;
+    }
+
     if(interest->GetMonitored() > 1)
         // Don't monitor an already observed interest
         return;
@@ -142,18 +178,10 @@ void MonitorApp::OnInterest (Ptr<const Interest> interest)
     {
         // NS_LOG_INFO("Monitored interest but it's not served. Forwarding...");
 
-        FwHopCountTag hopCountTag;
-        interest->GetPayload ()->PeekPacketTag (hopCountTag);
-
-        Ptr<Name> nameWithSequence = Create<Name> (interest->GetName ());
-
-        Ptr<Interest> newInterest = Create<Interest> ();
-        newInterest->SetNonce (interest->GetNonce ());
-        newInterest->SetName (interest->GetName ());
-        newInterest->SetInterestLifetime (interest->GetInterestLifetime ());
+        // The monitored interest shares name and payload (with the hop count tag) with this interest
+        Ptr<Interest> newInterest = interest->Derive();
         newInterest->SetMonitored(1);
         newInterest->SetServed(0);
-        newInterest->GetPayload()->AddPacketTag(hopCountTag);
 
         m_face->ReceiveInterest (newInterest);
     }
@@ -169,11 +197,60 @@ void MonitorApp::OnData (Ptr<const Data> contentObject)
 {
     App::OnData (contentObject);
     NS_LOG_INFO ("Receiving Data packet for " << contentObject->GetName ());
+
+    // Acknowledged report: /cc/report/<node id>/<seq>/<message>
+    const Name &name = contentObject->GetName();
+    if(name.size() == 5 && name.getPrefix(2) == CCApp::getReportPrefix()
+            && name.get(2).toUri() == boost::lexical_cast<std::string>(node->GetId()))
+    {
+        reportEncoder.acknowledge(name.get(3).toSeqNum());
+    }
+}
+
+void MonitorApp::sendReport(const CNMRReport &report)
+{
+    Name prefix = CCApp::getReportPrefix();
+    prefix.append(boost::lexical_cast<std::string>(node->GetId()));
+
+    std::string message = reportEncoder.encode(reportSeq, report.timedOutEntriesPerName);
+    Ptr<Interest> interest = CCApp::createInterest(prefix, reportSeq, message, m_rand, m_controlLifetime);
+    reportSeq++;
+
+    m_transmittedInterests (interest, this, m_controlFace);
+    m_controlFace->ReceiveInterest (interest);
+}
+
+void MonitorApp::onUpdate(Ptr<const Interest> interest)
+{
+    // /cc/update/<node id>/<version>/<message>
+    const Name &name = interest->GetName();
+    if(name.size() != 5)
+        return;
+
+    uint32_t version = name.get(3).toSeqNum();
+    const name::Component &message = name.get(4);
+    std::set<Name> maliciousPrefixes;
+    if(!updateDecoder.decode(version, std::string(message.begin(), message.end()), maliciousPrefixes))
+    {
+        NS_LOG_WARN("Cannot decode update " << name);
+        return;
+    }
+
+    // Updates can arrive out of order (or twice, if an acknowledgement got lost)
+    if(version > updateVersion)
+    {
+        updateVersion = version;
+        mar->setMaliciousPrefixes(maliciousPrefixes);
+    }
+
+    Ptr<Data> ack = CCApp::createAck(interest);
+    m_controlFace->ReceiveData (ack);
+    m_transmittedDatas (ack, this, m_controlFace);
 }
 
 void MonitorApp::onTimerObservationPeriod(void)
 {
-    if(detection >= 3)
+    if(detection == 3)
     {
         // Only report to CC when a detection scheme with CC help is used
         CNMRReport report;
@@ -188,7 +265,7 @@ void MonitorApp::onTimerObservationPeriod(void)
         report.timedOutEntriesPerName = mar->getEntriesPerNameUnmonitored();
 
         if(report.timedOutEntriesPerName.size() > 0)
-            CC::report(node, report);
+            sendReport(report);
     }
 
     // Reset the stats at this monitor node
@@ -6,8 +6,10 @@
 #include "ns3/ndn-app.h"
 #include "ns3/ndn-pit.h"
 #include "ns3/nstime.h"
+#include "ns3/random-variable.h"
 #include "ns3/ndnSIM/ndn.cxx/name.h"
 #include "../src/ndnSIM/model/fw/monitor-aware-routing.h"
+#include "ns3/ndnSIM/utils/cc-message.h"
 
 namespace ns3 {
 namespace ndn {
@@ -51,6 +53,21 @@ private:
     void onTimerObservationPeriod(void);
 
     uint32_t detection;
+
+    // Control messages from and to the CC (see CCApp) use their own face, which the forwarding
+    // strategy treats like the face of any other app
+    Ptr<Face> m_controlFace;
+    Time m_controlLifetime;
+    UniformVariable m_rand;
+
+    CCMessageEncoder reportEncoder;
+    uint32_t reportSeq;
+    CCMessageDecoder updateDecoder;
+    // Version of the last update of the malicious prefixes applied
+    uint32_t updateVersion;
+
+    void sendReport(const CNMRReport &report);
+    void onUpdate(Ptr<const Interest> interest);
 };
 
 } // namespace ndn
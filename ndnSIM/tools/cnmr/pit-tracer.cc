@@ -218,6 +218,7 @@ PitTracer::Connect ()
 
     mar->TraceConnectWithoutContext ("EntriesSatisfiedBefore", MakeCallback (&PitTracer::EntriesSatisfiedBefore, this));
     mar->TraceConnectWithoutContext ("MaliciousRequestedMulti", MakeCallback (&PitTracer::MaliciousRequestedMulti, this));
+    mar->TraceConnectWithoutContext ("PathStretch", MakeCallback (&PitTracer::PathStretch, this));
 
     Reset();
 }
@@ -256,6 +257,8 @@ PitTracer::Reset ()
     entries = 0;
     entriesSatisfiedBefore = 0;
     maliciousRequestedMulti = 0;
+    pathStretchSum = 0;
+    pathStretchCount = 0;
 }
 
 #define PRINTER(printName, fieldName)           \
@@ -275,6 +278,10 @@ PitTracer::Print (std::ostream &os) const
         PRINTER ("EntriesSatisfiedBefore", entriesSatisfiedBefore);
         PRINTER ("MaliciousRequestedMulti", maliciousRequestedMulti);
     }
+    if(pathStretchCount > 0)
+    {
+        PRINTER ("PathStretch", pathStretchSum / pathStretchCount);
+    }
 }
 
 void PitTracer::PitUsage (double usage, uint32_t entries)
@@ -293,5 +300,11 @@ void PitTracer::MaliciousRequestedMulti(uint32_t entries)
     this->maliciousRequestedMulti = entries;
 }
 
+void PitTracer::PathStretch(Ptr<const Interest> interest, double stretch)
+{
+    this->pathStretchSum += stretch;
+    this->pathStretchCount++;
+}
+
 } // namespace ndn
 } // namespace ns3
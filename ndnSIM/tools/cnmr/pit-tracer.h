@@ -139,6 +139,7 @@ private:
   void PitUsage (double usage, uint32_t entries);
   void EntriesSatisfiedBefore(uint32_t entries);
   void MaliciousRequestedMulti(uint32_t entries);
+  void PathStretch(Ptr<const Interest> interest, double stretch);
   
 private:
   void
@@ -161,6 +162,10 @@ private:
   uint32_t entriesSatisfiedBefore;
   uint32_t maliciousRequestedMulti;
 
+  // MAR-3 path stretch of the interests forwarded in the current period
+  double pathStretchSum;
+  uint32_t pathStretchCount;
+
   boost::shared_ptr<std::ostream> m_os;
 
   Time m_period;
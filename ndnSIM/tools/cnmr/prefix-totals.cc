@@ -0,0 +1,100 @@
+#include "prefix-totals.h"
+
+namespace ns3 {
+namespace ndn {
+
+PrefixTotals::PrefixTotals()
+    : pitSize(1)
+    , gamma(1)
+{
+}
+
+void PrefixTotals::setThreshold(uint32_t pitSize, float gamma)
+{
+    this->pitSize = pitSize;
+    this->gamma = gamma;
+
+    // Check all prefixes against the new threshold
+    prefixesAbove.clear();
+    for(boost::unordered_map<Name, Total>::const_iterator it = totals.begin(); it != totals.end(); ++it)
+    {
+        if(isAbove(it->second.count))
+            prefixesAbove.insert(it->first);
+    }
+}
+
+bool PrefixTotals::update(uint32_t monitorId, const PerNameCounter &counts)
+{
+    PerNameCounter &last = lastCounts[monitorId];
+    bool changed = false;
+
+    // Both reports are sorted by name, so the difference is found in one pass over both
+    PerNameCounter::const_iterator oldCount = last.begin();
+    PerNameCounter::const_iterator newCount = counts.begin();
+    while(oldCount != last.end() || newCount != counts.end())
+    {
+        if(newCount == counts.end() || (oldCount != last.end() && oldCount->first < newCount->first))
+        {
+            changed |= add(oldCount->first, -1, oldCount->second, 0);
+            ++oldCount;
+        }
+        else if(oldCount == last.end() || newCount->first < oldCount->first)
+        {
+            changed |= add(newCount->first, 1, 0, newCount->second);
+            ++newCount;
+        }
+        else
+        {
+            changed |= add(newCount->first, 0, oldCount->second, newCount->second);
+            ++oldCount;
+            ++newCount;
+        }
+    }
+
+    last = counts;
+    return changed;
+}
+
+uint32_t PrefixTotals::getTotal(const Name &prefix) const
+{
+    boost::unordered_map<Name, Total>::const_iterator total = totals.find(prefix);
+    return total == totals.end() ? 0 : total->second.count;
+}
+
+const std::set<Name> &PrefixTotals::getPrefixesAbove() const
+{
+    return prefixesAbove;
+}
+
+bool PrefixTotals::isAbove(uint32_t count) const
+{
+    return (float)count / pitSize >= gamma;
+}
+
+bool PrefixTotals::add(const Name &prefix, int reportsDelta, uint32_t oldCount, uint32_t newCount)
+{
+    if(reportsDelta == 0 && oldCount == newCount)
+        return false;
+
+    Total &total = totals[prefix];
+    total.count = total.count - oldCount + newCount;
+    total.reports += reportsDelta;
+
+    bool wasAbove = prefixesAbove.count(prefix) > 0;
+    bool above = total.reports > 0 && isAbove(total.count);
+
+    if(total.reports == 0)
+        totals.erase(prefix);
+
+    if(above == wasAbove)
+        return false;
+
+    if(above)
+        prefixesAbove.insert(prefix);
+    else
+        prefixesAbove.erase(prefix);
+    return true;
+}
+
+} // namespace ndn
+} // namespace ns3
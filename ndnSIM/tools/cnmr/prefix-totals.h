@@ -0,0 +1,64 @@
+#ifndef PREFIX_TOTALS_H_
+#define PREFIX_TOTALS_H_
+
+#include "ns3/ndnSIM/ndn.cxx/name.h"
+
+#include <boost/unordered_map.hpp>
+#include <map>
+#include <set>
+#include <stdint.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Totals of the timed out PIT entries per prefix over the last reports of all monitors, and the
+ * prefixes whose total is above the threshold of the CC.
+ *
+ * A new report of a monitor replaces its last one. Only the difference between the two reports
+ * is applied to the totals, and only prefixes whose total changes are checked against the
+ * threshold. A report therefore costs O(size of both reports) instead of O(monitors × prefixes).
+ */
+class PrefixTotals
+{
+public:
+    typedef std::map<Name, uint32_t> PerNameCounter;
+
+    PrefixTotals();
+
+    // A prefix is above the threshold if total / pitSize >= gamma
+    void setThreshold(uint32_t pitSize, float gamma);
+
+    // Replace the last report of the monitor. Return whether the prefixes above the threshold
+    // have changed.
+    bool update(uint32_t monitorId, const PerNameCounter &counts);
+
+    uint32_t getTotal(const Name &prefix) const;
+    const std::set<Name> &getPrefixesAbove() const;
+
+private:
+    struct Total
+    {
+        Total() : count(0), reports(0) {}
+
+        uint32_t count;
+        // Number of last reports with the prefix (a prefix is only checked while it is reported)
+        uint32_t reports;
+    };
+
+    bool isAbove(uint32_t count) const;
+    bool add(const Name &prefix, int reportsDelta, uint32_t oldCount, uint32_t newCount);
+
+    uint32_t pitSize;
+    float gamma;
+
+    std::map<uint32_t, PerNameCounter> lastCounts;
+    boost::unordered_map<Name, Total> totals;
+    std::set<Name> prefixesAbove;
+
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
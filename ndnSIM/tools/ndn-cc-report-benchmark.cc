@@ -0,0 +1,138 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+// Processing time of the CC for the reports of many monitors: recomputing the totals per prefix
+// from the last reports of all monitors on every report (as CC::checkForAttack did before) and
+// updating running totals by the difference between the last and the new report of a monitor
+// (ns3::ndn::PrefixTotals).
+//
+// Every observation period each monitor (--monitors) reports the timed out entries of a few of the
+// prefixes (--prefixes, --perReport).  During the attack periods some monitors report many timed
+// out entries for the attacked prefix.  Both variants have to find the same malicious prefixes
+// after every report.
+//
+// ./waf --run "ndn-cc-report-benchmark --monitors=500 --prefixes=100 --perReport=10 --periods=20"
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "cnmr/prefix-totals.h"
+
+#include <boost/lexical_cast.hpp>
+
+using namespace ns3;
+using namespace std;
+
+using ndn::PrefixTotals;
+
+typedef PrefixTotals::PerNameCounter PerNameCounter;
+
+// All reports in the order the CC receives them
+static vector<pair<uint32_t, PerNameCounter> >
+CreateReports (uint32_t monitors, uint32_t prefixes, uint32_t perReport, uint32_t periods, uint32_t pitSize)
+{
+  SeedManager::SetSeed (1);
+  UniformVariable rnd;
+
+  vector<ndn::Name> names;
+  for (uint32_t prefix = 0; prefix < prefixes; prefix++)
+    names.push_back (ndn::Name ("/prefix" + boost::lexical_cast<string> (prefix)));
+
+  vector<pair<uint32_t, PerNameCounter> > reports;
+  for (uint32_t period = 0; period < periods; period++)
+    {
+      // attack in the middle third of the periods
+      bool attack = period >= periods / 3 && period < 2 * periods / 3;
+
+      for (uint32_t monitor = 0; monitor < monitors; monitor++)
+        {
+          PerNameCounter counts;
+          for (uint32_t i = 0; i < perReport; i++)
+            counts[names[rnd.GetInteger (0, prefixes - 1)]] = rnd.GetInteger (0, 3);
+
+          if (attack && monitor % 4 == 0)
+            counts[names[0]] = rnd.GetInteger (pitSize / 20, pitSize / 10);
+
+          reports.push_back (make_pair (monitor, counts));
+        }
+    }
+  return reports;
+}
+
+int main (int argc, char**argv)
+{
+  uint32_t monitors = 500;
+  uint32_t prefixes = 100;
+  uint32_t perReport = 10;
+  uint32_t periods = 20;
+  uint32_t pitSize = 1000;
+  double gamma = 0.2;
+
+  CommandLine cmd;
+  cmd.AddValue ("monitors", "Number of monitors reporting to the CC", monitors);
+  cmd.AddValue ("prefixes", "Number of distinct prefixes", prefixes);
+  cmd.AddValue ("perReport", "Prefixes per report", perReport);
+  cmd.AddValue ("periods", "Number of observation periods (one report per monitor)", periods);
+  cmd.AddValue ("pitSize", "PIT size (PITSize)", pitSize);
+  cmd.AddValue ("gamma", "Threshold of timed out entries relative to the PIT size (gamma)", gamma);
+  cmd.Parse (argc, argv);
+
+  if (monitors == 0 || prefixes == 0 || pitSize == 0)
+    {
+      cerr << "Monitors, prefixes and PIT size should be positive" << endl;
+      return 1;
+    }
+
+  vector<pair<uint32_t, PerNameCounter> > reports = CreateReports (monitors, prefixes, perReport, periods, pitSize);
+
+  // malicious prefixes after every report that changes them (which is when the CC sends updates)
+  typedef vector<pair<uint32_t, set<ndn::Name> > > Updates;
+  Updates fullUpdates;
+  Updates updates;
+
+  // full recomputation per report
+  SystemWallClockMs clock;
+  clock.Start ();
+  map<uint32_t, PerNameCounter> lastReports;
+  set<ndn::Name> lastMalicious;
+  for (uint32_t r = 0; r < reports.size (); r++)
+    {
+      lastReports[reports[r].first] = reports[r].second;
+
+      map<ndn::Name, uint32_t> totals;
+      for (map<uint32_t, PerNameCounter>::const_iterator report = lastReports.begin (); report != lastReports.end (); ++report)
+        for (PerNameCounter::const_iterator count = report->second.begin (); count != report->second.end (); ++count)
+          totals[count->first] += count->second;
+
+      set<ndn::Name> malicious;
+      for (map<ndn::Name, uint32_t>::const_iterator total = totals.begin (); total != totals.end (); ++total)
+        if ((float)total->second / pitSize >= (float)gamma)
+          malicious.insert (total->first);
+
+      if (malicious != lastMalicious)
+        {
+          fullUpdates.push_back (make_pair (r, malicious));
+          lastMalicious = malicious;
+        }
+    }
+  int64_t fullElapsed = clock.End ();
+
+  // running totals
+  clock.Start ();
+  PrefixTotals totals;
+  totals.setThreshold (pitSize, gamma);
+  for (uint32_t r = 0; r < reports.size (); r++)
+    {
+      if (totals.update (reports[r].first, reports[r].second))
+        updates.push_back (make_pair (r, totals.getPrefixesAbove ()));
+    }
+  int64_t elapsed = clock.End ();
+
+  bool same = updates == fullUpdates;
+
+  cout << "reports " << reports.size () << endl;
+  cout << "full\t" << fullElapsed << " ms\tupdates sent " << fullUpdates.size () << endl;
+  cout << "running\t" << elapsed << " ms\tupdates sent " << updates.size ()
+       << "\t" << (same ? "same" : "DIFFERENT") << " malicious prefixes" << endl;
+
+  return same ? 0 : 1;
+}
@@ -9,6 +9,7 @@
 #include "ns3/gtk-config-store.h"
 #include "ns3/ndnSIM/utils/tracers/ndn-cs-tracer.h"
 #include "ns3/ndnSIM/model/fw/monitor-aware-routing.h"
+#include "ns3/ndnSIM/model/fw/global-routing-info.h"
 #include "ns3/ndnSIM/apps/cnmr-flooding-attacker.h"
 #include "ns3/ndnSIM/apps/cnmr-client.h"
 #include "cnmr/pit-tracer.h"
@@ -89,6 +90,11 @@ static GlobalValue g_pitLifetime("PITLifetime",
         TimeValue (Seconds (2)),
         MakeTimeChecker());
 
+static GlobalValue g_ccRouter("CCRouter",
+        "The router running the CC (defaults to the first monitor router)",
+        ns3::StringValue (""),
+        ns3::MakeStringChecker ());
+
 std::vector<std::basic_string<char> > splitGlobalValue(GlobalValue gv)
 {
     StringValue sv;
@@ -514,9 +520,16 @@ int main (int argc, char *argv[])
     */
     strs = splitGlobalValue(g_monitorRouters);
     NodeContainer monitorRouters;
+    Ptr<Node> ccNode;
     size_t numMonitors = strs.size();
     if(numMonitors > 0 && strs[0] != "") // A simulation could be done without monitors
     {
+        // Look up the CC before the monitors are renamed
+        StringValue ccRouter;
+        g_ccRouter.GetValue(ccRouter);
+        ccNode = Names::Find<Node> (ccRouter.Get() != "" ? ccRouter.Get() : strs[0]);
+        NS_ASSERT_MSG(ccNode != 0, "Unknown CC router " << ccRouter.Get());
+
         std::cout << "Installing MonitorApp on " << numMonitors << " node(s)." << std::endl;
         for (size_t i = 0; i < numMonitors; i++)
         {
@@ -526,13 +539,23 @@ int main (int argc, char *argv[])
             Names::Rename(strs[i], "monitor" + boost::lexical_cast<std::string>(i));
 
             // IF MAR2 - TODO: does this hurt if !MAR2????
-            ndnGlobalRoutingHelper.AddOrigins ("/monitor/" + strs[i], monitor);
+            // Named by node id, which is also the id used by GlobalRoutingInfo
+            ndnGlobalRoutingHelper.AddOrigins ("/monitor/" + boost::lexical_cast<std::string>(monitor->GetId()), monitor);
             // END IF
+
+            // Updates of the CC
+            ndnGlobalRoutingHelper.AddOrigins ("/cc/update/" + boost::lexical_cast<std::string>(monitor->GetId()), monitor);
         }
 
         ndn::AppHelper monitorHelper ("MonitorApp");
         monitorHelper.Install(monitorRouters);
 
+        // Distances from monitors to servers are then filled in by the route calculation (MAR2)
+        for(NodeContainer::const_iterator it = monitorRouters.begin(); it != monitorRouters.end(); ++it)
+        {
+            ndn::fw::GlobalRoutingInfo::addMonitor((*it)->GetId());
+        }
+
         // Add prefix for closest monitor node
         ndnGlobalRoutingHelper.AddOrigins ("/monitor/", monitorRouters);
     }
@@ -553,6 +576,15 @@ int main (int argc, char *argv[])
     ndn::AppHelper routerHelper ("RouterApp");
     routerHelper.Install(normalRouters);
 
+    // The CC receives the reports of the monitors (installed last, the first application of the
+    // routers is used below)
+    if(ccNode != 0)
+    {
+        ndn::AppHelper ccHelper ("CCApp");
+        ccHelper.Install(ccNode);
+        ndnGlobalRoutingHelper.AddOrigins ("/cc/report", ccNode);
+    }
+
     // Fetch observation period
     Time observationPeriod;
     TimeValue vObsPeriod;
@@ -568,7 +600,9 @@ int main (int argc, char *argv[])
     }
     observationPeriod = vObsPeriod.Get();
 
-    // Calculate and install FIBs
+    // Calculate and install FIBs; monitor and CC prefixes are looked up by exact name, keep them if FIBs are compressed
+    ndn::GlobalRoutingHelper::AddExactNamespace("/monitor");
+    ndn::GlobalRoutingHelper::AddExactNamespace("/cc");
     ndnGlobalRoutingHelper.CalculateRoutes();
 
     DoubleValue attackerFreqValue;
@@ -608,13 +642,20 @@ int main (int argc, char *argv[])
     mar->GetAttribute("Detection", vDetection);
     uint32_t detection = vDetection.Get();
 
+    // Fetch the on-path caching decision (betweenness caching needs the centrality of every node)
+    EnumValue vCachingDecision;
+    mar->GetAttribute("CachingDecision", vCachingDecision);
+    uint32_t cachingDecision = vCachingDecision.Get();
+    if(cachingDecision == ndn::ForwardingStrategy::CACHE_BETWEENNESS)
+        ndn::GlobalRoutingHelper::CalculateBetweenness();
+
     if((marMode > 0 || ftbm == true) && monitorRouters.size() <= 0)
     {
         std::cout << "MAR/FTBM is enabled but there are not CNMRs." << std::endl;
         return 1;
     }
 
-    if((monitorRouters.size() > 0 || marMode > 0 || ftbm == true) && detection >= 4)
+    if((monitorRouters.size() > 0 || marMode > 0 || ftbm == true) && (detection == 4 || detection == 5))
     {
         std::cout << "SBA/SBP should not be used with monitor nodes and/or MAR/FTBM enabled." << std::endl;
         return 1;
@@ -642,6 +683,8 @@ int main (int argc, char *argv[])
         << "_cacheSize=" << cacheSize
         << "_pitSize=" << pitSize
         << "_pitLifetime=" << v_pitLifetime.Get().GetSeconds() << "s";
+    if(cachingDecision != ndn::ForwardingStrategy::CACHE_ALWAYS)
+        simulationName << "_caching=" << cachingDecision;
 
     std::ostringstream tracerFiles;
     tracerFiles << outputDir << "/" << simulationName.str() << "_run=" << run << "_seed=" << seed;
@@ -702,7 +745,14 @@ int main (int argc, char *argv[])
 
     std::cout << "Starting run #" << run << " of simulation: " << simulationName.str() << " with seed " << seed << std::endl;
     ndn::CsTracer::InstallAll("rate-trace.txt", Seconds(0.5));
+
+    SystemWallClockMs wallClock;
+    wallClock.Start();
     Simulator::Run ();
+    int64_t elapsedMs = wallClock.End();
+    std::cout << "Run #" << run << " took " << elapsedMs << " ms wall-clock ("
+        << wallClock.GetElapsedUser() << " ms user, " << wallClock.GetElapsedSystem() << " ms system)" << std::endl;
+
     Simulator::Destroy ();
 
     return 0;
@@ -0,0 +1,97 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+// Single-threaded content store lookup throughput on hit and miss paths.
+//
+// "exact" lookups use Interests without Exclude (served from the exact-match index on hit),
+// "trie" lookups carry an empty Exclude filter, which forces the trie walk with the same result.
+//
+// ./waf --run "ndn-cs-lookup-benchmark --objects=100000 --lookups=1000000"
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <boost/lexical_cast.hpp>
+
+using namespace ns3;
+using namespace std;
+
+static string
+ObjectName (uint32_t i, bool hit)
+{
+  // names similar to what consumer apps request: /prefix/<seq>
+  return "/prefix" + boost::lexical_cast<string> (i % 100) + (hit ? "/" : "/missing/") + boost::lexical_cast<string> (i);
+}
+
+static void
+RunLookups (Ptr<ndn::ContentStore> cs, uint32_t objects, uint32_t lookups, bool hit, bool useExclude)
+{
+  vector< Ptr<const ndn::Interest> > interests;
+  for (uint32_t i = 0; i < objects; i++)
+    {
+      Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+      interest->SetName (Create<ndn::Name> (ObjectName (i, hit)));
+      if (useExclude)
+        {
+          interest->SetExclude (Create<ndn::Exclude> ());
+        }
+      interests.push_back (interest);
+    }
+
+  UniformVariable rnd;
+
+  SystemWallClockMs clock;
+  clock.Start ();
+
+  uint32_t hits = 0;
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      if (cs->Lookup (interests[rnd.GetInteger (0, objects - 1)]) != 0)
+        hits ++;
+    }
+
+  int64_t elapsed = clock.End ();
+
+  cout << (hit ? "hit " : "miss") << "\t" << (useExclude ? "trie " : "exact")
+       << "\t" << lookups << " lookups"
+       << "\t" << hits << " hits"
+       << "\t" << elapsed << " ms"
+       << "\t" << (elapsed > 0 ? 1000.0 * lookups / elapsed : 0) << " lookups/s" << endl;
+}
+
+int main (int argc, char**argv)
+{
+  uint32_t objects = 100000;
+  uint32_t lookups = 1000000;
+  string csType = "ns3::ndn::cs::Lru";
+
+  CommandLine cmd;
+  cmd.AddValue ("objects", "Number of cached objects", objects);
+  cmd.AddValue ("lookups", "Number of lookups for each test", lookups);
+  cmd.AddValue ("cs", "Content store type", csType);
+  cmd.Parse (argc, argv);
+
+  if (objects == 0)
+    {
+      cerr << "Number of objects should be positive" << endl;
+      return 1;
+    }
+
+  ObjectFactory factory (csType);
+  factory.Set ("MaxSize", StringValue ("0"));
+  Ptr<ndn::ContentStore> cs = factory.Create<ndn::ContentStore> ();
+
+  for (uint32_t i = 0; i < objects; i++)
+    {
+      Ptr<ndn::Data> data = Create<ndn::Data> (Create<Packet> (1024));
+      data->SetName (Create<ndn::Name> (ObjectName (i, true)));
+      cs->Add (data);
+    }
+
+  RunLookups (cs, objects, lookups, true, false);
+  RunLookups (cs, objects, lookups, true, true);
+  RunLookups (cs, objects, lookups, false, false);
+  RunLookups (cs, objects, lookups, false, true);
+
+  return 0;
+}
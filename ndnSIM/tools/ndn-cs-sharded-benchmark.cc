@@ -0,0 +1,181 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+// Multi-threaded throughput of content store lookups: a single content store behind one global
+// lock vs. ns3::ndn::cs::Sharded::* with per-shard locks.
+//
+// Each thread requests only its own objects (/<thread>/<object>), because NS-3 packets
+// are not thread-safe and the copies returned from the cache share buffers with the cached Data.
+//
+// ./waf --run "ndn-cs-sharded-benchmark --threads=8 --shards=16 --objects=100000 --lookups=1000000"
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <boost/lexical_cast.hpp>
+
+using namespace ns3;
+using namespace std;
+
+class Worker
+{
+public:
+  Worker (Ptr<ndn::ContentStore> cs, SystemMutex *globalLock, uint32_t thread, uint32_t objects, uint32_t lookups)
+    : m_cs (cs)
+    , m_globalLock (globalLock)
+    , m_lookups (lookups)
+    , m_hits (0)
+    , m_seed (thread * 2654435761u + 1)
+  {
+    // all packet and name allocations are done before threads start
+    for (uint32_t i = 0; i < objects; i++)
+      {
+        Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+        if (i % 10 == 9)
+          {
+            // ~10% of misses
+            interest->SetName (Create<ndn::Name> ("/" + boost::lexical_cast<string> (thread) + "/miss/" + boost::lexical_cast<string> (i)));
+          }
+        else
+          {
+            interest->SetName (Create<ndn::Name> ("/" + boost::lexical_cast<string> (thread) + "/" + boost::lexical_cast<string> (i)));
+          }
+        m_interests.push_back (interest);
+      }
+  }
+
+  void
+  Run ()
+  {
+    for (uint32_t i = 0; i < m_lookups; i++)
+      {
+        // xorshift, NS-3 random variables are not thread-safe
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+
+        Ptr<const ndn::Interest> interest = m_interests[m_seed % m_interests.size ()];
+
+        Ptr<ndn::Data> data;
+        if (m_globalLock != 0)
+          {
+            CriticalSection lock (*m_globalLock);
+            data = m_cs->Lookup (interest);
+          }
+        else
+          {
+            data = m_cs->Lookup (interest);
+          }
+
+        if (data != 0)
+          m_hits ++;
+      }
+  }
+
+  uint32_t
+  GetHits () const
+  {
+    return m_hits;
+  }
+
+private:
+  Ptr<ndn::ContentStore> m_cs;
+  SystemMutex *m_globalLock;
+  uint32_t m_lookups;
+  uint32_t m_hits;
+  uint32_t m_seed;
+
+  vector< Ptr<const ndn::Interest> > m_interests;
+};
+
+static void
+RunBenchmark (const string &csType, bool useGlobalLock, uint32_t nThreads, uint32_t shards, uint32_t objects, uint32_t lookups)
+{
+  ObjectFactory factory (csType);
+  factory.Set ("MaxSize", StringValue ("0"));
+  if (!useGlobalLock)
+    {
+      factory.Set ("Shards", UintegerValue (shards));
+      factory.Set ("ShardingDepth", UintegerValue (2));
+    }
+  Ptr<ndn::ContentStore> cs = factory.Create<ndn::ContentStore> ();
+
+  uint32_t perThread = objects / nThreads;
+  for (uint32_t thread = 0; thread < nThreads; thread++)
+    {
+      for (uint32_t i = 0; i < perThread; i++)
+        {
+          Ptr<ndn::Data> data = Create<ndn::Data> (Create<Packet> (1024));
+          data->SetName (Create<ndn::Name> ("/" + boost::lexical_cast<string> (thread) + "/" + boost::lexical_cast<string> (i)));
+          cs->Add (data);
+        }
+    }
+
+  SystemMutex globalLock;
+  vector<Worker*> workers;
+  vector< Ptr<SystemThread> > threads;
+  for (uint32_t thread = 0; thread < nThreads; thread++)
+    {
+      Worker *worker = new Worker (cs, useGlobalLock ? &globalLock : 0, thread, perThread, lookups / nThreads);
+      workers.push_back (worker);
+      threads.push_back (Create<SystemThread> (MakeCallback (&Worker::Run, worker)));
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t thread = 0; thread < nThreads; thread++)
+    {
+      threads[thread]->Start ();
+    }
+  for (uint32_t thread = 0; thread < nThreads; thread++)
+    {
+      threads[thread]->Join ();
+    }
+  int64_t elapsed = clock.End ();
+
+  uint32_t hits = 0;
+  for (uint32_t thread = 0; thread < nThreads; thread++)
+    {
+      hits += workers[thread]->GetHits ();
+      delete workers[thread];
+    }
+
+  uint32_t done = (lookups / nThreads) * nThreads;
+  cout << csType << (useGlobalLock ? " (global lock)" : "")
+       << "\t" << nThreads << " threads"
+       << "\t" << cs->GetSize () << " entries"
+       << "\t" << done << " lookups"
+       << "\t" << hits << " hits"
+       << "\t" << elapsed << " ms"
+       << "\t" << (elapsed > 0 ? 1000.0 * done / elapsed : 0) << " lookups/s" << endl;
+}
+
+int main (int argc, char**argv)
+{
+  uint32_t nThreads = 4;
+  uint32_t shards = 16;
+  uint32_t objects = 100000;
+  uint32_t lookups = 1000000;
+  string policy = "Lru";
+
+  CommandLine cmd;
+  cmd.AddValue ("threads", "Number of threads doing lookups", nThreads);
+  cmd.AddValue ("shards", "Number of content store shards", shards);
+  cmd.AddValue ("objects", "Number of cached objects", objects);
+  cmd.AddValue ("lookups", "Total number of lookups (split between threads)", lookups);
+  cmd.AddValue ("policy", "Cache replacement policy (Lru, Fifo, Random, Lfu)", policy);
+  cmd.Parse (argc, argv);
+
+  if (nThreads == 0 || objects < nThreads)
+    {
+      cerr << "Number of threads should be positive and not exceed number of objects" << endl;
+      return 1;
+    }
+
+  RunBenchmark ("ns3::ndn::cs::" + policy, true, nThreads, shards, objects, lookups);
+  RunBenchmark ("ns3::ndn::cs::Sharded::" + policy, false, nThreads, shards, objects, lookups);
+
+  return 0;
+}
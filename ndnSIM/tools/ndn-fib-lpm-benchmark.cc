@@ -0,0 +1,142 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+// FIB longest prefix match throughput for the trie-based (ns3::ndn::fib::Default) and the
+// hash-based (ns3::ndn::fib::Hash) FIB, the latter with and without per-length Bloom filters.
+//
+// FIB is filled with synthetic prefixes of 1 to 5 components.  "hit" Interests extend a random
+// FIB prefix with two more components, "miss" Interests share only the first component with
+// FIB prefixes (the default route is not installed).
+//
+// ./waf --run "ndn-fib-lpm-benchmark --prefixes=10000 --lookups=1000000"
+// ./waf --run "ndn-fib-lpm-benchmark --prefixes=1000000 --lookups=1000000"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <boost/lexical_cast.hpp>
+
+using namespace ns3;
+using namespace std;
+
+static string
+PrefixName (uint32_t i)
+{
+  uint32_t length = 1 + i % 5;
+
+  string name = "/org" + boost::lexical_cast<string> (i % 997);
+  for (uint32_t comp = 2; comp < length; comp++)
+    {
+      name += "/level" + boost::lexical_cast<string> (comp);
+    }
+  if (length > 1)
+    {
+      name += "/p" + boost::lexical_cast<string> (i);
+    }
+  return name;
+}
+
+static string
+InterestName (uint32_t i, bool hit)
+{
+  if (hit)
+    return PrefixName (i) + "/object/" + boost::lexical_cast<string> (i);
+  else
+    return "/org" + boost::lexical_cast<string> (1000 + i % 997) + "/level2/level3/level4/missing/" + boost::lexical_cast<string> (i);
+}
+
+static void
+Run (const string &title, const string &fibType, const string &useBloomFilter, uint32_t prefixes, uint32_t lookups)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+
+  ndn::StackHelper ndnHelper;
+  if (fibType == "ns3::ndn::fib::Hash")
+    ndnHelper.SetFib (fibType, "UseBloomFilter", useBloomFilter);
+  else
+    ndnHelper.SetFib (fibType);
+  ndnHelper.Install (node);
+
+  Ptr<ndn::Fib> fib = node->GetObject<ndn::Fib> ();
+  Ptr<ndn::Face> face = CreateObject<ndn::Face> (node);
+
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  for (uint32_t i = 0; i < prefixes; i++)
+    {
+      fib->Add (ndn::Name (PrefixName (i)), face, 1);
+    }
+  int64_t addElapsed = clock.End ();
+
+  uint32_t nInterests = std::min<uint32_t> (prefixes, 100000);
+  vector< Ptr<const ndn::Interest> > hitInterests;
+  vector< Ptr<const ndn::Interest> > missInterests;
+  UniformVariable rnd;
+  for (uint32_t i = 0; i < nInterests; i++)
+    {
+      Ptr<ndn::Interest> interest = Create<ndn::Interest> ();
+      interest->SetName (Create<ndn::Name> (InterestName (rnd.GetInteger (0, prefixes - 1), true)));
+      hitInterests.push_back (interest);
+
+      interest = Create<ndn::Interest> ();
+      interest->SetName (Create<ndn::Name> (InterestName (i, false)));
+      missInterests.push_back (interest);
+    }
+
+  vector<uint32_t> order (lookups);
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      order[i] = rnd.GetInteger (0, nInterests - 1);
+    }
+
+  clock.Start ();
+  uint32_t hits = 0;
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      if (fib->LongestPrefixMatch (*hitInterests[order[i]]) != 0)
+        hits ++;
+    }
+  int64_t hitElapsed = clock.End ();
+
+  clock.Start ();
+  uint32_t misses = 0;
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      if (fib->LongestPrefixMatch (*missInterests[order[i]]) == 0)
+        misses ++;
+    }
+  int64_t missElapsed = clock.End ();
+
+  cout << title << "\t" << fib->GetSize () << " prefixes"
+       << "\tadd " << addElapsed << " ms"
+       << "\thit " << hitElapsed << " ms (" << (hitElapsed > 0 ? 1000.0 * lookups / hitElapsed : 0) << " lookups/s, " << hits << " found)"
+       << "\tmiss " << missElapsed << " ms (" << (missElapsed > 0 ? 1000.0 * lookups / missElapsed : 0) << " lookups/s, " << misses << " not found)"
+       << endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char**argv)
+{
+  uint32_t prefixes = 100000;
+  uint32_t lookups = 1000000;
+
+  CommandLine cmd;
+  cmd.AddValue ("prefixes", "Number of FIB prefixes", prefixes);
+  cmd.AddValue ("lookups", "Number of lookups for each test", lookups);
+  cmd.Parse (argc, argv);
+
+  if (prefixes == 0)
+    {
+      cerr << "Number of prefixes should be positive" << endl;
+      return 1;
+    }
+
+  Run ("trie", "ns3::ndn::fib::Default", "", prefixes, lookups);
+  Run ("hash+bloom", "ns3::ndn::fib::Hash", "true", prefixes, lookups);
+  Run ("hash", "ns3::ndn::fib::Hash", "false", prefixes, lookups);
+
+  return 0;
+}
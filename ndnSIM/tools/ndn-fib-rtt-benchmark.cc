@@ -0,0 +1,154 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+// Throughput of FIB next hop updates for the two next hop containers of fib::Entry.
+//
+// "multi-index" is boost::multi_index container (FaceMetricMultiIndex, default), "array" is the
+// compact sorted array (FaceMetricArray, ./waf configure --enable-fib-face-metric-array).  Both
+// are updated exactly the way fib::Entry does it:
+//  - "rtt" is UpdateFaceRtt (find by face, update SRTT/RTTVAR in place),
+//  - "status" is UpdateStatus with a random status (nth index is reordered lazily by fib::Entry, not here),
+//  - "best" is BestRoute-like scan of next hops in metric order until the first non-RED one.
+//
+// ./waf --run "ndn-fib-rtt-benchmark --entries=10000 --updates=10000000 --maxFaces=16"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndn-fib-entry.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <boost/lambda/lambda.hpp>
+#include <boost/lambda/bind.hpp>
+namespace ll = boost::lambda;
+
+using namespace ns3;
+using namespace std;
+
+using ndn::fib::FaceMetric;
+using ndn::fib::i_face;
+using ndn::fib::i_metric;
+using ndn::fib::i_nth;
+
+template<class Container>
+static void
+UpdateFaceRtt (Container &faces, Ptr<ndn::Face> face, const Time &sample)
+{
+  typename Container::template index<i_face>::type::iterator record = faces.template get<i_face> ().find (face);
+  if (record == faces.template get<i_face> ().end ())
+    return;
+
+  record->UpdateRtt (sample);
+}
+
+template<class Container>
+static void
+UpdateStatus (Container &faces, Ptr<ndn::Face> face, FaceMetric::Status status)
+{
+  typename Container::template index<i_face>::type::iterator record = faces.template get<i_face> ().find (face);
+  if (record == faces.template get<i_face> ().end () || record->GetStatus () == status)
+    return;
+
+  faces.modify (record, ll::bind (&FaceMetric::SetStatus, ll::_1, status));
+}
+
+template<class Container>
+static uint32_t
+FindBest (const Container &faces)
+{
+  typedef typename Container::template index<i_metric>::type::const_iterator iterator;
+  for (iterator metric = faces.template get<i_metric> ().begin (); metric != faces.template get<i_metric> ().end (); metric++)
+    {
+      if (metric->GetStatus () != FaceMetric::NDN_FIB_RED)
+        return metric->GetFace ()->GetId ();
+    }
+  return 0;
+}
+
+template<class Container>
+static void
+Run (const string &name, const vector< Ptr<ndn::Face> > &faces, uint32_t nFaces, uint32_t nEntries, uint32_t updates)
+{
+  vector<Container> entries (nEntries);
+  for (uint32_t entry = 0; entry < nEntries; entry++)
+    {
+      for (uint32_t face = 0; face < nFaces; face++)
+        {
+          entries[entry].insert (FaceMetric (faces[face], face + 1));
+        }
+      entries[entry].template get<i_nth> ().rearrange (entries[entry].template get<i_metric> ().begin ());
+    }
+
+  UniformVariable rnd;
+  vector<uint32_t> entryIds (updates);
+  vector<uint32_t> faceIds (updates);
+  for (uint32_t i = 0; i < updates; i++)
+    {
+      entryIds[i] = rnd.GetInteger (0, nEntries - 1);
+      faceIds[i] = rnd.GetInteger (0, nFaces - 1);
+    }
+
+  SystemWallClockMs clock;
+
+  clock.Start ();
+  for (uint32_t i = 0; i < updates; i++)
+    {
+      UpdateFaceRtt (entries[entryIds[i]], faces[faceIds[i]], MilliSeconds (10 + faceIds[i] + (i & 7)));
+    }
+  int64_t rttElapsed = clock.End ();
+
+  clock.Start ();
+  for (uint32_t i = 0; i < updates; i++)
+    {
+      UpdateStatus (entries[entryIds[i]], faces[faceIds[i]], static_cast<FaceMetric::Status> (1 + (i % 3)));
+    }
+  int64_t statusElapsed = clock.End ();
+
+  clock.Start ();
+  uint64_t checksum = 0;
+  for (uint32_t i = 0; i < updates; i++)
+    {
+      checksum += FindBest (entries[entryIds[i]]);
+    }
+  int64_t bestElapsed = clock.End ();
+
+  cout << name << "\t" << nFaces << " faces"
+       << "\trtt " << rttElapsed << " ms (" << (rttElapsed > 0 ? 1000.0 * updates / rttElapsed : 0) << " updates/s)"
+       << "\tstatus " << statusElapsed << " ms (" << (statusElapsed > 0 ? 1000.0 * updates / statusElapsed : 0) << " updates/s)"
+       << "\tbest " << bestElapsed << " ms (" << (bestElapsed > 0 ? 1000.0 * updates / bestElapsed : 0) << " lookups/s)"
+       << "\tchecksum " << checksum << endl;
+}
+
+int main (int argc, char**argv)
+{
+  uint32_t nEntries = 10000;
+  uint32_t updates = 10000000;
+  uint32_t maxFaces = 16;
+
+  CommandLine cmd;
+  cmd.AddValue ("entries", "Number of FIB entries", nEntries);
+  cmd.AddValue ("updates", "Number of updates for each test", updates);
+  cmd.AddValue ("maxFaces", "Maximum number of next hops per FIB entry (tested 1, 2, 4, ... maxFaces)", maxFaces);
+  cmd.Parse (argc, argv);
+
+  if (nEntries == 0 || maxFaces == 0)
+    {
+      cerr << "Number of entries and faces should be positive" << endl;
+      return 1;
+    }
+
+  Ptr<Node> node = CreateObject<Node> ();
+  vector< Ptr<ndn::Face> > faces;
+  for (uint32_t face = 0; face < maxFaces; face++)
+    {
+      faces.push_back (CreateObject<ndn::Face> (node));
+      faces.back ()->SetId (face);
+    }
+
+  for (uint32_t nFaces = 1; nFaces <= maxFaces; nFaces *= 2)
+    {
+      Run<ndn::fib::FaceMetricMultiIndex::type> ("multi-index", faces, nFaces, nEntries, updates);
+      Run<ndn::fib::FaceMetricArray> ("array", faces, nFaces, nEntries, updates);
+    }
+
+  return 0;
+}
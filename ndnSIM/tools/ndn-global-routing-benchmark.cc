@@ -0,0 +1,178 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+// All-pairs route calculation time on a Rocketfuel topology.
+//
+// "boost" runs dijkstra_shortest_paths over NdnGlobalRouterGraph with std::map distances for every source
+// (the algorithm previously used by GlobalRoutingHelper::CalculateRoutes), "csr" runs Dijkstra over
+// the flattened GlobalRoutingGraph, and "install" is the complete CalculateRoutes including FIB updates.
+// Afterwards, CalculateRoutes (and optionally CalculateAllPossibleRoutes) is timed with 1 to maxThreads threads.
+// With --compress, FIBs calculated by CalculateRoutes are compressed by CompressFibs (with verification)
+// and the total number of FIB entries before and after is reported.
+//
+// ./waf --run "ndn-global-routing-benchmark --topology=topologies/AS_3257.gtna.txt --maxThreads=8"
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include "ns3/ndnSIM/helper/ndn-global-routing-graph.h"
+#include "ns3/ndnSIM/helper/boost-graph-ndn-global-routing-helper.h"
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+
+using namespace ns3;
+using namespace std;
+
+static uint64_t
+RunBoost ()
+{
+  boost::NdnGlobalRouterGraph graph;
+
+  uint64_t reachable = 0;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      Ptr<ndn::GlobalRouter> source = (*node)->GetObject<ndn::GlobalRouter> ();
+      if (source == 0)
+        continue;
+
+      boost::DistancesMap distances;
+      boost::dijkstra_shortest_paths (graph, source,
+                                      boost::distance_map (boost::ref (distances))
+                                      .distance_inf (boost::WeightInf)
+                                      .distance_zero (boost::WeightZero)
+                                      .distance_compare (boost::WeightCompare ())
+                                      .distance_combine (boost::WeightCombine ()));
+
+      for (boost::DistancesMap::iterator i = distances.begin (); i != distances.end (); i++)
+        {
+          if (i->first != source && i->second.get<0> () != 0)
+            reachable ++;
+        }
+    }
+  return reachable;
+}
+
+static uint64_t
+RunCsr ()
+{
+  ndn::GlobalRoutingGraph graph;
+  ndn::GlobalRoutingShortestPaths paths;
+
+  uint64_t reachable = 0;
+  for (uint32_t source = 0; source < graph.GetNNodes (); source++)
+    {
+      paths.Calculate (graph, source);
+      for (uint32_t vertex = 0; vertex < graph.GetNVertices (); vertex++)
+        {
+          if (paths.IsReachable (vertex))
+            reachable ++;
+        }
+    }
+  return reachable;
+}
+
+int main (int argc, char**argv)
+{
+  string topology = "topologies/AS_3257.gtna.txt";
+  uint32_t runs = 3;
+  uint32_t maxThreads = 1;
+  bool allPossible = false;
+  bool compress = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("topology", "Annotated topology file", topology);
+  cmd.AddValue ("runs", "Number of repetitions of each calculation", runs);
+  cmd.AddValue ("maxThreads", "Maximum number of threads for the scaling test", maxThreads);
+  cmd.AddValue ("allPossible", "Also time CalculateAllPossibleRoutes in the scaling test", allPossible);
+  cmd.AddValue ("compress", "Compress and verify FIBs after the scaling test", compress);
+  cmd.Parse (argc, argv);
+  runs = std::max<uint32_t> (runs, 1);
+
+  AnnotatedTopologyReader topologyReader ("", 25);
+  topologyReader.SetFileName (topology);
+  topologyReader.Read ();
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll ();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll ();
+  ndnGlobalRoutingHelper.AddOriginsForAll ();
+
+  cout << "topology\t" << topology << "\t" << NodeList::GetNNodes () << " nodes" << endl;
+
+  for (uint32_t run = 0; run < runs; run++)
+    {
+      SystemWallClockMs clock;
+
+      clock.Start ();
+      uint64_t boostReachable = RunBoost ();
+      int64_t boostElapsed = clock.End ();
+
+      clock.Start ();
+      uint64_t csrReachable = RunCsr ();
+      int64_t csrElapsed = clock.End ();
+
+      clock.Start ();
+      ndn::GlobalRoutingHelper::CalculateRoutes ();
+      int64_t installElapsed = clock.End ();
+
+      cout << "run " << run
+           << "\tboost " << boostElapsed << " ms (" << boostReachable << " pairs)"
+           << "\tcsr " << csrElapsed << " ms (" << csrReachable << " pairs)"
+           << "\tinstall " << installElapsed << " ms" << endl;
+    }
+
+  for (uint32_t threads = 1; threads <= maxThreads; threads++)
+    {
+      ndn::GlobalRoutingHelper::SetThreads (threads);
+
+      SystemWallClockMs clock;
+      clock.Start ();
+      for (uint32_t run = 0; run < runs; run++)
+        {
+          ndn::GlobalRoutingHelper::CalculateRoutes ();
+        }
+      int64_t routesElapsed = clock.End () / runs;
+
+      cout << "threads " << threads << "\troutes " << routesElapsed << " ms";
+
+      if (allPossible)
+        {
+          clock.Start ();
+          ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes ();
+          cout << "\tall-possible " << clock.End () << " ms";
+        }
+      cout << endl;
+    }
+
+  if (compress)
+    {
+      ndn::GlobalRoutingHelper::CalculateRoutes ();
+
+      uint64_t before = 0;
+      for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+        {
+          before += (*node)->GetObject<ndn::Fib> ()->GetSize ();
+        }
+
+      SystemWallClockMs clock;
+      clock.Start ();
+      ndn::GlobalRoutingHelper::CompressFibs (true);
+      int64_t compressElapsed = clock.End ();
+
+      uint64_t after = 0;
+      for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+        {
+          after += (*node)->GetObject<ndn::Fib> ()->GetSize ();
+        }
+
+      cout << "compress\t" << compressElapsed << " ms (with verification)"
+           << "\t" << before << " FIB entries before\t" << after << " after" << endl;
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
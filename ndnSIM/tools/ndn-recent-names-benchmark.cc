@@ -0,0 +1,116 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+// Detection accuracy and memory of the content name tracking of MonitorAwareRouting (detection
+// schemes 2 and 3) with exact sets and with rotating Bloom filters (ns3::ndn::fw::RecentNames).
+//
+// Every observation period clients request names from a fixed pool (--pool), which are satisfied,
+// and an attacker requests new names (--attack) that are never satisfied.  The names are tracked
+// the way MonitorAwareRouting does it: "satisfied" starts a new generation every 5 periods,
+// "requested" is cleared every period.  An attack Interest whose name is reported as satisfied or
+// requested before escapes detection; with exact sets none does.
+//
+// ./waf --run "ndn-recent-names-benchmark --periods=50 --pool=20000 --clients=20000 --attack=100000"
+// ./waf --run "ndn-recent-names-benchmark --capacity=100000 --fpRate=0.0001"
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/ndnSIM/model/fw/recent-names.h"
+
+#include <boost/lexical_cast.hpp>
+
+using namespace ns3;
+using namespace std;
+
+using ndn::fw::RecentNames;
+
+static void
+Run (const string &title, bool exact, uint32_t periods, uint32_t pool, uint32_t clients, uint32_t attack,
+     uint32_t capacity, double fpRate)
+{
+  RecentNames satisfiedNames;
+  RecentNames requestedNames;
+  satisfiedNames.configure (5 * capacity, fpRate);
+  satisfiedNames.setExact (exact);
+  requestedNames.configure (capacity, fpRate);
+  requestedNames.setExact (exact);
+
+  SeedManager::SetSeed (1);
+  UniformVariable rnd;
+
+  uint64_t clientSeen = 0;
+  uint64_t attackEscaped = 0;
+  size_t maxMemory = 0;
+  uint32_t attackName = 0;
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t period = 0; period < periods; period++)
+    {
+      for (uint32_t i = 0; i < clients + attack; i++)
+        {
+          // interleave client and attack Interests
+          bool isAttack = rnd.GetInteger (0, clients + attack - 1) < attack;
+          ndn::Name name = isAttack ?
+            ndn::Name ("/evil/" + boost::lexical_cast<string> (attackName++)) :
+            ndn::Name ("/good/" + boost::lexical_cast<string> (rnd.GetInteger (0, pool - 1)));
+
+          bool seen = satisfiedNames.contains (name) || requestedNames.contains (name);
+          if (isAttack && seen)
+            attackEscaped ++;
+          if (!isAttack && seen)
+            clientSeen ++;
+
+          requestedNames.insert (name);
+          if (!isAttack)
+            satisfiedNames.insert (name);
+        }
+
+      maxMemory = std::max (maxMemory, satisfiedNames.getMemoryUsage () + requestedNames.getMemoryUsage ());
+
+      // resetStats
+      if (period % 5 == 4)
+        satisfiedNames.rotate ();
+      requestedNames.clear ();
+    }
+  int64_t elapsed = clock.End ();
+
+  uint64_t attackTotal = (uint64_t)attack * periods;
+  uint64_t clientTotal = (uint64_t)clients * periods;
+  cout << title
+       << "\tattack escaped " << attackEscaped << " (" << (attackTotal > 0 ? 100.0 * attackEscaped / attackTotal : 0) << "%)"
+       << "\tclient seen before " << clientSeen << " (" << (clientTotal > 0 ? 100.0 * clientSeen / clientTotal : 0) << "%)"
+       << "\tmax memory " << maxMemory / 1024 << " KiB"
+       << "\t" << elapsed << " ms"
+       << endl;
+}
+
+int main (int argc, char**argv)
+{
+  uint32_t periods = 50;
+  uint32_t pool = 20000;
+  uint32_t clients = 20000;
+  uint32_t attack = 100000;
+  uint32_t capacity = 10000;
+  double fpRate = 0.001;
+
+  CommandLine cmd;
+  cmd.AddValue ("periods", "Number of observation periods", periods);
+  cmd.AddValue ("pool", "Number of distinct client names", pool);
+  cmd.AddValue ("clients", "Client Interests per period", clients);
+  cmd.AddValue ("attack", "Attack Interests (new names) per period", attack);
+  cmd.AddValue ("capacity", "Bloom filter capacity (NameFilterCapacity)", capacity);
+  cmd.AddValue ("fpRate", "Bloom filter false positive rate (NameFilterFalsePositiveRate)", fpRate);
+  cmd.Parse (argc, argv);
+
+  if (pool == 0 || capacity == 0 || fpRate <= 0 || fpRate >= 1)
+    {
+      cerr << "Pool and capacity should be positive, false positive rate should be in (0, 1)" << endl;
+      return 1;
+    }
+
+  Run ("exact", true, periods, pool, clients, attack, capacity, fpRate);
+  Run ("bloom", false, periods, pool, clients, attack, capacity, fpRate);
+
+  return 0;
+}
@@ -0,0 +1,226 @@
+#include "cc-message.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+const uint32_t CCMessageEncoder::MAX_PREFIXES;
+const uint32_t CCMessageDecoder::MAX_PREFIXES;
+
+static void writeVarint(std::string &message, uint32_t value)
+{
+    while(value >= 0x80)
+    {
+        message.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    message.push_back(static_cast<char>(value));
+}
+
+static bool readVarint(const std::string &message, size_t &pos, uint32_t &value)
+{
+    value = 0;
+    for(uint32_t shift = 0; shift < 35; shift += 7)
+    {
+        if(pos >= message.size())
+            return false;
+
+        uint8_t byte = static_cast<uint8_t>(message[pos++]);
+        if(shift == 28 && (byte & 0x70) != 0)
+            // More than 32 bits
+            return false;
+
+        value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+CCMessageEncoder::CCMessageEncoder(uint32_t maxPrefixes)
+    : maxPrefixes(std::max<uint32_t>(1, std::min(maxPrefixes, MAX_PREFIXES)))
+{
+}
+
+std::string CCMessageEncoder::encode(uint32_t seq, const PerNameCounter &counts)
+{
+    std::string message;
+    writeVarint(message, counts.size());
+    for(PerNameCounter::const_iterator count = counts.begin(); count != counts.end(); ++count)
+    {
+        encodePrefix(message, seq, count->first);
+        writeVarint(message, count->second);
+    }
+    return message;
+}
+
+std::string CCMessageEncoder::encode(uint32_t seq, const std::set<Name> &prefixes)
+{
+    std::string message;
+    writeVarint(message, prefixes.size());
+    for(std::set<Name>::const_iterator prefix = prefixes.begin(); prefix != prefixes.end(); ++prefix)
+    {
+        encodePrefix(message, seq, *prefix);
+    }
+    return message;
+}
+
+void CCMessageEncoder::acknowledge(uint32_t seq)
+{
+    std::map<uint32_t, std::vector<uint32_t> >::iterator acknowledged = pending.find(seq);
+    if(acknowledged != pending.end())
+    {
+        for(uint32_t i = 0; i < acknowledged->second.size(); i++)
+        {
+            // The id may have been recycled since
+            Slot &slot = slots[acknowledged->second[i]];
+            if(slot.assigned <= seq)
+                slot.known = true;
+        }
+    }
+
+    pending.erase(pending.begin(), pending.upper_bound(seq));
+}
+
+void CCMessageEncoder::encodePrefix(std::string &message, uint32_t seq, const Name &prefix)
+{
+    boost::unordered_map<Name, uint32_t>::iterator id = ids.find(prefix);
+    if(id == ids.end())
+    {
+        uint32_t newId;
+        if(slots.size() < maxPrefixes)
+        {
+            newId = slots.size();
+            slots.push_back(Slot());
+            slots[newId].use = uses.insert(uses.end(), newId);
+        }
+        else
+        {
+            // Recycle the least recently used id
+            newId = uses.front();
+            ids.erase(slots[newId].prefix);
+        }
+
+        Slot &slot = slots[newId];
+        slot.prefix = prefix;
+        slot.assigned = seq;
+        slot.known = false;
+        id = ids.insert(std::make_pair(prefix, newId)).first;
+    }
+
+    Slot &slot = slots[id->second];
+    uses.splice(uses.end(), uses, slot.use);
+
+    if(slot.known)
+    {
+        writeVarint(message, id->second << 1);
+        return;
+    }
+
+    writeVarint(message, (id->second << 1) | 1);
+    writeVarint(message, prefix.size());
+    for(Name::const_iterator component = prefix.begin(); component != prefix.end(); ++component)
+    {
+        writeVarint(message, component->size());
+        message.append(component->begin(), component->end());
+    }
+
+    pending[seq].push_back(id->second);
+}
+
+bool CCMessageDecoder::decode(uint32_t seq, const std::string &message, PerNameCounter &counts)
+{
+    return decodeEntries(seq, message, true, counts);
+}
+
+bool CCMessageDecoder::decode(uint32_t seq, const std::string &message, std::set<Name> &prefixes)
+{
+    PerNameCounter entries;
+    if(!decodeEntries(seq, message, false, entries))
+        return false;
+
+    for(PerNameCounter::const_iterator entry = entries.begin(); entry != entries.end(); ++entry)
+    {
+        prefixes.insert(entry->first);
+    }
+    return true;
+}
+
+bool CCMessageDecoder::decodeEntries(uint32_t seq, const std::string &message, bool withCounts, PerNameCounter &counts)
+{
+    size_t pos = 0;
+    uint32_t nEntries;
+    if(!readVarint(message, pos, nEntries))
+        return false;
+
+    for(uint32_t entry = 0; entry < nEntries; entry++)
+    {
+        uint32_t key;
+        if(!readVarint(message, pos, key))
+            return false;
+
+        uint32_t id = key >> 1;
+        if(id >= MAX_PREFIXES)
+            return false;
+
+        Name prefix;
+        if(key & 1)
+        {
+            uint32_t nComponents;
+            if(!readVarint(message, pos, nComponents))
+                return false;
+
+            for(uint32_t i = 0; i < nComponents; i++)
+            {
+                uint32_t length;
+                if(!readVarint(message, pos, length) || length > message.size() - pos)
+                    return false;
+
+                prefix.append(name::Component(message.begin() + pos, message.begin() + pos + length));
+                pos += length;
+            }
+
+            define(seq, id, prefix);
+        }
+        else if(id < definitions.size() && definitions[id].defined && seq >= definitions[id].seq)
+        {
+            prefix = definitions[id].prefix;
+        }
+        else
+        {
+            // Unknown, or the message is older than the definition (the id may have had another prefix)
+            return false;
+        }
+
+        uint32_t count = 0;
+        if(withCounts && !readVarint(message, pos, count))
+            return false;
+
+        counts[prefix] = count;
+    }
+
+    return pos == message.size();
+}
+
+void CCMessageDecoder::define(uint32_t seq, uint32_t id, const Name &prefix)
+{
+    if(id >= definitions.size())
+        definitions.resize(id + 1);
+
+    // The sender refers to an id by itself only after a message with its definition has been
+    // acknowledged, so after all messages with that definition. Messages older than the first
+    // definition received therefore never refer to it, but may refer to a recycled prefix.
+    Definition &definition = definitions[id];
+    if(!definition.defined || (definition.prefix != prefix && seq >= definition.seq))
+    {
+        // New or recycled id
+        definition.prefix = prefix;
+        definition.defined = true;
+        definition.seq = seq;
+    }
+    // Otherwise the id has been recycled by the sender since, the definition is only used for this entry
+}
+
+} // namespace ndn
+} // namespace ns3
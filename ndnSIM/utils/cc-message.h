@@ -0,0 +1,114 @@
+#ifndef CC_MESSAGE_H_
+#define CC_MESSAGE_H_
+
+#include "ns3/ndnSIM/ndn.cxx/name.h"
+
+#include <boost/unordered_map.hpp>
+#include <list>
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * Compact binary encoding of the control messages between monitors and the CC (reports of timed
+ * out entries per prefix, malicious prefixes), carried in one name component of an Interest.
+ *
+ * A message is the number of entries followed by the entries. An entry starts with
+ * (prefix id << 1 | definition). A definition is followed by the prefix (number of components,
+ * then length and bytes of every component). In reports every entry ends with its count. All
+ * numbers are varints (7 bits per byte, least significant first).
+ *
+ * Prefix ids are assigned by the sender per peer. A prefix is defined in place until a message
+ * with the definition has been acknowledged (the Data answering its Interest arrived), later
+ * messages only carry its id. Messages can be lost or arrive out of order, but the receiver never
+ * gets an id before its definition.
+ *
+ * There are at most MAX_PREFIXES ids. Once all are in use, a new prefix takes over the least
+ * recently used id and is defined in place like any new prefix. The receiver tells the meanings
+ * of a recycled id apart by the seq of the messages: an id only refers to the latest definition
+ * the receiver got, and only in messages that are not older than that definition.
+ */
+class CCMessageEncoder
+{
+public:
+    typedef std::map<Name, uint32_t> PerNameCounter;
+
+    static const uint32_t MAX_PREFIXES = 1 << 16;
+
+    // Ids are recycled once maxPrefixes (at most MAX_PREFIXES) ids are in use
+    CCMessageEncoder(uint32_t maxPrefixes = MAX_PREFIXES);
+
+    // seq identifies the message for acknowledge (e.g., its sequence number in the Interest name).
+    // It must not decrease, and messages with the same seq must not have more than maxPrefixes
+    // prefixes in total.
+    std::string encode(uint32_t seq, const PerNameCounter &counts);
+    std::string encode(uint32_t seq, const std::set<Name> &prefixes);
+
+    // The message has been received. Definitions of older messages that have not been
+    // acknowledged are given up (those prefixes are defined again in the next messages).
+    void acknowledge(uint32_t seq);
+
+private:
+    void encodePrefix(std::string &message, uint32_t seq, const Name &prefix);
+
+    struct Slot
+    {
+        Name prefix;
+        // Seq of the first message with the current prefix of the id
+        uint32_t assigned;
+        // Whether the definition has been acknowledged
+        bool known;
+        std::list<uint32_t>::iterator use;
+    };
+
+    uint32_t maxPrefixes;
+    boost::unordered_map<Name, uint32_t> ids;
+    std::vector<Slot> slots;
+    // Ids from the least to the most recently used
+    std::list<uint32_t> uses;
+    // Ids defined per message that has not been acknowledged
+    std::map<uint32_t, std::vector<uint32_t> > pending;
+
+};
+
+class CCMessageDecoder
+{
+public:
+    typedef std::map<Name, uint32_t> PerNameCounter;
+
+    // Larger prefix ids are rejected as malformed
+    static const uint32_t MAX_PREFIXES = CCMessageEncoder::MAX_PREFIXES;
+
+    // seq is the one the message has been encoded with. Return false if the message is malformed
+    // or refers to an id that is unknown (or has been recycled since the message was sent).
+    bool decode(uint32_t seq, const std::string &message, PerNameCounter &counts);
+    bool decode(uint32_t seq, const std::string &message, std::set<Name> &prefixes);
+
+private:
+    bool decodeEntries(uint32_t seq, const std::string &message, bool withCounts, PerNameCounter &counts);
+    void define(uint32_t seq, uint32_t id, const Name &prefix);
+
+    struct Definition
+    {
+        Definition() : defined(false), seq(0) {}
+
+        Name prefix;
+        bool defined;
+        // First received message with the definition
+        uint32_t seq;
+    };
+
+    // Prefixes by id as defined by the sender
+    std::vector<Definition> definitions;
+
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
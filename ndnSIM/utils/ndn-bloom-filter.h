@@ -0,0 +1,158 @@
+/* -*- Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil -*- */
+
+#ifndef _NDN_BLOOM_FILTER_H_
+#define _NDN_BLOOM_FILTER_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \ingroup ndn
+ * \brief Bloom filter of digests (e.g., hash_value of names or prefixes)
+ *
+ * The digest is spread over 64 bits and the bits of the filter are derived from it by double
+ * hashing, so the digest is calculated only once per operation.  Size of the filter is a power
+ * of two, so bit positions are masked instead of taken modulo.  A filter without bits (e.g.,
+ * not built yet) cannot exclude anything.
+ */
+class BloomFilter
+{
+public:
+  BloomFilter ()
+    : m_nHashes (1)
+  {
+  }
+
+  /**
+   * \brief Allocate at least nBits bits (rounded up to a power of two, at least 64), all cleared
+   * \param nHashes number of bits set per digest
+   */
+  void
+  Resize (uint64_t nBits, uint32_t nHashes)
+  {
+    m_bits.assign (GetRoundedNBits (nBits) / 64, 0);
+    m_nHashes = nHashes;
+  }
+
+  /**
+   * \brief Get number of bits Resize allocates for nBits
+   */
+  static uint64_t
+  GetRoundedNBits (uint64_t nBits)
+  {
+    uint64_t bits = 64;
+    while (bits < nBits)
+      bits <<= 1;
+    return bits;
+  }
+
+  /**
+   * \brief Free all bits
+   */
+  void
+  Release ()
+  {
+    std::vector<uint64_t> ().swap (m_bits);
+  }
+
+  /**
+   * \brief Clear all bits (keeping the size)
+   */
+  void
+  Clear ()
+  {
+    std::fill (m_bits.begin (), m_bits.end (), 0);
+  }
+
+  void
+  Insert (std::size_t digest)
+  {
+    uint64_t mask = GetNBits () - 1;
+    uint64_t h = Mix (digest);
+    uint64_t step = (h >> 32) | 1;
+    for (uint32_t i = 0; i < m_nHashes; i++, h += step)
+      {
+        uint64_t bit = h & mask;
+        m_bits [bit >> 6] |= 1ULL << (bit & 63);
+      }
+  }
+
+  /**
+   * \brief Check if the digest may have been inserted (never false for an inserted digest)
+   */
+  bool
+  MayContain (std::size_t digest) const
+  {
+    if (m_bits.empty ())
+      return true;
+
+    uint64_t mask = GetNBits () - 1;
+    uint64_t h = Mix (digest);
+    uint64_t step = (h >> 32) | 1;
+    for (uint32_t i = 0; i < m_nHashes; i++, h += step)
+      {
+        uint64_t bit = h & mask;
+        if ((m_bits [bit >> 6] & (1ULL << (bit & 63))) == 0)
+          return false;
+      }
+    return true;
+  }
+
+  uint64_t
+  GetNBits () const
+  {
+    return m_bits.size () * 64;
+  }
+
+  uint32_t
+  GetNHashes () const
+  {
+    return m_nHashes;
+  }
+
+  /**
+   * \brief Get memory used by the bits in bytes
+   */
+  std::size_t
+  GetMemoryUsage () const
+  {
+    return m_bits.size () * sizeof (uint64_t);
+  }
+
+  void
+  Swap (BloomFilter &other)
+  {
+    m_bits.swap (other.m_bits);
+    std::swap (m_nHashes, other.m_nHashes);
+  }
+
+private:
+  /**
+   * \brief Finalizer from MurmurHash3, spreads the digest over all 64 bits
+   */
+  static uint64_t
+  Mix (std::size_t digest)
+  {
+    uint64_t h = digest;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+private:
+  std::vector<uint64_t> m_bits;
+  uint32_t m_nHashes;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // _NDN_BLOOM_FILTER_H_